@@ -229,6 +229,8 @@ namespace aslam {
       size_t getMemoryUsage() const;
       /// Returns the number of flops of the linear solver
       double getNumFlops() const;
+      /// Returns the number of flops of all solves, rejected batches included
+      double getTotalNumFlops() const;
       /// Returns the current initial cost for the estimator
       double getInitialCost() const;
       /// Returns the current final cost for the estimator
@@ -308,6 +310,8 @@ namespace aslam {
       size_t _memoryUsage;
       /// Number of flops
       double _numFlops;
+      /// Number of flops accumulated over all solves
+      double _totalNumFlops;
       /// Initial cost
       double _initialCost;
       /// Final cost
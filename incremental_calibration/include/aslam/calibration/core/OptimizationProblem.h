@@ -113,6 +113,8 @@ namespace aslam {
         const;
       /// Inserts an error term into the problem
       void addErrorTerm(const ErrorTermSP& errorTerm);
+      /// Inserts error terms into the problem, none if one is rejected
+      void addErrorTerms(const ErrorTermsSP& errorTerms);
       /// Checks if an error term is in the problem
       bool isErrorTermInProblem(const ErrorTerm* errorTerm) const;
       /// Permutes the error terms
@@ -24,6 +24,7 @@
 #ifndef ASLAM_CALIBRATION_DATA_GRID_H
 #define ASLAM_CALIBRATION_DATA_GRID_H
 
+#include <cstdint>
 #include <vector>
 
 #include <Eigen/Core>
@@ -36,7 +37,14 @@
 namespace aslam {
   namespace calibration {
 
-    /** The class Grid represents an n-dimensional grid.
+    template <typename T, typename C, int M> class MappedGrid;
+    template <typename T, typename C, int M> class SparseGrid;
+
+    /** The class Grid represents an n-dimensional grid. The binary format
+        written by writeBinary() starts with a BinaryHeader, followed by the
+        minimum, the maximum and the resolution, and by the raw cell block at
+        an offset aligned to binaryAlignment bytes. It is stored in native
+        byte order and can be memory-mapped with MappedGrid.
         \brief An n-dimensional grid
       */
     template <typename T, typename C, int M> class Grid :
@@ -63,6 +71,35 @@ namespace aslam {
       typedef Eigen::Matrix<int, M, 1> Index;
       /// Coordinate type
       typedef Eigen::Matrix<T, M, 1> Coordinate;
+      /// Header of the binary format
+      struct BinaryHeader {
+        /// Magic number
+        char magic[8];
+        /// Version of the format
+        uint32_t version;
+        /// Byte order mark
+        uint32_t byteOrder;
+        /// Dimension of the grid
+        uint32_t dimension;
+        /// Size of a coordinate component in bytes
+        uint32_t coordinateSize;
+        /// Size of a cell in bytes
+        uint32_t cellSize;
+        /// Reserved for future use
+        uint32_t reserved;
+        /// Total number of cells
+        uint64_t numCellsTot;
+      };
+      /** @}
+        */
+
+      /** \name Binary format
+        @{
+        */
+      /// Version of the binary format
+      static const uint32_t binaryVersion = 1;
+      /// Alignment of the cell block in bytes
+      static const size_t binaryAlignment = 64;
       /** @}
         */
 
@@ -148,8 +185,18 @@ namespace aslam {
         */
       /// Computes linear index
       size_t computeLinearIndex(const Index& idx) const;
+      /// Computes the index from a linear index
+      Index computeIndex(size_t linIdx) const;
+      /** Computes the linear index of the cell containing a point without
+          throwing, returns false if the point is out of range
+        */
+      bool getLinearIndex(const Coordinate& point, size_t& linIdx) const;
       /// Increment an index
       Index& incrementIndex(Index& idx) const;
+      /// Applies a function to the linear index and the value of each cell
+      template <typename F> void forEachCell(F function) const;
+      /// Applies a function to the linear index and the value of each cell
+      template <typename F> void forEachCell(F function);
       /// Reset the grid
       void reset();
       /** @}
@@ -162,10 +209,30 @@ namespace aslam {
       virtual void writeBinary(std::ostream& stream) const;
       /// Reads the grid from a binary format
       virtual void readBinary(std::istream& stream);
+      /// Returns the header of the binary format for this grid
+      BinaryHeader getBinaryHeader() const;
+      /// Checks that a binary header matches the grid types
+      static void checkBinaryHeader(const BinaryHeader& header);
+      /// Returns the offset of the cell block for a dimension
+      static size_t getBinaryCellOffset(size_t dimension);
       /** @}
         */
 
     protected:
+      /// \cond
+      friend class MappedGrid<T, C, M>;
+      friend class SparseGrid<T, C, M>;
+      /// \endcond
+
+      /** \name Protected constructors
+        @{
+        */
+      /// Constructs grid with parameters, optionally without the cells
+      Grid(const Coordinate& minimum, const Coordinate& maximum,
+        const Coordinate& resolution, bool allocate);
+      /** @}
+        */
+
       /** \name Stream methods
         @{
         */
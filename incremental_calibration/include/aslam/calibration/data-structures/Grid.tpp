@@ -16,8 +16,16 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
  ******************************************************************************/
 
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
 #include "aslam/calibration/exceptions/OutOfBoundException.h"
 #include "aslam/calibration/exceptions/BadArgumentException.h"
+#include "aslam/calibration/exceptions/InvalidOperationException.h"
 
 namespace aslam {
   namespace calibration {
@@ -29,6 +37,12 @@ namespace aslam {
     template <typename T, typename C, int M>
     Grid<T, C, M>::Grid(const Coordinate& minimum, const Coordinate& maximum,
         const Coordinate& resolution) :
+        Grid(minimum, maximum, resolution, true) {
+    }
+
+    template <typename T, typename C, int M>
+    Grid<T, C, M>::Grid(const Coordinate& minimum, const Coordinate& maximum,
+        const Coordinate& resolution, bool allocate) :
         mMinimum(minimum),
         mMaximum(maximum),
         mResolution(resolution) {
@@ -55,7 +69,8 @@ namespace aslam {
       for (size_t i = 0; i < static_cast<size_t>(minimum.size()); ++i)
         for (size_t j = i + 1; j < static_cast<size_t>(minimum.size()); ++j)
           mLinProd(i) *= mNumCells(j);
-      mCells.resize(mNumCellsTot);
+      if (allocate)
+        mCells.resize(mNumCellsTot);
     }
 
     template <typename T, typename C, int M>
@@ -93,6 +108,38 @@ namespace aslam {
 
     template <typename T, typename C, int M>
     void Grid<T, C, M>::read(std::istream& stream) {
+      // mirrors write(), each field is a line starting with a label
+      auto readField = [&stream]() {
+        std::string line;
+        std::getline(stream, line);
+        std::istringstream lineStream(line.substr(line.find(':') + 1));
+        std::vector<T> values;
+        T value;
+        while (lineStream >> value)
+          values.push_back(value);
+        if (values.empty() || (M != Eigen::Dynamic &&
+            static_cast<int>(values.size()) != M))
+          throw InvalidOperationException("Grid<T, C, M>::read(): "
+            "malformed header", __FILE__, __LINE__);
+        return Coordinate(Eigen::Map<const Coordinate>(values.data(),
+          values.size()));
+      };
+      const Coordinate minimum = readField();
+      const Coordinate maximum = readField();
+      const Coordinate resolution = readField();
+      if (maximum.size() != minimum.size() ||
+          resolution.size() != minimum.size())
+        throw InvalidOperationException("Grid<T, C, M>::read(): "
+          "malformed header", __FILE__, __LINE__);
+      for (size_t i = 0; i < 3; ++i)
+        stream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+      Grid grid(minimum, maximum, resolution);
+      for (auto it = grid.getCellBegin(); it != grid.getCellEnd(); ++it)
+        stream >> *it;
+      if (!stream)
+        throw InvalidOperationException("Grid<T, C, M>::read(): "
+          "truncated cells", __FILE__, __LINE__);
+      *this = grid;
     }
 
     template <typename T, typename C, int M>
@@ -109,18 +156,108 @@ namespace aslam {
 
     template <typename T, typename C, int M>
     void Grid<T, C, M>::read(std::ifstream& stream) {
+      readBinary(stream);
     }
 
     template <typename T, typename C, int M>
     void Grid<T, C, M>::write(std::ofstream& stream) const {
+      writeBinary(stream);
     }
 
     template <typename T, typename C, int M>
     void Grid<T, C, M>::writeBinary(std::ostream& stream) const {
+      static_assert(std::is_pod<T>::value && std::is_pod<C>::value,
+        "binary format requires plain old data coordinates and cells");
+      const BinaryHeader header = getBinaryHeader();
+      stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      const size_t coordinateBytes = sizeof(T) * mMinimum.size();
+      stream.write(reinterpret_cast<const char*>(mMinimum.data()),
+        coordinateBytes);
+      stream.write(reinterpret_cast<const char*>(mMaximum.data()),
+        coordinateBytes);
+      stream.write(reinterpret_cast<const char*>(mResolution.data()),
+        coordinateBytes);
+      const size_t padding = getBinaryCellOffset(mMinimum.size()) -
+        sizeof(header) - 3 * coordinateBytes;
+      const char zeros[binaryAlignment] = {};
+      stream.write(zeros, padding);
+      stream.write(reinterpret_cast<const char*>(mCells.data()),
+        sizeof(C) * mNumCellsTot);
     }
 
     template <typename T, typename C, int M>
     void Grid<T, C, M>::readBinary(std::istream& stream) {
+      static_assert(std::is_pod<T>::value && std::is_pod<C>::value,
+        "binary format requires plain old data coordinates and cells");
+      BinaryHeader header;
+      if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw InvalidOperationException("Grid<T, C, M>::readBinary(): "
+          "truncated header", __FILE__, __LINE__);
+      checkBinaryHeader(header);
+      Coordinate minimum(header.dimension), maximum(header.dimension),
+        resolution(header.dimension);
+      const size_t coordinateBytes = sizeof(T) * header.dimension;
+      stream.read(reinterpret_cast<char*>(minimum.data()), coordinateBytes);
+      stream.read(reinterpret_cast<char*>(maximum.data()), coordinateBytes);
+      stream.read(reinterpret_cast<char*>(resolution.data()),
+        coordinateBytes);
+      stream.ignore(getBinaryCellOffset(header.dimension) - sizeof(header) -
+        3 * coordinateBytes);
+      if (!stream)
+        throw InvalidOperationException("Grid<T, C, M>::readBinary(): "
+          "truncated header", __FILE__, __LINE__);
+      Grid grid(minimum, maximum, resolution);
+      if (grid.mNumCellsTot != header.numCellsTot)
+        throw InvalidOperationException("Grid<T, C, M>::readBinary(): "
+          "inconsistent number of cells", __FILE__, __LINE__);
+      if (!stream.read(reinterpret_cast<char*>(grid.mCells.data()),
+          sizeof(C) * grid.mNumCellsTot))
+        throw InvalidOperationException("Grid<T, C, M>::readBinary(): "
+          "truncated cells", __FILE__, __LINE__);
+      *this = grid;
+    }
+
+    template <typename T, typename C, int M>
+    typename Grid<T, C, M>::BinaryHeader Grid<T, C, M>::getBinaryHeader()
+        const {
+      BinaryHeader header;
+      std::memcpy(header.magic, "ASLMGRID", sizeof(header.magic));
+      header.version = binaryVersion;
+      header.byteOrder = 0x01020304;
+      header.dimension = mMinimum.size();
+      header.coordinateSize = sizeof(T);
+      header.cellSize = sizeof(C);
+      header.reserved = 0;
+      header.numCellsTot = mNumCellsTot;
+      return header;
+    }
+
+    template <typename T, typename C, int M>
+    void Grid<T, C, M>::checkBinaryHeader(const BinaryHeader& header) {
+      if (std::memcmp(header.magic, "ASLMGRID", sizeof(header.magic)))
+        throw InvalidOperationException("Grid<T, C, M>::checkBinaryHeader(): "
+          "not a binary grid", __FILE__, __LINE__);
+      if (header.version != binaryVersion)
+        throw InvalidOperationException("Grid<T, C, M>::checkBinaryHeader(): "
+          "unsupported version", __FILE__, __LINE__);
+      if (header.byteOrder != 0x01020304)
+        throw InvalidOperationException("Grid<T, C, M>::checkBinaryHeader(): "
+          "foreign byte order", __FILE__, __LINE__);
+      if ((M != Eigen::Dynamic && static_cast<int>(header.dimension) != M) ||
+          header.dimension == 0)
+        throw InvalidOperationException("Grid<T, C, M>::checkBinaryHeader(): "
+          "wrong dimension", __FILE__, __LINE__);
+      if (header.coordinateSize != sizeof(T) || header.cellSize != sizeof(C))
+        throw InvalidOperationException("Grid<T, C, M>::checkBinaryHeader(): "
+          "wrong coordinate or cell type", __FILE__, __LINE__);
+    }
+
+    template <typename T, typename C, int M>
+    size_t Grid<T, C, M>::getBinaryCellOffset(size_t dimension) {
+      const size_t headerBytes = sizeof(BinaryHeader) + 3 * sizeof(T) *
+        dimension;
+      return (headerBytes + binaryAlignment - 1) / binaryAlignment *
+        binaryAlignment;
     }
 
 /******************************************************************************/
@@ -269,6 +406,45 @@ namespace aslam {
       return linIdx;
     }
 
+    template <typename T, typename C, int M>
+    typename Grid<T, C, M>::Index Grid<T, C, M>::computeIndex(size_t linIdx)
+        const {
+      Index idx(mNumCells.size());
+      for (size_t i = 0; i < static_cast<size_t>(idx.size()); ++i)
+        idx(i) = (linIdx / mLinProd(i)) % mNumCells(i);
+      return idx;
+    }
+
+    template <typename T, typename C, int M>
+    bool Grid<T, C, M>::getLinearIndex(const Coordinate& point, size_t& linIdx)
+        const {
+      linIdx = 0;
+      for (size_t i = 0; i < static_cast<size_t>(point.size()); ++i) {
+        if (!(point(i) >= mMinimum(i) && point(i) <= mMaximum(i)))
+          return false;
+        if (point(i) == mMaximum(i))
+          linIdx += mLinProd(i) * (mNumCells(i) - 1);
+        else
+          linIdx += mLinProd(i) * static_cast<int>((point(i) - mMinimum(i)) /
+            mResolution(i));
+      }
+      return true;
+    }
+
+    template <typename T, typename C, int M>
+    template <typename F>
+    void Grid<T, C, M>::forEachCell(F function) const {
+      for (size_t i = 0; i < mNumCellsTot; ++i)
+        function(i, mCells[i]);
+    }
+
+    template <typename T, typename C, int M>
+    template <typename F>
+    void Grid<T, C, M>::forEachCell(F function) {
+      for (size_t i = 0; i < mNumCellsTot; ++i)
+        function(i, mCells[i]);
+    }
+
     template <typename T, typename C, int M>
     void Grid<T, C, M>::reset() {
       for (auto it = getCellBegin(); it != getCellEnd(); ++it)
@@ -0,0 +1,167 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file MappedGrid.h
+    \brief This file defines the MappedGrid class, which represents a
+           read-only memory-mapped n-dimensional grid.
+  */
+
+#ifndef ASLAM_CALIBRATION_DATA_MAPPED_GRID_H
+#define ASLAM_CALIBRATION_DATA_MAPPED_GRID_H
+
+#include <string>
+
+#include "aslam/calibration/data-structures/Grid.h"
+
+namespace aslam {
+  namespace calibration {
+
+    /** The class MappedGrid represents a read-only n-dimensional grid whose
+        cells are memory-mapped from a file written by Grid::writeBinary().
+        The cells are shared with other processes mapping the same file and
+        are never parsed or copied.
+        \brief A read-only memory-mapped n-dimensional grid
+      */
+    template <typename T, typename C, int M> class MappedGrid {
+    public:
+      /// \cond
+      // Required by Eigen for fixed-size matrices members
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+      /// \endcond
+
+      /** \name Types definitions
+        @{
+        */
+      /// Self type
+      typedef MappedGrid<T, C, M> Self;
+      /// Grid type
+      typedef Grid<T, C, M> GridType;
+      /// Constant iterator type
+      typedef const C* ConstCellIterator;
+      /// Index type
+      typedef typename GridType::Index Index;
+      /// Coordinate type
+      typedef typename GridType::Coordinate Coordinate;
+      /** @}
+        */
+
+      /** \name Constructors/destructor
+        @{
+        */
+      /// Maps the grid stored in a binary file
+      MappedGrid(const std::string& filename);
+      /// Copy constructor
+      MappedGrid(const Self& other) = delete;
+      /// Copy assignment operator
+      MappedGrid& operator = (const Self& other) = delete;
+      /// Move constructor
+      MappedGrid(Self&& other) = delete;
+      /// Move assignment operator
+      MappedGrid& operator = (Self&& other) = delete;
+      /// Destructor
+      virtual ~MappedGrid();
+      /** @}
+        */
+
+      /** \name Accessors
+          @{
+        */
+      /// Returns iterator at start of the cells
+      ConstCellIterator getCellBegin() const;
+      /// Returns iterator at end of the cells
+      ConstCellIterator getCellEnd() const;
+      /// Returns the mapped cells
+      const C* getCells() const;
+      /// Returns the cell at index
+      const C& getCell(const Index& idx) const;
+      /// Returns a cell using [index] operator
+      const C& operator [] (const Index& idx) const;
+      /// Returns the index of a cell using coordinates
+      Index getIndex(const Coordinate& point) const;
+      /// Returns a cell using (coordinate) operator
+      const C& operator () (const Coordinate& point) const;
+      /// Returns the coordinates of a cell using index
+      Coordinate getCoordinates(const Index& idx) const;
+      /// Check if the grid contains the point
+      bool isInRange(const Coordinate& point) const;
+      /// Check if an index is valid
+      bool isValidIndex(const Index& idx) const;
+      /// Returns the number of cells in each dimension
+      const Index& getNumCells() const;
+      /// Returns the total number of cells
+      size_t getNumCellsTot() const;
+      /// Returns the minimum of the grid
+      const Coordinate& getMinimum() const;
+      /// Returns the maximum of the grid
+      const Coordinate& getMaximum() const;
+      /// Returns the resolution of the grid
+      const Coordinate& getResolution() const;
+      /** @}
+        */
+
+      /** \name Methods
+          @{
+        */
+      /// Computes linear index
+      size_t computeLinearIndex(const Index& idx) const;
+      /// Computes the index from a linear index
+      Index computeIndex(size_t linIdx) const;
+      /** Computes the linear index of the cell containing a point without
+          throwing, returns false if the point is out of range
+        */
+      bool getLinearIndex(const Coordinate& point, size_t& linIdx) const;
+      /// Applies a function to the linear index and the value of each cell
+      template <typename F> void forEachCell(F function) const;
+      /// Returns a grid holding a copy of the cells
+      GridType getGrid() const;
+      /** @}
+        */
+
+    protected:
+      /** \name Protected members
+          @{
+        */
+      /// Start of the mapping
+      void* mMapping;
+      /// Size of the mapping
+      size_t mMappingSize;
+      /// Geometry of the grid, without cells
+      GridType mGeometry;
+      /// Mapped cells
+      const C* mCells;
+      /** @}
+        */
+
+    private:
+      /** \name Private methods
+          @{
+        */
+      /// Maps a file and returns its geometry
+      static GridType map(const std::string& filename, void*& mapping,
+        size_t& mappingSize);
+      /** @}
+        */
+
+    };
+
+  }
+}
+
+#include "aslam/calibration/data-structures/MappedGrid.tpp"
+
+#endif // ASLAM_CALIBRATION_DATA_MAPPED_GRID_H
@@ -0,0 +1,236 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "aslam/calibration/exceptions/BadArgumentException.h"
+#include "aslam/calibration/exceptions/InvalidOperationException.h"
+#include "aslam/calibration/exceptions/OutOfBoundException.h"
+
+namespace aslam {
+  namespace calibration {
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+    template <typename T, typename C, int M>
+    MappedGrid<T, C, M>::MappedGrid(const std::string& filename) :
+        mMapping(0),
+        mMappingSize(0),
+        mGeometry(map(filename, mMapping, mMappingSize)),
+        mCells(reinterpret_cast<const C*>(static_cast<const char*>(mMapping) +
+          GridType::getBinaryCellOffset(mGeometry.getMinimum().size()))) {
+    }
+
+    template <typename T, typename C, int M>
+    MappedGrid<T, C, M>::~MappedGrid() {
+      munmap(mMapping, mMappingSize);
+    }
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+    template <typename T, typename C, int M>
+    typename MappedGrid<T, C, M>::ConstCellIterator
+        MappedGrid<T, C, M>::getCellBegin() const {
+      return mCells;
+    }
+
+    template <typename T, typename C, int M>
+    typename MappedGrid<T, C, M>::ConstCellIterator
+        MappedGrid<T, C, M>::getCellEnd() const {
+      return mCells + mGeometry.getNumCellsTot();
+    }
+
+    template <typename T, typename C, int M>
+    const C* MappedGrid<T, C, M>::getCells() const {
+      return mCells;
+    }
+
+    template <typename T, typename C, int M>
+    const C& MappedGrid<T, C, M>::getCell(const Index& idx) const {
+      if (!isValidIndex(idx))
+        throw OutOfBoundException<Index>(idx,
+          "MappedGrid<T, C, M>::getCell(): index out of range",
+          __FILE__, __LINE__);
+      return mCells[computeLinearIndex(idx)];
+    }
+
+    template <typename T, typename C, int M>
+    const C& MappedGrid<T, C, M>::operator [] (const Index& idx) const {
+      return getCell(idx);
+    }
+
+    template <typename T, typename C, int M>
+    typename MappedGrid<T, C, M>::Index MappedGrid<T, C, M>::getIndex(
+        const Coordinate& point) const {
+      return mGeometry.getIndex(point);
+    }
+
+    template <typename T, typename C, int M>
+    const C& MappedGrid<T, C, M>::operator () (const Coordinate& point) const {
+      return operator[](getIndex(point));
+    }
+
+    template <typename T, typename C, int M>
+    typename MappedGrid<T, C, M>::Coordinate
+        MappedGrid<T, C, M>::getCoordinates(const Index& idx) const {
+      return mGeometry.getCoordinates(idx);
+    }
+
+    template <typename T, typename C, int M>
+    bool MappedGrid<T, C, M>::isInRange(const Coordinate& point) const {
+      return mGeometry.isInRange(point);
+    }
+
+    template <typename T, typename C, int M>
+    bool MappedGrid<T, C, M>::isValidIndex(const Index& idx) const {
+      return mGeometry.isValidIndex(idx);
+    }
+
+    template <typename T, typename C, int M>
+    const typename MappedGrid<T, C, M>::Index&
+        MappedGrid<T, C, M>::getNumCells() const {
+      return mGeometry.getNumCells();
+    }
+
+    template <typename T, typename C, int M>
+    size_t MappedGrid<T, C, M>::getNumCellsTot() const {
+      return mGeometry.getNumCellsTot();
+    }
+
+    template <typename T, typename C, int M>
+    const typename MappedGrid<T, C, M>::Coordinate&
+        MappedGrid<T, C, M>::getMinimum() const {
+      return mGeometry.getMinimum();
+    }
+
+    template <typename T, typename C, int M>
+    const typename MappedGrid<T, C, M>::Coordinate&
+        MappedGrid<T, C, M>::getMaximum() const {
+      return mGeometry.getMaximum();
+    }
+
+    template <typename T, typename C, int M>
+    const typename MappedGrid<T, C, M>::Coordinate&
+        MappedGrid<T, C, M>::getResolution() const {
+      return mGeometry.getResolution();
+    }
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    template <typename T, typename C, int M>
+    size_t MappedGrid<T, C, M>::computeLinearIndex(const Index& idx) const {
+      return mGeometry.computeLinearIndex(idx);
+    }
+
+    template <typename T, typename C, int M>
+    typename MappedGrid<T, C, M>::Index MappedGrid<T, C, M>::computeIndex(
+        size_t linIdx) const {
+      return mGeometry.computeIndex(linIdx);
+    }
+
+    template <typename T, typename C, int M>
+    bool MappedGrid<T, C, M>::getLinearIndex(const Coordinate& point,
+        size_t& linIdx) const {
+      return mGeometry.getLinearIndex(point, linIdx);
+    }
+
+    template <typename T, typename C, int M>
+    template <typename F>
+    void MappedGrid<T, C, M>::forEachCell(F function) const {
+      for (size_t i = 0; i < mGeometry.getNumCellsTot(); ++i)
+        function(i, mCells[i]);
+    }
+
+    template <typename T, typename C, int M>
+    typename MappedGrid<T, C, M>::GridType MappedGrid<T, C, M>::getGrid()
+        const {
+      GridType grid(getMinimum(), getMaximum(), getResolution());
+      std::copy(getCellBegin(), getCellEnd(), grid.getCellBegin());
+      return grid;
+    }
+
+    template <typename T, typename C, int M>
+    typename MappedGrid<T, C, M>::GridType MappedGrid<T, C, M>::map(
+        const std::string& filename, void*& mapping, size_t& mappingSize) {
+      const int file = open(filename.c_str(), O_RDONLY);
+      if (file < 0)
+        throw BadArgumentException<std::string>(filename,
+          "MappedGrid<T, C, M>::map(): cannot open file", __FILE__, __LINE__);
+      struct stat status;
+      if (fstat(file, &status) < 0 || static_cast<size_t>(status.st_size) <
+          sizeof(typename GridType::BinaryHeader)) {
+        close(file);
+        throw BadArgumentException<std::string>(filename,
+          "MappedGrid<T, C, M>::map(): truncated header", __FILE__, __LINE__);
+      }
+      mappingSize = status.st_size;
+      mapping = mmap(0, mappingSize, PROT_READ, MAP_SHARED, file, 0);
+      close(file);
+      if (mapping == MAP_FAILED) {
+        mapping = 0;
+        throw BadArgumentException<std::string>(filename,
+          "MappedGrid<T, C, M>::map(): cannot map file", __FILE__, __LINE__);
+      }
+      try {
+        const char* data = static_cast<const char*>(mapping);
+        typename GridType::BinaryHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        GridType::checkBinaryHeader(header);
+        const size_t cellOffset =
+          GridType::getBinaryCellOffset(header.dimension);
+        if (mappingSize < cellOffset)
+          throw InvalidOperationException("MappedGrid<T, C, M>::map(): "
+            "truncated header", __FILE__, __LINE__);
+        Coordinate minimum(header.dimension), maximum(header.dimension),
+          resolution(header.dimension);
+        const size_t coordinateBytes = sizeof(T) * header.dimension;
+        data += sizeof(header);
+        std::memcpy(minimum.data(), data, coordinateBytes);
+        std::memcpy(maximum.data(), data + coordinateBytes, coordinateBytes);
+        std::memcpy(resolution.data(), data + 2 * coordinateBytes,
+          coordinateBytes);
+        GridType geometry(minimum, maximum, resolution, false);
+        if (geometry.getNumCellsTot() != header.numCellsTot)
+          throw InvalidOperationException("MappedGrid<T, C, M>::map(): "
+            "inconsistent number of cells", __FILE__, __LINE__);
+        if (mappingSize < cellOffset + sizeof(C) * header.numCellsTot)
+          throw InvalidOperationException("MappedGrid<T, C, M>::map(): "
+            "truncated cells", __FILE__, __LINE__);
+        return geometry;
+      }
+      catch (...) {
+        munmap(mapping, mappingSize);
+        mapping = 0;
+        throw;
+      }
+    }
+
+  }
+}
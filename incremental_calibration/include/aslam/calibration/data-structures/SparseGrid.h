@@ -0,0 +1,172 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file SparseGrid.h
+    \brief This file defines the SparseGrid class, which represents a sparse
+           n-dimensional grid.
+  */
+
+#ifndef ASLAM_CALIBRATION_DATA_SPARSE_GRID_H
+#define ASLAM_CALIBRATION_DATA_SPARSE_GRID_H
+
+#include <unordered_map>
+
+#include "aslam/calibration/data-structures/Grid.h"
+
+namespace aslam {
+  namespace calibration {
+
+    /** The class SparseGrid represents a sparse n-dimensional grid with the
+        coordinate and index API of Grid. Only the occupied cells are stored,
+        in a hash map from linear index to cell, such that memory scales with
+        the number of occupied cells instead of the total number of cells.
+        Cell iterators visit the occupied cells as (linear index, cell) pairs
+        in no particular order.
+        \brief A sparse n-dimensional grid
+      */
+    template <typename T, typename C, int M> class SparseGrid {
+    public:
+      /// \cond
+      // Required by Eigen for fixed-size matrices members
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+      /// \endcond
+
+      /** \name Types definitions
+        @{
+        */
+      /// Grid type holding the geometry
+      typedef Grid<T, C, M> GridType;
+      /// Container type
+      typedef std::unordered_map<size_t, C> Container;
+      /// Constant iterator type
+      typedef typename Container::const_iterator ConstCellIterator;
+      /// Iterator type
+      typedef typename Container::iterator CellIterator;
+      /// Index type
+      typedef typename GridType::Index Index;
+      /// Coordinate type
+      typedef typename GridType::Coordinate Coordinate;
+      /** @}
+        */
+
+      /** \name Constructors/destructor
+        @{
+        */
+      /// Constructs grid with parameters
+      SparseGrid(const Coordinate& minimum, const Coordinate& maximum,
+        const Coordinate& resolution);
+      /// Copy constructor
+      SparseGrid(const SparseGrid& other);
+      /// Assignment operator
+      SparseGrid& operator = (const SparseGrid& other);
+      /// Destructor
+      virtual ~SparseGrid();
+      /** @}
+        */
+
+      /** \name Accessors
+          @{
+        */
+      /// Returns iterator at start of the occupied cells
+      ConstCellIterator getCellBegin() const;
+      /// Returns iterator at start of the occupied cells
+      CellIterator getCellBegin();
+      /// Returns iterator at end of the occupied cells
+      ConstCellIterator getCellEnd() const;
+      /// Returns iterator at end of the occupied cells
+      CellIterator getCellEnd();
+      /// Returns the container
+      const Container& getCells() const;
+      /// Returns the cell at index, an empty cell if it is not occupied
+      const C& getCell(const Index& idx) const;
+      /// Returns the cell at index, occupying it if needed
+      C& getCell(const Index& idx);
+      /// Returns a cell using [index] operator
+      const C& operator [] (const Index& idx) const;
+      /// Returns a cell using [index] operator
+      C& operator [] (const Index& idx);
+      /// Returns the index of a cell using coordinates
+      Index getIndex(const Coordinate& point) const;
+      /// Returns a cell using (coordinate) operator
+      const C& operator () (const Coordinate& point) const;
+      /// Returns a cell using (coordinate) operator
+      C& operator () (const Coordinate& point);
+      /// Returns the coordinates of a cell using index
+      Coordinate getCoordinates(const Index& idx) const;
+      /// Check if the grid contains the point
+      bool isInRange(const Coordinate& point) const;
+      /// Check if an index is valid
+      bool isValidIndex(const Index& idx) const;
+      /// Check if the cell at index is occupied
+      bool isOccupied(const Index& idx) const;
+      /// Returns the number of cells in each dimension
+      const Index& getNumCells() const;
+      /// Returns the total number of cells
+      size_t getNumCellsTot() const;
+      /// Returns the number of occupied cells
+      size_t getNumOccupiedCells() const;
+      /// Returns the minimum of the grid
+      const Coordinate& getMinimum() const;
+      /// Returns the maximum of the grid
+      const Coordinate& getMaximum() const;
+      /// Returns the resolution of the grid
+      const Coordinate& getResolution() const;
+      /** @}
+        */
+
+      /** \name Methods
+          @{
+        */
+      /// Computes linear index
+      size_t computeLinearIndex(const Index& idx) const;
+      /// Computes the index from a linear index
+      Index computeIndex(size_t linIdx) const;
+      /** Computes the linear index of the cell containing a point without
+          throwing, returns false if the point is out of range
+        */
+      bool getLinearIndex(const Coordinate& point, size_t& linIdx) const;
+      /// Applies a function to the linear index and the value of each cell
+      template <typename F> void forEachCell(F function) const;
+      /// Applies a function to the linear index and the value of each cell
+      template <typename F> void forEachCell(F function);
+      /// Reset the grid
+      void reset();
+      /** @}
+        */
+
+    protected:
+      /** \name Protected members
+          @{
+        */
+      /// Geometry of the grid, without cells
+      GridType mGeometry;
+      /// Occupied cells
+      Container mCells;
+      /// Value of the cells that are not occupied
+      C mEmptyCell;
+      /** @}
+        */
+
+    };
+
+  }
+}
+
+#include "aslam/calibration/data-structures/SparseGrid.tpp"
+
+#endif // ASLAM_CALIBRATION_DATA_SPARSE_GRID_H
@@ -0,0 +1,231 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "aslam/calibration/exceptions/OutOfBoundException.h"
+
+namespace aslam {
+  namespace calibration {
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+    template <typename T, typename C, int M>
+    SparseGrid<T, C, M>::SparseGrid(const Coordinate& minimum, const
+        Coordinate& maximum, const Coordinate& resolution) :
+        mGeometry(minimum, maximum, resolution, false),
+        mEmptyCell() {
+    }
+
+    template <typename T, typename C, int M>
+    SparseGrid<T, C, M>::SparseGrid(const SparseGrid& other) :
+        mGeometry(other.mGeometry),
+        mCells(other.mCells),
+        mEmptyCell() {
+    }
+
+    template <typename T, typename C, int M>
+    SparseGrid<T, C, M>& SparseGrid<T, C, M>::operator = (const SparseGrid&
+        other) {
+      if (this != &other) {
+        mGeometry = other.mGeometry;
+        mCells = other.mCells;
+      }
+      return *this;
+    }
+
+    template <typename T, typename C, int M>
+    SparseGrid<T, C, M>::~SparseGrid() {
+    }
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+    template <typename T, typename C, int M>
+    typename SparseGrid<T, C, M>::ConstCellIterator
+        SparseGrid<T, C, M>::getCellBegin() const {
+      return mCells.begin();
+    }
+
+    template <typename T, typename C, int M>
+    typename SparseGrid<T, C, M>::CellIterator
+        SparseGrid<T, C, M>::getCellBegin() {
+      return mCells.begin();
+    }
+
+    template <typename T, typename C, int M>
+    typename SparseGrid<T, C, M>::ConstCellIterator
+        SparseGrid<T, C, M>::getCellEnd() const {
+      return mCells.end();
+    }
+
+    template <typename T, typename C, int M>
+    typename SparseGrid<T, C, M>::CellIterator
+        SparseGrid<T, C, M>::getCellEnd() {
+      return mCells.end();
+    }
+
+    template <typename T, typename C, int M>
+    const typename SparseGrid<T, C, M>::Container&
+        SparseGrid<T, C, M>::getCells() const {
+      return mCells;
+    }
+
+    template <typename T, typename C, int M>
+    const C& SparseGrid<T, C, M>::getCell(const Index& idx) const {
+      if (!isValidIndex(idx))
+        throw OutOfBoundException<Index>(idx,
+          "SparseGrid<T, C, M>::getCell(): index out of range",
+          __FILE__, __LINE__);
+      const auto it = mCells.find(computeLinearIndex(idx));
+      return it != mCells.end() ? it->second : mEmptyCell;
+    }
+
+    template <typename T, typename C, int M>
+    C& SparseGrid<T, C, M>::getCell(const Index& idx) {
+      if (!isValidIndex(idx))
+        throw OutOfBoundException<Index>(idx,
+          "SparseGrid<T, C, M>::getCell(): index out of range",
+          __FILE__, __LINE__);
+      return mCells[computeLinearIndex(idx)];
+    }
+
+    template <typename T, typename C, int M>
+    const C& SparseGrid<T, C, M>::operator [] (const Index& idx) const {
+      return getCell(idx);
+    }
+
+    template <typename T, typename C, int M>
+    C& SparseGrid<T, C, M>::operator [] (const Index& idx) {
+      return getCell(idx);
+    }
+
+    template <typename T, typename C, int M>
+    typename SparseGrid<T, C, M>::Index SparseGrid<T, C, M>::getIndex(
+        const Coordinate& point) const {
+      return mGeometry.getIndex(point);
+    }
+
+    template <typename T, typename C, int M>
+    const C& SparseGrid<T, C, M>::operator () (const Coordinate& point) const {
+      return operator[](getIndex(point));
+    }
+
+    template <typename T, typename C, int M>
+    C& SparseGrid<T, C, M>::operator () (const Coordinate& point) {
+      return operator[](getIndex(point));
+    }
+
+    template <typename T, typename C, int M>
+    typename SparseGrid<T, C, M>::Coordinate
+        SparseGrid<T, C, M>::getCoordinates(const Index& idx) const {
+      return mGeometry.getCoordinates(idx);
+    }
+
+    template <typename T, typename C, int M>
+    bool SparseGrid<T, C, M>::isInRange(const Coordinate& point) const {
+      return mGeometry.isInRange(point);
+    }
+
+    template <typename T, typename C, int M>
+    bool SparseGrid<T, C, M>::isValidIndex(const Index& idx) const {
+      return mGeometry.isValidIndex(idx);
+    }
+
+    template <typename T, typename C, int M>
+    bool SparseGrid<T, C, M>::isOccupied(const Index& idx) const {
+      return isValidIndex(idx) && mCells.count(computeLinearIndex(idx));
+    }
+
+    template <typename T, typename C, int M>
+    const typename SparseGrid<T, C, M>::Index&
+        SparseGrid<T, C, M>::getNumCells() const {
+      return mGeometry.getNumCells();
+    }
+
+    template <typename T, typename C, int M>
+    size_t SparseGrid<T, C, M>::getNumCellsTot() const {
+      return mGeometry.getNumCellsTot();
+    }
+
+    template <typename T, typename C, int M>
+    size_t SparseGrid<T, C, M>::getNumOccupiedCells() const {
+      return mCells.size();
+    }
+
+    template <typename T, typename C, int M>
+    const typename SparseGrid<T, C, M>::Coordinate&
+        SparseGrid<T, C, M>::getMinimum() const {
+      return mGeometry.getMinimum();
+    }
+
+    template <typename T, typename C, int M>
+    const typename SparseGrid<T, C, M>::Coordinate&
+        SparseGrid<T, C, M>::getMaximum() const {
+      return mGeometry.getMaximum();
+    }
+
+    template <typename T, typename C, int M>
+    const typename SparseGrid<T, C, M>::Coordinate&
+        SparseGrid<T, C, M>::getResolution() const {
+      return mGeometry.getResolution();
+    }
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    template <typename T, typename C, int M>
+    size_t SparseGrid<T, C, M>::computeLinearIndex(const Index& idx) const {
+      return mGeometry.computeLinearIndex(idx);
+    }
+
+    template <typename T, typename C, int M>
+    typename SparseGrid<T, C, M>::Index SparseGrid<T, C, M>::computeIndex(
+        size_t linIdx) const {
+      return mGeometry.computeIndex(linIdx);
+    }
+
+    template <typename T, typename C, int M>
+    bool SparseGrid<T, C, M>::getLinearIndex(const Coordinate& point,
+        size_t& linIdx) const {
+      return mGeometry.getLinearIndex(point, linIdx);
+    }
+
+    template <typename T, typename C, int M>
+    template <typename F>
+    void SparseGrid<T, C, M>::forEachCell(F function) const {
+      for (auto it = mCells.cbegin(); it != mCells.cend(); ++it)
+        function(it->first, it->second);
+    }
+
+    template <typename T, typename C, int M>
+    template <typename F>
+    void SparseGrid<T, C, M>::forEachCell(F function) {
+      for (auto it = mCells.begin(); it != mCells.end(); ++it)
+        function(it->first, it->second);
+    }
+
+    template <typename T, typename C, int M>
+    void SparseGrid<T, C, M>::reset() {
+      mCells.clear();
+    }
+
+  }
+}
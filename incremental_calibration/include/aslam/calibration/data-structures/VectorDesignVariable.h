@@ -24,6 +24,8 @@
 #ifndef ASLAM_CALIBRATION_DATA_VECTOR_DESIGN_VARIABLE_H
 #define ASLAM_CALIBRATION_DATA_VECTOR_DESIGN_VARIABLE_H
 
+#include <cstddef>
+
 #include <Eigen/Core>
 
 #include <aslam/backend/DesignVariable.hpp>
@@ -34,7 +36,9 @@ namespace aslam {
   namespace calibration {
 
     /** The class VectorDesignVariable implements a vector-valued design
-        variable.
+        variable. Each change of the value gets a new version, unique among
+        the design variables of the same size, such that error terms can
+        cache quantities derived from the value.
         \brief Vector-valued design variable
       */
     template <int M>
@@ -79,6 +83,8 @@ namespace aslam {
       const Container& getValue() const;
       /// Set the value of the design variable
       void setValue(const Container& value);
+      /// Returns the version of the value
+      size_t getVersion() const;
       /** @}
         */
 
@@ -96,6 +102,8 @@ namespace aslam {
       virtual void getParametersImplementation(Eigen::MatrixXd& value) const;
       /// Sets the content of the design variable
       virtual void setParametersImplementation(const Eigen::MatrixXd& value);
+      /// Returns a new version
+      static size_t getNewVersion();
       /** @}
         */
 
@@ -120,6 +128,8 @@ namespace aslam {
       Container _value;
       /// Old variable container
       Container _oldValue;
+      /// Version of the value
+      size_t _version;
       /** @}
         */
 
@@ -16,6 +16,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
  ******************************************************************************/
 
+#include <atomic>
+
 #include "aslam/calibration/exceptions/OutOfBoundException.h"
 
 namespace aslam {
@@ -28,7 +30,8 @@ namespace aslam {
     template <int M>
     VectorDesignVariable<M>::VectorDesignVariable(const Container& initValue) :
         _value(initValue),
-        _oldValue(initValue) {
+        _oldValue(initValue),
+        _version(getNewVersion()) {
     }
 
     template <int M>
@@ -36,7 +39,8 @@ namespace aslam {
         other) :
         DesignVariable(other),
         _value(other._value),
-        _oldValue(other._oldValue) {
+        _oldValue(other._oldValue),
+        _version(getNewVersion()) {
     }
 
     template <int M>
@@ -46,6 +50,7 @@ namespace aslam {
         DesignVariable::operator=(other);
         _value = other._value;
         _oldValue = other._oldValue;
+        _version = getNewVersion();
       }
       return *this;
     }
@@ -90,6 +95,12 @@ namespace aslam {
     void VectorDesignVariable<M>::setValue(const Container& value) {
       _oldValue = _value;
       _value = value;
+      _version = getNewVersion();
+    }
+
+    template <int M>
+    size_t VectorDesignVariable<M>::getVersion() const {
+      return _version;
     }
 
 /******************************************************************************/
@@ -107,11 +118,13 @@ namespace aslam {
       Eigen::Map<const Container> update(dp, size);
       _oldValue = _value;
       _value += update;
+      _version = getNewVersion();
     }
 
     template <int M>
     void VectorDesignVariable<M>::revertUpdateImplementation() {
       _value = _oldValue;
+      _version = getNewVersion();
     }
 
     template<int M>
@@ -128,6 +141,14 @@ namespace aslam {
           "dimensions must match", __FILE__, __LINE__, __PRETTY_FUNCTION__);
       _oldValue = _value;
       _value = value;
+      _version = getNewVersion();
+    }
+
+    template <int M>
+    size_t VectorDesignVariable<M>::getNewVersion() {
+      // version 0 is never given, it can mark invalid caches
+      static std::atomic<size_t> lastVersion(0);
+      return ++lastVersion;
     }
 
   }
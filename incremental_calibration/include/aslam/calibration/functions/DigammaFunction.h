@@ -24,12 +24,15 @@
 #ifndef ASLAM_CALIBRATION_FUNCTIONS_DIGAMMAFUNCTION_H
 #define ASLAM_CALIBRATION_FUNCTIONS_DIGAMMAFUNCTION_H
 
+#include <Eigen/Core>
+
 #include "aslam/calibration/functions/ContinuousFunction.h"
 
 namespace aslam {
   namespace calibration {
 
-    /** The DigammaFunction class represents the digamma function.
+    /** The DigammaFunction class represents the digamma function. Integer and
+        half-integer arguments are read from a table.
         \brief Digamma function
       */
     template <typename X> class DigammaFunction :
@@ -68,6 +71,9 @@ namespace aslam {
         */
       /// Access the function value for the given argument
       virtual double getValue(const VariableType& argument) const;
+      /// Access the function values for a batch of arguments
+      Eigen::ArrayXd getValues(const Eigen::Array<VariableType, Eigen::Dynamic,
+        1>& arguments) const;
       /** @}
         */
 
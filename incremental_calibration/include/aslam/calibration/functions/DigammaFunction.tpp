@@ -18,6 +18,8 @@
 
 #include <boost/math/special_functions/digamma.hpp>
 
+#include "aslam/calibration/functions/GammaFunctionTable.h"
+
 namespace aslam {
   namespace calibration {
 
@@ -39,8 +41,20 @@ namespace aslam {
 
     template <typename X>
     double DigammaFunction<X>::getValue(const VariableType& argument) const {
+      double value;
+      if (GammaFunctionTable::lookupDigamma(argument, value))
+        return value;
       return boost::math::digamma<X>(argument);
     }
 
+    template <typename X>
+    Eigen::ArrayXd DigammaFunction<X>::getValues(const Eigen::Array<
+        VariableType, Eigen::Dynamic, 1>& arguments) const {
+      Eigen::ArrayXd values(arguments.size());
+      for (size_t i = 0; i < static_cast<size_t>(arguments.size()); ++i)
+        values(i) = getValue(arguments(i));
+      return values;
+    }
+
   }
 }
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file GammaFunctionTable.h
+    \brief This file defines the GammaFunctionTable class, which memoizes the
+           log-gamma and digamma functions at integer and half-integer
+           arguments
+  */
+
+#ifndef ASLAM_CALIBRATION_FUNCTIONS_GAMMAFUNCTIONTABLE_H
+#define ASLAM_CALIBRATION_FUNCTIONS_GAMMAFUNCTIONTABLE_H
+
+#include <cstddef>
+
+namespace aslam {
+  namespace calibration {
+
+    /** The GammaFunctionTable class memoizes the log-gamma and digamma
+        functions at the integer and half-integer arguments k / 2 with
+        1 <= k <= maxDoubledArgument, which cover the shapes of the
+        chi-square distributions and the log-factorials. The tables are
+        built once on first use.
+        \brief Log-gamma and digamma tables at (half-)integer arguments
+      */
+    class GammaFunctionTable {
+    public:
+      /** \name Constants
+        @{
+        */
+      /// Largest tabulated argument times two
+      static const size_t maxDoubledArgument = 2048;
+      /** @}
+        */
+
+      /** \name Methods
+        @{
+        */
+      /// Returns log-gamma at doubledArgument / 2, which must be tabulated
+      static double getLogGamma(size_t doubledArgument);
+      /// Returns digamma at doubledArgument / 2, which must be tabulated
+      static double getDigamma(size_t doubledArgument);
+      /// Looks up log-gamma, returns false if the argument is not tabulated
+      static bool lookupLogGamma(double argument, double& value);
+      /// Looks up digamma, returns false if the argument is not tabulated
+      static bool lookupDigamma(double argument, double& value);
+      /// Returns log-gamma, from the table if the argument is tabulated
+      static double logGamma(double argument);
+      /// Returns digamma, from the table if the argument is tabulated
+      static double digamma(double argument);
+      /** @}
+        */
+
+    protected:
+      /** \name Protected methods
+        @{
+        */
+      /// Returns the doubled argument if it is tabulated, 0 otherwise
+      static size_t getDoubledArgument(double argument);
+      /** @}
+        */
+
+    };
+
+  }
+}
+
+#endif // ASLAM_CALIBRATION_FUNCTIONS_GAMMAFUNCTIONTABLE_H
@@ -24,6 +24,8 @@
 #ifndef ASLAM_CALIBRATION_FUNCTIONS_INCOMPLETEGAMMAPFUNCTION_H
 #define ASLAM_CALIBRATION_FUNCTIONS_INCOMPLETEGAMMAPFUNCTION_H
 
+#include <Eigen/Core>
+
 #include "aslam/calibration/functions/ContinuousFunction.h"
 #include "aslam/calibration/base/Serializable.h"
 
@@ -70,6 +72,22 @@ namespace aslam {
       void setAlpha(double alpha);
       /// Access the function value for the given argument
       virtual double getValue(const VariableType& argument) const;
+      /** Access the function values for a batch of arguments, the log-gamma
+          of alpha being computed once
+        */
+      Eigen::ArrayXd getValues(const Eigen::ArrayXd& arguments) const;
+      /** @}
+        */
+
+      /** \name Methods
+        @{
+        */
+      /** Evaluates the lower and upper normalized incomplete gamma functions
+          given the log-gamma of alpha, by series below alpha + 1 and by
+          continued fraction above
+        */
+      static void evaluate(double alpha, double logGammaAlpha, double x,
+        double& p, double& q);
       /** @}
         */
 
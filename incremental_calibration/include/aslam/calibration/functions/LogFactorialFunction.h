@@ -24,12 +24,17 @@
 #ifndef ASLAM_CALIBRATION_FUNCTIONS_LOGFACTORIALFUNCTION_H
 #define ASLAM_CALIBRATION_FUNCTIONS_LOGFACTORIALFUNCTION_H
 
+#include <Eigen/Core>
+
 #include "aslam/calibration/functions/DiscreteFunction.h"
+#include "aslam/calibration/utils/SizeTSupport.h"
 
 namespace aslam {
   namespace calibration {
 
     /** The LogFactorialFunction class represents the log-factorial function.
+        Values up to GammaFunctionTable::maxDoubledArgument / 2 - 1 are read
+        from a table.
         \brief Log-factorial function
       */
     class LogFactorialFunction :
@@ -68,6 +73,9 @@ namespace aslam {
         */
       /// Access the function value for the given argument
       virtual double getValue(const VariableType& argument) const;
+      /// Access the function values for a batch of arguments
+      Eigen::ArrayXd getValues(const Eigen::Array<VariableType, Eigen::Dynamic,
+        1>& arguments) const;
       /** @}
         */
 
@@ -24,6 +24,8 @@
 #ifndef ASLAM_CALIBRATION_FUNCTIONS_LOGGAMMAFUNCTION_H
 #define ASLAM_CALIBRATION_FUNCTIONS_LOGGAMMAFUNCTION_H
 
+#include <Eigen/Core>
+
 #include "aslam/calibration/functions/ContinuousFunction.h"
 #include "aslam/calibration/functions/LogFactorialFunction.h"
 #include "aslam/calibration/base/Serializable.h"
@@ -32,7 +34,7 @@ namespace aslam {
   namespace calibration {
 
     /** The LogGammaFunction class represents the log-gamma function for real
-        numbers.
+        numbers. Integer and half-integer terms are read from a table.
         \brief Log-gamma function for real numbers
       */
     template <typename X = size_t> class LogGammaFunction :
@@ -70,6 +72,9 @@ namespace aslam {
       void setDim(size_t dim);
       /// Access the function value for the given argument
       virtual double getValue(const VariableType& argument) const;
+      /// Access the function values for a batch of arguments
+      Eigen::ArrayXd getValues(const Eigen::Array<VariableType, Eigen::Dynamic,
+        1>& arguments) const;
       /** @}
         */
 
@@ -18,6 +18,7 @@
 
 #include <cmath>
 
+#include "aslam/calibration/functions/GammaFunctionTable.h"
 #include "aslam/calibration/exceptions/BadArgumentException.h"
 
 namespace aslam {
@@ -79,11 +80,20 @@ namespace aslam {
     double LogGammaFunction<X>::getValue(const VariableType& argument) const {
       double sum = 0.0;
       for (size_t i = 0; i < mDim; ++i) {
-        sum += lgamma(argument - 0.5 * i);
+        sum += GammaFunctionTable::logGamma(argument - 0.5 * i);
       }
       return sum + mDim * (mDim - 1) * 0.25 * log(M_PI);
     }
 
+    template <typename X>
+    Eigen::ArrayXd LogGammaFunction<X>::getValues(const Eigen::Array<
+        VariableType, Eigen::Dynamic, 1>& arguments) const {
+      Eigen::ArrayXd values(arguments.size());
+      for (size_t i = 0; i < static_cast<size_t>(arguments.size()); ++i)
+        values(i) = getValue(arguments(i));
+      return values;
+    }
+
     template <typename X>
     size_t LogGammaFunction<X>::getDim() const {
       return mDim;
@@ -61,7 +61,7 @@ namespace aslam {
       void setTransformationMatrix(const Eigen::Matrix<double, 3, 3>&
         transformationMatrix);
       /// Returns the transformation matrix
-      const Eigen::Matrix<double, 3, 3>& getTransformationMatrix();
+      const Eigen::Matrix<double, 3, 3>& getTransformationMatrix() const;
       /// Sets the transformation from translation and rotation
       void setTransformation(T x, T y, T yaw);
       /// Returns the inverse transformation
@@ -80,10 +80,35 @@ namespace aslam {
       /// Transform a point using operator
       Eigen::Matrix<T, 2, 1> operator () (const Eigen::Matrix<T, 2, 1>& src)
         const;
+      /** Transform a batch of points stored in the columns of a 2xN block
+          with the rotation block and the translation, dest must have the
+          size of src and must not overlap with it
+        */
+      template <typename Derived, typename OtherDerived>
+      void transform(const Eigen::MatrixBase<Derived>& src,
+        const Eigen::MatrixBase<OtherDerived>& dest) const;
+      /// Composes in place with a transformation applied before this one
+      Transformation& operator *= (const Transformation& other);
+      /// Returns the composition with a transformation applied before this one
+      Transformation operator * (const Transformation& other) const;
+      /** Composes a sequence of transformations without intermediate
+          transformations, the first one being applied last, an empty
+          sequence giving the identity
+        */
+      template <typename InputIterator>
+      static Transformation compose(InputIterator first, InputIterator last);
       /** @}
         */
 
     protected:
+      /** \name Protected methods
+        @{
+        */
+      /// Sets the rotation and translation from the transformation matrix
+      void updateFactors();
+      /** @}
+        */
+
       /** \name Stream methods
         @{
         */
@@ -33,6 +33,7 @@ namespace aslam {
     Transformation<T, 2>::Transformation(const Eigen::Matrix<double, 3, 3>&
         transformationMatrix) :
         mTransformationMatrix(transformationMatrix) {
+      updateFactors();
     }
 
     template <typename T>
@@ -91,11 +92,12 @@ namespace aslam {
     void Transformation<T, 2>::setTransformationMatrix(const
         Eigen::Matrix<double, 3, 3>& transformationMatrix) {
       mTransformationMatrix = transformationMatrix;
+      updateFactors();
     }
 
     template <typename T>
     const Eigen::Matrix<double, 3, 3>&
-        Transformation<T, 2>::getTransformationMatrix() {
+        Transformation<T, 2>::getTransformationMatrix() const {
       return mTransformationMatrix;
     }
 
@@ -153,8 +155,66 @@ namespace aslam {
       mTranslationMatrix(0, 2) = -mTranslationMatrix(0, 2);
       mTranslationMatrix(1, 2) = -mTranslationMatrix(1, 2);
       mTransformationMatrix = mRotationMatrix * mTranslationMatrix;
+      updateFactors();
       return *this;
     }
 
+    template <typename T>
+    template <typename Derived, typename OtherDerived>
+    void Transformation<T, 2>::transform(const Eigen::MatrixBase<Derived>&
+        src, const Eigen::MatrixBase<OtherDerived>& dest) const {
+      Eigen::MatrixBase<OtherDerived>& points =
+        const_cast<Eigen::MatrixBase<OtherDerived>&>(dest);
+      // a lazy product avoids the matrix-matrix kernel for a small depth
+      const Eigen::Matrix<T, 2, 2> rotation =
+        mTransformationMatrix.template topLeftCorner<2, 2>();
+      const Eigen::Matrix<T, 2, 1> translation =
+        mTransformationMatrix.template topRightCorner<2, 1>();
+      points = rotation.lazyProduct(src).colwise() + translation;
+    }
+
+    template <typename T>
+    Transformation<T, 2>& Transformation<T, 2>::operator *= (const
+        Transformation& other) {
+      // the translation is updated with the rotation before composition,
+      // the products are evaluated first such that other may be this
+      mTransformationMatrix.template topRightCorner<2, 1>() +=
+        mTransformationMatrix.template topLeftCorner<2, 2>() *
+        other.mTransformationMatrix.template topRightCorner<2, 1>();
+      mTransformationMatrix.template topLeftCorner<2, 2>() =
+        mTransformationMatrix.template topLeftCorner<2, 2>() *
+        other.mTransformationMatrix.template topLeftCorner<2, 2>();
+      updateFactors();
+      return *this;
+    }
+
+    template <typename T>
+    Transformation<T, 2> Transformation<T, 2>::operator * (const
+        Transformation& other) const {
+      return Transformation<T, 2>(*this) *= other;
+    }
+
+    template <typename T>
+    template <typename InputIterator>
+    Transformation<T, 2> Transformation<T, 2>::compose(InputIterator first,
+        InputIterator last) {
+      // the fixed-size homogeneous product is vectorized, the factors are
+      // only rebuilt once at the end
+      Eigen::Matrix<T, 3, 3> matrix = Eigen::Matrix<T, 3, 3>::Identity();
+      for (; first != last; ++first)
+        matrix = matrix * first->mTransformationMatrix;
+      return Transformation<T, 2>(matrix);
+    }
+
+    template <typename T>
+    void Transformation<T, 2>::updateFactors() {
+      mRotationMatrix.setIdentity();
+      mRotationMatrix.template topLeftCorner<2, 2>() =
+        mTransformationMatrix.template topLeftCorner<2, 2>();
+      mTranslationMatrix.setIdentity();
+      mTranslationMatrix.template topRightCorner<2, 1>() =
+        mTransformationMatrix.template topRightCorner<2, 1>();
+    }
+
   }
 }
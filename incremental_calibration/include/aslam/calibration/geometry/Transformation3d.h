@@ -20,6 +20,8 @@
     \brief This file defines a transformation in 3d.
   */
 
+#include <Eigen/Core>
+
 #include "aslam/calibration/base/Serializable.h"
 
 namespace aslam {
@@ -59,7 +61,7 @@ namespace aslam {
       void setTransformationMatrix(const Eigen::Matrix<double, 4, 4>&
         transformationMatrix);
       /// Returns the transformation matrix
-      const Eigen::Matrix<double, 4, 4>& getTransformationMatrix();
+      const Eigen::Matrix<double, 4, 4>& getTransformationMatrix() const;
       /// Sets the transformation from translation and rotation
       void setTransformation(T x, T y, T z, T roll, T pitch, T yaw);
       /// Returns the inverse transformation
@@ -78,10 +80,35 @@ namespace aslam {
       /// Transform a point using operator
       Eigen::Matrix<T, 3, 1> operator () (const Eigen::Matrix<T, 3, 1>& src)
         const;
+      /** Transform a batch of points stored in the columns of a 3xN block
+          with the rotation block and the translation, dest must have the
+          size of src and must not overlap with it
+        */
+      template <typename Derived, typename OtherDerived>
+      void transform(const Eigen::MatrixBase<Derived>& src,
+        const Eigen::MatrixBase<OtherDerived>& dest) const;
+      /// Composes in place with a transformation applied before this one
+      Transformation& operator *= (const Transformation& other);
+      /// Returns the composition with a transformation applied before this one
+      Transformation operator * (const Transformation& other) const;
+      /** Composes a sequence of transformations without intermediate
+          transformations, the first one being applied last, an empty
+          sequence giving the identity
+        */
+      template <typename InputIterator>
+      static Transformation compose(InputIterator first, InputIterator last);
       /** @}
         */
 
     protected:
+      /** \name Protected methods
+        @{
+        */
+      /// Sets the rotation and translation from the transformation matrix
+      void updateFactors();
+      /** @}
+        */
+
       /** \name Stream methods
         @{
         */
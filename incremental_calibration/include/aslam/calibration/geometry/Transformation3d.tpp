@@ -31,6 +31,7 @@ namespace aslam {
     Transformation<T, 3>::Transformation(const Eigen::Matrix<double, 4, 4>&
         transformationMatrix) :
         mTransformationMatrix(transformationMatrix) {
+      updateFactors();
     }
 
     template <typename T>
@@ -90,11 +91,12 @@ namespace aslam {
     void Transformation<T, 3>::setTransformationMatrix(const
         Eigen::Matrix<double, 4, 4>& transformationMatrix) {
       mTransformationMatrix = transformationMatrix;
+      updateFactors();
     }
 
     template <typename T>
     const Eigen::Matrix<double, 4, 4>&
-        Transformation<T, 3>::getTransformationMatrix() {
+        Transformation<T, 3>::getTransformationMatrix() const {
       return mTransformationMatrix;
     }
 
@@ -158,6 +160,7 @@ namespace aslam {
       mTranslationMatrix(1, 3) = -mTranslationMatrix(1, 3);
       mTranslationMatrix(2, 3) = -mTranslationMatrix(2, 3);
       mTransformationMatrix = mRotationMatrix * mTranslationMatrix;
+      updateFactors();
       return *this;
     }
 
@@ -175,5 +178,62 @@ namespace aslam {
       return (mTransformationMatrix * point).template head<3>();
     }
 
+    template <typename T>
+    template <typename Derived, typename OtherDerived>
+    void Transformation<T, 3>::transform(const Eigen::MatrixBase<Derived>&
+        src, const Eigen::MatrixBase<OtherDerived>& dest) const {
+      Eigen::MatrixBase<OtherDerived>& points =
+        const_cast<Eigen::MatrixBase<OtherDerived>&>(dest);
+      // a lazy product avoids the matrix-matrix kernel for a small depth
+      const Eigen::Matrix<T, 3, 3> rotation =
+        mTransformationMatrix.template topLeftCorner<3, 3>();
+      const Eigen::Matrix<T, 3, 1> translation =
+        mTransformationMatrix.template topRightCorner<3, 1>();
+      points = rotation.lazyProduct(src).colwise() + translation;
+    }
+
+    template <typename T>
+    Transformation<T, 3>& Transformation<T, 3>::operator *= (const
+        Transformation& other) {
+      // the translation is updated with the rotation before composition,
+      // the products are evaluated first such that other may be this
+      mTransformationMatrix.template topRightCorner<3, 1>() +=
+        mTransformationMatrix.template topLeftCorner<3, 3>() *
+        other.mTransformationMatrix.template topRightCorner<3, 1>();
+      mTransformationMatrix.template topLeftCorner<3, 3>() =
+        mTransformationMatrix.template topLeftCorner<3, 3>() *
+        other.mTransformationMatrix.template topLeftCorner<3, 3>();
+      updateFactors();
+      return *this;
+    }
+
+    template <typename T>
+    Transformation<T, 3> Transformation<T, 3>::operator * (const
+        Transformation& other) const {
+      return Transformation<T, 3>(*this) *= other;
+    }
+
+    template <typename T>
+    template <typename InputIterator>
+    Transformation<T, 3> Transformation<T, 3>::compose(InputIterator first,
+        InputIterator last) {
+      // the fixed-size homogeneous product is vectorized, the factors are
+      // only rebuilt once at the end
+      Eigen::Matrix<T, 4, 4> matrix = Eigen::Matrix<T, 4, 4>::Identity();
+      for (; first != last; ++first)
+        matrix = matrix * first->mTransformationMatrix;
+      return Transformation<T, 3>(matrix);
+    }
+
+    template <typename T>
+    void Transformation<T, 3>::updateFactors() {
+      mRotationMatrix.setIdentity();
+      mRotationMatrix.template topLeftCorner<3, 3>() =
+        mTransformationMatrix.template topLeftCorner<3, 3>();
+      mTranslationMatrix.setIdentity();
+      mTranslationMatrix.template topRightCorner<3, 1>() =
+        mTransformationMatrix.template topRightCorner<3, 1>();
+    }
+
   }
 }
@@ -64,6 +64,17 @@ namespace aslam {
       /** @}
         */
 
+      /** \name Methods
+        @{
+        */
+      /** Returns the inverse cumulative density function of a distribution
+          with the given degrees at the given probability, the quantiles
+          being cached across calls and threads
+        */
+      static double getQuantile(double degrees, double probability);
+      /** @}
+        */
+
     protected:
       /** \name Stream methods
         @{
@@ -30,7 +30,9 @@ namespace aslam {
   namespace calibration {
 
     /** The class EstimatorML is implemented for multivariate normal
-        distributions.
+        distributions. The mean and the scatter matrix are updated with
+        Welford's algorithm, partial estimators are merged with Chan's
+        formula, and the distribution is only factorized when it is read.
         \brief Multivariate normal distribution ML estimator
       */
     template <int M> class EstimatorML<NormalDistribution<M> > :
@@ -79,6 +81,10 @@ namespace aslam {
       bool getValid() const;
       /// Returns the estimated distribution
       const NormalDistribution<M>& getDistribution() const;
+      /// Returns the running mean of the points
+      const Eigen::Matrix<double, M, 1>& getMean() const;
+      /// Returns the sum of the squared deviations from the running mean
+      const Eigen::Matrix<double, M, M>& getScatter() const;
       /// Add a point to the estimator
       void addPoint(const Point& point);
       /// Add points to the estimator
@@ -90,6 +96,8 @@ namespace aslam {
         const Eigen::Matrix<double, Eigen::Dynamic, 1>& responsibilities);
       /// Add points to the estimator
       void addPoints(const Container& points);
+      /// Merges an estimator over points disjoint from the current ones
+      void merge(const EstimatorML& other);
       /// Reset the estimator
       void reset();
       /** @}
@@ -110,19 +118,29 @@ namespace aslam {
       /** @}
         */
 
+      /** \name Protected methods
+        @{
+        */
+      /// Updates the distribution from the running statistics if needed
+      void updateDistribution() const;
+      /** @}
+        */
+
       /** \name Protected members
         @{
         */
       /// Estimated distribution
-      NormalDistribution<M> mDistribution;
+      mutable NormalDistribution<M> mDistribution;
       /// Number of points in the estimator
       size_t mNumPoints;
       /// Valid flag
-      bool mValid;
-      /// Sum of the values
-      Eigen::Matrix<double, M, 1> mValuesSum;
-      /// Squared sum of the values
-      Eigen::Matrix<double, M, M> mSquaredValuesSum;
+      mutable bool mValid;
+      /// The distribution is outdated with respect to the running statistics
+      mutable bool mOutdated;
+      /// Running mean of the values
+      Eigen::Matrix<double, M, 1> mMean;
+      /// Sum of the squared deviations from the running mean
+      Eigen::Matrix<double, M, M> mScatter;
       /** @}
         */
 
@@ -16,6 +16,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
  ******************************************************************************/
 
+#include <cmath>
+
 #include "aslam/calibration/utils/OuterProduct.h"
 
 namespace aslam {
@@ -28,7 +30,10 @@ namespace aslam {
     template <int M>
     EstimatorML<NormalDistribution<M> >::EstimatorML() :
         mNumPoints(0),
-        mValid(false) {
+        mValid(false),
+        mOutdated(false) {
+      mMean.setZero();
+      mScatter.setZero();
     }
 
     template <int M>
@@ -36,8 +41,9 @@ namespace aslam {
         mDistribution(other.mDistribution),
         mNumPoints(other.mNumPoints),
         mValid(other.mValid),
-        mValuesSum(other.mValuesSum),
-        mSquaredValuesSum(other.mSquaredValuesSum) {
+        mOutdated(other.mOutdated),
+        mMean(other.mMean),
+        mScatter(other.mScatter) {
     }
 
     template <int M>
@@ -48,8 +54,9 @@ namespace aslam {
         mDistribution = other.mDistribution;
         mNumPoints = other.mNumPoints;
         mValid = other.mValid;
-        mValuesSum = other.mValuesSum;
-        mSquaredValuesSum = other.mSquaredValuesSum;
+        mOutdated = other.mOutdated;
+        mMean = other.mMean;
+        mScatter = other.mScatter;
       }
       return *this;
     }
@@ -69,6 +76,7 @@ namespace aslam {
     template <int M>
     void EstimatorML<NormalDistribution<M> >::write(std::ostream& stream)
         const {
+      updateDistribution();
       stream << "distribution: " << std::endl << mDistribution << std::endl
         << "number of points: " << mNumPoints << std::endl
         << "valid: " << mValid;
@@ -94,44 +102,96 @@ namespace aslam {
 
     template <int M>
     bool EstimatorML<NormalDistribution<M> >::getValid() const {
+      updateDistribution();
       return mValid;
     }
 
     template <int M>
     const NormalDistribution<M>&
         EstimatorML<NormalDistribution<M> >::getDistribution() const {
+      updateDistribution();
       return mDistribution;
     }
 
+    template <int M>
+    const Eigen::Matrix<double, M, 1>&
+        EstimatorML<NormalDistribution<M> >::getMean() const {
+      return mMean;
+    }
+
+    template <int M>
+    const Eigen::Matrix<double, M, M>&
+        EstimatorML<NormalDistribution<M> >::getScatter() const {
+      return mScatter;
+    }
+
     template <int M>
     void EstimatorML<NormalDistribution<M> >::reset() {
+      mDistribution = NormalDistribution<M>();
       mNumPoints = 0;
       mValid = false;
+      mOutdated = false;
+      mMean.setZero();
+      mScatter.setZero();
     }
 
     template <int M>
-    void EstimatorML<NormalDistribution<M> >::addPoint(const Point& point) {
-      if (mNumPoints == 0) {
-        mValuesSum = Eigen::Matrix<double, M, 1>::Zero(point.size());
-        mSquaredValuesSum = Eigen::Matrix<double, M, M>::Zero(point.size(),
-          point.size());
-      }
-      mNumPoints++;
-      mValuesSum += point;
-      mSquaredValuesSum += OuterProduct::compute<double, M>(point);
+    void EstimatorML<NormalDistribution<M> >::updateDistribution() const {
+      if (!mOutdated)
+        return;
+      mOutdated = false;
       try {
         mValid = true;
-        const Eigen::Matrix<double, M, 1> mean = mValuesSum / mNumPoints;
-        mDistribution.setMean(mean);
-        mDistribution.setCovariance(mSquaredValuesSum / mNumPoints -
-          OuterProduct::compute<double, M>(mValuesSum) * 2 /
-          (mNumPoints * mNumPoints) + OuterProduct::compute<double, M>(mean));
+        mDistribution.setMean(mMean);
+        mDistribution.setCovariance(mScatter /
+          static_cast<double>(mNumPoints));
       }
       catch (...) {
         mValid = false;
       }
     }
 
+    template <int M>
+    void EstimatorML<NormalDistribution<M> >::addPoint(const Point& point) {
+      if (mNumPoints == 0) {
+        mMean = Eigen::Matrix<double, M, 1>::Zero(point.size());
+        mScatter = Eigen::Matrix<double, M, M>::Zero(point.size(),
+          point.size());
+      }
+      mNumPoints++;
+      const Eigen::Matrix<double, M, 1> delta = point - mMean;
+      const double weight = 1.0 / mNumPoints;
+      mMean += delta * weight;
+      // delta * (point - mMean)^T as an exactly symmetric rank-one update
+      const Eigen::Matrix<double, M, 1> scaledDelta = delta *
+        sqrt(1.0 - weight);
+      mScatter.noalias() += scaledDelta * scaledDelta.transpose();
+      mOutdated = true;
+    }
+
+    template <int M>
+    void EstimatorML<NormalDistribution<M> >::merge(const EstimatorML& other) {
+      if (other.mNumPoints == 0)
+        return;
+      if (mNumPoints == 0) {
+        mNumPoints = other.mNumPoints;
+        mMean = other.mMean;
+        mScatter = other.mScatter;
+        mOutdated = true;
+        return;
+      }
+      const size_t numPoints = mNumPoints + other.mNumPoints;
+      const Eigen::Matrix<double, M, 1> delta = other.mMean - mMean;
+      const double weight = static_cast<double>(other.mNumPoints) / numPoints;
+      const Eigen::Matrix<double, M, 1> scaledDelta = delta *
+        sqrt(mNumPoints * weight);
+      mMean += delta * weight;
+      mScatter += other.mScatter;
+      mScatter.noalias() += scaledDelta * scaledDelta.transpose();
+      mNumPoints = numPoints;
+      mOutdated = true;
+    }
+
     template <int M>
     void EstimatorML<NormalDistribution<M> >::addPoints(const
         ConstPointIterator& itStart, const ConstPointIterator& itEnd) {
@@ -163,6 +223,7 @@ namespace aslam {
         covariance += responsibilities(it - itStart) *
           OuterProduct::compute<double, M>(*it - mean);
       covariance /= numPoints;
+      mOutdated = false;
       try {
         mValid = true;
         mDistribution.setMean(mean);
@@ -24,6 +24,8 @@
 #ifndef ASLAM_CALIBRATION_STATISTICS_GAMMADISTRIBUTION_H
 #define ASLAM_CALIBRATION_STATISTICS_GAMMADISTRIBUTION_H
 
+#include <Eigen/Core>
+
 #include "aslam/calibration/statistics/ContinuousDistribution.h"
 #include "aslam/calibration/statistics/SampleDistribution.h"
 #include "aslam/calibration/base/Serializable.h"
@@ -81,6 +83,8 @@ namespace aslam {
       double logpdf(const RandomVariable& value) const;
       /// Access the cumulative density function at the given value
       double cdf(const RandomVariable& value) const;
+      /// Access the cumulative density function at a batch of values
+      Eigen::ArrayXd cdfs(const Eigen::ArrayXd& values) const;
       /// Access the inverse cumulative density function at the given value
       RandomVariable invcdf(double probability) const;
       /// Access a sample drawn from the distribution
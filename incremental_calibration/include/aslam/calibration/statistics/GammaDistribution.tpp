@@ -153,6 +153,13 @@ namespace aslam {
         return incGammaPFunction(value * mInvScale);
     }
 
+    template <typename T>
+    Eigen::ArrayXd GammaDistribution<T>::cdfs(const Eigen::ArrayXd& values)
+        const {
+      const IncompleteGammaPFunction incGammaPFunction(mShape);
+      return incGammaPFunction.getValues(values * mInvScale);
+    }
+
     template <typename T>
     typename GammaDistribution<T>::RandomVariable
         GammaDistribution<T>::invcdf(double probability) const {
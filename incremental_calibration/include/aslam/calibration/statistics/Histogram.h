@@ -23,10 +23,13 @@
 #ifndef ASLAM_CALIBRATION_STATISTICS_HISTOGRAM_H
 #define ASLAM_CALIBRATION_STATISTICS_HISTOGRAM_H
 
+#include "aslam/calibration/data-structures/Grid.h"
+
 namespace aslam {
   namespace calibration {
 
-    template <typename T, int M = 1> class Histogram;
+    template <typename T, int M = 1, typename G = Grid<T, double, M> >
+      class Histogram;
 
   }
 }
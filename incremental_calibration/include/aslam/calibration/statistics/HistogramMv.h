@@ -20,30 +20,44 @@
     \brief This file contains the definition of a multivariate histogram.
   */
 
+#include <vector>
+
 #include "aslam/calibration/data-structures/Grid.h"
+#include "aslam/calibration/data-structures/MappedGrid.h"
+#include "aslam/calibration/data-structures/SparseGrid.h"
 
 namespace aslam {
   namespace calibration {
 
-    /** The HistogramMv class defines multivariate histograms.
+    /** The HistogramMv class defines multivariate histograms. Samples are
+        binned through flat cell indices and the moments are computed over
+        the flat cell array. The cells are stored in a dense Grid by default,
+        or in a SparseGrid for high-dimensional or mostly empty domains, the
+        moments then being computed over the occupied cells only. A dense
+        histogram written with writeBinary() can be loaded read-only as a
+        Mapped grid, whose moments are given by the static compute methods.
         \brief Multivariate histogram
       */
-    template <typename T, int M> class Histogram :
-      public Grid<T, double, M> {
+    template <typename T, int M, typename G> class Histogram :
+      public G {
     public:
       /** \name Types definitions
         @{
         */
       /// Coordinate type
-      typedef typename Grid<T, double, M>::Coordinate Coordinate;
+      typedef typename G::Coordinate Coordinate;
       /// Index type
-      typedef typename Grid<T, double, M>::Index Index;
+      typedef typename G::Index Index;
       /// Mean type
       typedef Eigen::Matrix<double, M, 1> Mean;
       /// Mode type
       typedef Eigen::Matrix<double, M, 1> Mode;
       /// Covariance type
       typedef Eigen::Matrix<double, M, M> Covariance;
+      /// Read-only memory-mapped histogram type
+      typedef MappedGrid<T, double, M> Mapped;
+      /// Sparse histogram type
+      typedef Histogram<T, M, SparseGrid<T, double, M> > Sparse;
       /** @}
         */
 
@@ -76,13 +90,33 @@ namespace aslam {
       double getSum() const;
       /// Add a sample to the histogram
       void addSample(const Coordinate& sample);
-      /// Add samples to the histogram
-      void addSamples(const std::vector<Coordinate>& samples);
+      /** Add samples to the histogram, accumulating contiguous ranges into
+          per-thread histograms when numThreads is not 1 (0 for the hardware
+          concurrency)
+        */
+      void addSamples(const std::vector<Coordinate>& samples,
+        size_t numThreads = 1, size_t minSamplesPerThread = 4096);
+      /// Adds the counts of a histogram with the same geometry
+      void merge(const Histogram& other);
       /// Returns a normalized copy of the histogram
       Histogram getNormalized() const;
       /** @}
         */
 
+      /** \name Methods
+        @{
+        */
+      /// Computes the mean value of a histogram or mapped histogram
+      template <typename H> static Mean computeMean(const H& grid);
+      /// Computes the mode value of a histogram or mapped histogram
+      template <typename H> static Mode computeMode(const H& grid);
+      /// Computes the covariance of a histogram or mapped histogram
+      template <typename H> static Covariance computeCovariance(const H& grid);
+      /// Computes the sum of a histogram or mapped histogram
+      template <typename H> static double computeSum(const H& grid);
+      /** @}
+        */
+
     protected:
 
     };
@@ -16,8 +16,14 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
  ******************************************************************************/
 
+#include <algorithm>
 #include <limits>
 
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include "aslam/calibration/exceptions/BadArgumentException.h"
+
 namespace aslam {
   namespace calibration {
 
@@ -25,99 +31,181 @@ namespace aslam {
 /* Constructors and Destructor                                                */
 /******************************************************************************/
 
-    template <typename T, int M>
-    Histogram<T, M>::Histogram(const Coordinate& min, const Coordinate& max,
+    template <typename T, int M, typename G>
+    Histogram<T, M, G>::Histogram(const Coordinate& min, const Coordinate& max,
         const Coordinate& binSize) :
-        Grid<T, double, M>(min, max, binSize) {
+        G(min, max, binSize) {
     }
 
-    template <typename T, int M>
-    Histogram<T, M>::Histogram(const Histogram& other) :
-      Grid<T, double, M>(other) {
+    template <typename T, int M, typename G>
+    Histogram<T, M, G>::Histogram(const Histogram& other) :
+      G(other) {
     }
 
-    template <typename T, int M>
-    Histogram<T, M>& Histogram<T, M>::operator = (const Histogram& other) {
+    template <typename T, int M, typename G>
+    Histogram<T, M, G>& Histogram<T, M, G>::operator = (const Histogram&
+        other) {
       if (this != &other) {
-        Grid<T, double, M>::operator=(other);
+        G::operator=(other);
       }
       return *this;
     }
 
-    template <typename T, int M>
-    Histogram<T, M>::~Histogram() {
+    template <typename T, int M, typename G>
+    Histogram<T, M, G>::~Histogram() {
     }
 
 /******************************************************************************/
 /* Accessors                                                                  */
 /******************************************************************************/
 
-    template <typename T, int M>
-    typename Histogram<T, M>::Mean Histogram<T, M>::getMean() const {
-      Mean mean = Mean::Zero(this->mNumCells.size());
-      for (Index i = Index::Zero(this->mNumCells.size()); i != this->mNumCells;
-          incrementIndex(i))
-        mean += this->getCoordinates(i).template cast<double>() *
-          this->getCell(i);
-      return mean / getSum();
+    template <typename T, int M, typename G>
+    typename Histogram<T, M, G>::Mean Histogram<T, M, G>::getMean() const {
+      return computeMean(*this);
     }
 
-    template <typename T, int M>
-    typename Histogram<T, M>::Mode Histogram<T, M>::getMode() const {
-      double max = -std::numeric_limits<double>::infinity();
-      Index modeIdx;
-      for (Index i = Index::Zero(this->mNumCells.size()); i != this->mNumCells;
-          incrementIndex(i)) {
-        if (this->getCell(i) > max) {
-          max = this->getCell(i);
-          modeIdx = i;
-        }
-      }
-      return this->getCoordinates(modeIdx);
+    template <typename T, int M, typename G>
+    typename Histogram<T, M, G>::Mode Histogram<T, M, G>::getMode() const {
+      return computeMode(*this);
     }
 
-    template <typename T, int M>
-    typename Histogram<T, M>::Covariance Histogram<T, M>::getCovariance()
+    template <typename T, int M, typename G>
+    typename Histogram<T, M, G>::Covariance Histogram<T, M, G>::getCovariance()
         const {
-      Covariance covariance = Covariance::Zero(this->mNumCells.size(),
-        this->mNumCells.size());
-      const Mean mean = getMean();
-      for (Index i = Index::Zero(this->mNumCells.size()); i != this->mNumCells;
-          incrementIndex(i))
-        covariance += (this->getCoordinates(i).template cast<double>() - mean) *
-          (this->getCoordinates(i).template cast<double>() - mean).transpose() *
-          this->getCell(i);
-      return covariance / (getSum() - 1);
-    }
-
-    template <typename T, int M>
-    double Histogram<T, M>::getSum() const {
-      double sum = 0;
-      for (auto it = this->getCellBegin(); it != this->getCellEnd(); ++it)
-        sum += *it;
-      return sum;
+      return computeCovariance(*this);
     }
 
-    template <typename T, int M>
-    void Histogram<T, M>::addSample(const Coordinate& sample) {
-      if (this->isInRange(sample))
-        this->getCell(this->getIndex(sample))++;
+    template <typename T, int M, typename G>
+    double Histogram<T, M, G>::getSum() const {
+      return computeSum(*this);
     }
 
-    template <typename T, int M>
-    void Histogram<T, M>::addSamples(const std::vector<Coordinate>& samples) {
-      for (size_t i = 0; i < samples.size(); ++i)
-        addSample(samples[i]);
+    template <typename T, int M, typename G>
+    void Histogram<T, M, G>::addSample(const Coordinate& sample) {
+      size_t linIdx;
+      if (this->getLinearIndex(sample, linIdx))
+        this->mCells[linIdx]++;
     }
 
-    template <typename T, int M>
-    Histogram<T, M> Histogram<T, M>::getNormalized() const {
+    template <typename T, int M, typename G>
+    void Histogram<T, M, G>::addSamples(const std::vector<Coordinate>& samples,
+        size_t numThreads, size_t minSamplesPerThread) {
+      if (!numThreads)
+        numThreads = std::max(boost::thread::hardware_concurrency(), 1u);
+      numThreads = std::max(std::min(numThreads, samples.size() /
+        std::max(minSamplesPerThread, size_t(1))), size_t(1));
+      if (numThreads == 1) {
+        for (size_t i = 0; i < samples.size(); ++i)
+          addSample(samples[i]);
+        return;
+      }
+
+      // each worker bins a contiguous range into its own histogram
+      std::vector<boost::shared_ptr<Histogram> > partials(numThreads);
+      auto work = [&](size_t worker) {
+        const size_t begin = samples.size() * worker / numThreads;
+        const size_t end = samples.size() * (worker + 1) / numThreads;
+        partials[worker].reset(new Histogram(this->getMinimum(),
+          this->getMaximum(), this->getResolution()));
+        for (size_t i = begin; i < end; ++i)
+          partials[worker]->addSample(samples[i]);
+      };
+      boost::thread_group workers;
+      for (size_t i = 0; i < numThreads; ++i)
+        workers.create_thread([&work, i](){work(i);});
+      workers.join_all();
+      for (size_t i = 0; i < numThreads; ++i)
+        merge(*partials[i]);
+    }
+
+    template <typename T, int M, typename G>
+    void Histogram<T, M, G>::merge(const Histogram& other) {
+      if (this->getMinimum() != other.getMinimum() ||
+          this->getMaximum() != other.getMaximum() ||
+          this->getResolution() != other.getResolution())
+        throw BadArgumentException<Coordinate>(other.getResolution(),
+          "Histogram<T, M, G>::merge(): histograms must have the same "
+          "geometry", __FILE__, __LINE__);
+      other.forEachCell([this](size_t linIdx, const double& count) {
+        if (count != 0)
+          this->mCells[linIdx] += count;
+      });
+    }
+
+    template <typename T, int M, typename G>
+    Histogram<T, M, G> Histogram<T, M, G>::getNormalized() const {
       const double sum = getSum();
       auto histCopy = *this;
-      for (auto it = histCopy.getCellBegin(); it != histCopy.getCellEnd(); ++it)
-        *it /= sum;
+      histCopy.forEachCell([sum](size_t linIdx, double& count) {
+        count /= sum;
+      });
       return histCopy;
     }
 
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    template <typename T, int M, typename G>
+    template <typename H>
+    typename Histogram<T, M, G>::Mean Histogram<T, M, G>::computeMean(const H&
+        grid) {
+      Mean mean = Mean::Zero(grid.getNumCells().size());
+      double sum = 0;
+      grid.forEachCell([&](size_t linIdx, const double& count) {
+        if (count == 0)
+          return;
+        mean += grid.getCoordinates(grid.computeIndex(linIdx)).template
+          cast<double>() * count;
+        sum += count;
+      });
+      return mean / sum;
+    }
+
+    template <typename T, int M, typename G>
+    template <typename H>
+    typename Histogram<T, M, G>::Mode Histogram<T, M, G>::computeMode(const H&
+        grid) {
+      double max = -std::numeric_limits<double>::infinity();
+      size_t modeIdx = 0;
+      grid.forEachCell([&](size_t linIdx, const double& count) {
+        if (count > max) {
+          max = count;
+          modeIdx = linIdx;
+        }
+      });
+      return grid.getCoordinates(grid.computeIndex(modeIdx)).template
+        cast<double>();
+    }
+
+    template <typename T, int M, typename G>
+    template <typename H>
+    typename Histogram<T, M, G>::Covariance
+        Histogram<T, M, G>::computeCovariance(const H& grid) {
+      Covariance covariance = Covariance::Zero(grid.getNumCells().size(),
+        grid.getNumCells().size());
+      const Mean mean = computeMean(grid);
+      double sum = 0;
+      grid.forEachCell([&](size_t linIdx, const double& count) {
+        if (count == 0)
+          return;
+        const Mean deviation = grid.getCoordinates(grid.computeIndex(linIdx)).
+          template cast<double>() - mean;
+        covariance.noalias() += deviation * deviation.transpose() * count;
+        sum += count;
+      });
+      return covariance / (sum - 1);
+    }
+
+    template <typename T, int M, typename G>
+    template <typename H>
+    double Histogram<T, M, G>::computeSum(const H& grid) {
+      double sum = 0;
+      grid.forEachCell([&sum](size_t linIdx, const double& count) {
+        sum += count;
+      });
+      return sum;
+    }
+
   }
 }
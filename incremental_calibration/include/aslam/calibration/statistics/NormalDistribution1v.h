@@ -22,6 +22,8 @@
 
 #include <tuple>
 
+#include <Eigen/Core>
+
 #include "aslam/calibration/statistics/ContinuousDistribution.h"
 #include "aslam/calibration/statistics/SampleDistribution.h"
 #include "aslam/calibration/base/Serializable.h"
@@ -93,6 +95,10 @@ namespace aslam {
       double cdf(const RandomVariable& value) const;
       /// Access a sample drawn from the distribution
       virtual RandomVariable getSample() const;
+      /// Access samples drawn from the distribution
+      using SampleDistribution<double>::getSamples;
+      /// Access samples drawn from the distribution
+      void getSamples(Eigen::VectorXd& samples, size_t numSamples) const;
       /// Returns the KL-divergence with another distribution
       double KLDivergence(const NormalDistribution<1>& other) const;
       /// Returns the squared Mahalanobis distance from a given value
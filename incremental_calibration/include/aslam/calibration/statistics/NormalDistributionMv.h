@@ -33,7 +33,9 @@ namespace aslam {
   namespace calibration {
 
     /** The NormalDistributionMv class represents a multivariate normal
-        distribution.
+        distribution. A single Cholesky factorization of the covariance
+        serves the validation, the log-determinant, the solves and the
+        sampling; the precision matrix is only computed when requested.
         \brief Multivariate normal distribution
       */
     template <int M> class NormalDistribution :
@@ -94,6 +96,8 @@ namespace aslam {
       Precision getPrecision() const;
       /// Returns the determinant of the covariance matrix
       double getDeterminant() const;
+      /// Returns the log-determinant of the covariance matrix
+      double getLogDeterminant() const;
       /// Returns the normalizer of the distribution
       double getNormalizer() const;
       /// Returns the mode of the distribution
@@ -104,12 +108,23 @@ namespace aslam {
       virtual double pdf(const RandomVariable& value) const;
       /// Access the log-probability density function at the given value
       double logpdf(const RandomVariable& value) const;
+      /// Access the log-probability density function at points, one per row
+      Eigen::VectorXd logpdfs(const Eigen::Matrix<double, Eigen::Dynamic, M>&
+        points) const;
       /// Access a sample drawn from the distribution
       virtual RandomVariable getSample() const;
+      /// Access samples drawn from the distribution
+      using SampleDistribution<Eigen::Matrix<double, M, 1> >::getSamples;
+      /// Access samples drawn from the distribution, one sample per row
+      void getSamples(Eigen::Matrix<double, Eigen::Dynamic, M>& samples,
+        size_t numSamples) const;
       /// Returns the KL-divergence with another distribution
       double KLDivergence(const NormalDistribution<M>& other) const;
       /// Returns the squared Mahalanobis distance from a point
       double mahalanobisDistance(const RandomVariable& value) const;
+      /// Returns the squared Mahalanobis distances from points, one per row
+      Eigen::VectorXd mahalanobisDistances(const Eigen::Matrix<double,
+        Eigen::Dynamic, M>& points) const;
       /** @}
         */
 
@@ -135,10 +150,14 @@ namespace aslam {
       Mean mMean;
       /// Covariance matrix of the normal distribution
       Covariance mCovariance;
-      /// Precision matrix of the normal distribution
-      Covariance mPrecision;
+      /// Precision matrix of the normal distribution, computed on demand
+      mutable Covariance mPrecision;
+      /// The precision matrix is up to date
+      mutable bool mPrecisionComputed;
       /// Determinant of the covariance matrix
       double mDeterminant;
+      /// Log-determinant of the covariance matrix
+      double mLogDeterminant;
       /// Normalizer of the distribution
       double mNormalizer;
       /// Cholesky decomposition of the covariance matrix
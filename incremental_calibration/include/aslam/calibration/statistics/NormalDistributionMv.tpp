@@ -16,9 +16,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
  ******************************************************************************/
 
-#include <Eigen/LU>
-
 #include "aslam/calibration/statistics/Randomizer.h"
+#include "aslam/calibration/statistics/RandomGenerator.h"
 #include "aslam/calibration/exceptions/BadArgumentException.h"
 
 namespace aslam {
@@ -31,14 +30,16 @@ namespace aslam {
     template <int M>
     NormalDistribution<M>::NormalDistribution(const Mean& mean,
         const Covariance& covariance):
-        mMean(mean) {
+        mMean(mean),
+        mPrecisionComputed(false) {
       setCovariance(covariance);
     }
 
     template <int M>
     NormalDistribution<M>::NormalDistribution(const
         std::tuple<Mean, Covariance>& parameters):
-        mMean(std::get<0>(parameters)) {
+        mMean(std::get<0>(parameters)),
+        mPrecisionComputed(false) {
       setCovariance(std::get<1>(parameters));
     }
 
@@ -47,7 +48,9 @@ namespace aslam {
         mMean(other.mMean),
         mCovariance(other.mCovariance),
         mPrecision(other.mPrecision),
+        mPrecisionComputed(other.mPrecisionComputed),
         mDeterminant(other.mDeterminant),
+        mLogDeterminant(other.mLogDeterminant),
         mNormalizer(other.mNormalizer),
         mTransformation(other.mTransformation) {
     }
@@ -59,7 +62,9 @@ namespace aslam {
         mMean = other.mMean;
         mCovariance = other.mCovariance;
         mPrecision = other.mPrecision;
+        mPrecisionComputed = other.mPrecisionComputed;
         mDeterminant = other.mDeterminant;
+        mLogDeterminant = other.mLogDeterminant;
         mNormalizer = other.mNormalizer;
         mTransformation = other.mTransformation;
       }
@@ -114,20 +119,23 @@ namespace aslam {
           "NormalDistribution<M>::setCovariance(): "
           "covariance must be symmetric",
           __FILE__, __LINE__);
-      mTransformation = Eigen::LLT<Covariance>(covariance);
-      if (!Eigen::LDLT<Covariance>(covariance).isPositive())
-        throw BadArgumentException<Covariance>(covariance,
-          "NormalDistribution<M>::setCovariance(): covariance must be positive "
-          "definite",
-          __FILE__, __LINE__);
       if ((covariance.diagonal().array() < 0).any())
         throw BadArgumentException<Covariance>(covariance,
           "NormalDistribution<M>::setCovariance(): variances must be positive",
           __FILE__, __LINE__);
-      mPrecision = covariance.inverse();
-      mDeterminant = covariance.determinant();
+      const Eigen::LLT<Covariance> transformation(covariance);
+      if (transformation.info() != Eigen::Success)
+        throw BadArgumentException<Covariance>(covariance,
+          "NormalDistribution<M>::setCovariance(): covariance must be positive "
+          "definite",
+          __FILE__, __LINE__);
+      mTransformation = transformation;
+      mLogDeterminant = 2.0 *
+        mTransformation.matrixLLT().diagonal().array().log().sum();
+      mDeterminant = exp(mLogDeterminant);
       mNormalizer = 0.5 * mMean.size() * log(2.0 * M_PI) + 0.5 *
-        log(mDeterminant);
+        mLogDeterminant;
+      mPrecisionComputed = false;
       mCovariance = covariance;
     }
 
@@ -140,6 +148,11 @@ namespace aslam {
     template <int M>
     typename NormalDistribution<M>::Precision
         NormalDistribution<M>::getPrecision() const {
+      if (!mPrecisionComputed) {
+        mPrecision = mTransformation.solve(Covariance::Identity(mMean.size(),
+          mMean.size()));
+        mPrecisionComputed = true;
+      }
       return mPrecision;
     }
 
@@ -148,6 +161,11 @@ namespace aslam {
       return mDeterminant;
     }
 
+    template <int M>
+    double NormalDistribution<M>::getLogDeterminant() const {
+      return mLogDeterminant;
+    }
+
     template <int M>
     double NormalDistribution<M>::getNormalizer() const {
       return mNormalizer;
@@ -170,30 +188,71 @@ namespace aslam {
       return -0.5 * mahalanobisDistance(value) - mNormalizer;
     }
 
+    template <int M>
+    Eigen::VectorXd NormalDistribution<M>::logpdfs(const Eigen::Matrix<double,
+        Eigen::Dynamic, M>& points) const {
+      return (-0.5 * mahalanobisDistances(points).array() -
+        mNormalizer).matrix();
+    }
+
     template <int M>
     typename NormalDistribution<M>::RandomVariable
         NormalDistribution<M>::getSample() const {
       RandomVariable sample(mMean.size());
-      const static Randomizer<double> randomizer;
-      for (size_t i = 0; i < (size_t)mMean.size(); ++i)
-        sample(i) = randomizer.sampleNormal();
+      if (RandomGenerator::isEnabled()) {
+        RandomGenerator& generator = RandomGenerator::getInstance();
+        for (size_t i = 0; i < (size_t)mMean.size(); ++i)
+          sample(i) = generator.sampleNormal();
+      }
+      else {
+        const static Randomizer<double> randomizer;
+        for (size_t i = 0; i < (size_t)mMean.size(); ++i)
+          sample(i) = randomizer.sampleNormal();
+      }
       return mMean + mTransformation.matrixL() * sample;
     }
 
+    template <int M>
+    void NormalDistribution<M>::getSamples(Eigen::Matrix<double,
+        Eigen::Dynamic, M>& samples, size_t numSamples) const {
+      samples.resize(numSamples, mMean.size());
+      if (RandomGenerator::isEnabled()) {
+        RandomGenerator& generator = RandomGenerator::getInstance();
+        for (size_t j = 0; j < (size_t)samples.cols(); ++j)
+          for (size_t i = 0; i < numSamples; ++i)
+            samples(i, j) = generator.sampleNormal();
+      }
+      else {
+        const static Randomizer<double> randomizer;
+        for (size_t j = 0; j < (size_t)samples.cols(); ++j)
+          for (size_t i = 0; i < numSamples; ++i)
+            samples(i, j) = randomizer.sampleNormal();
+      }
+      samples = samples * mTransformation.matrixU();
+      samples.rowwise() += mMean.transpose();
+    }
+
     template <int M>
     double NormalDistribution<M>::KLDivergence(const NormalDistribution<M>&
         other) const {
-      return 0.5 * (log(other.mDeterminant / mDeterminant) +
-        (other.mPrecision * mCovariance).trace() - mMean.size() +
-        ((mMean - other.mMean).transpose() * other.mPrecision *
-        (mMean - other.mMean))(0, 0));
+      return 0.5 * (other.mLogDeterminant - mLogDeterminant +
+        other.mTransformation.solve(mCovariance).trace() - mMean.size() +
+        other.mahalanobisDistance(mMean));
     }
 
     template <int M>
     double NormalDistribution<M>::mahalanobisDistance(const RandomVariable& 
         value) const {
-      return ((value - mMean).transpose() * mPrecision *
-        (value - mMean))(0, 0);
+      return mTransformation.matrixL().solve(value - mMean).squaredNorm();
+    }
+
+    template <int M>
+    Eigen::VectorXd NormalDistribution<M>::mahalanobisDistances(const
+        Eigen::Matrix<double, Eigen::Dynamic, M>& points) const {
+      const Eigen::Matrix<double, M, Eigen::Dynamic> whitened =
+        mTransformation.matrixL().solve((points.rowwise() -
+        mMean.transpose()).transpose());
+      return whitened.colwise().squaredNorm().transpose();
     }
 
     template <int M>
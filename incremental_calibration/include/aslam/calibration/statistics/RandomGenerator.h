@@ -0,0 +1,140 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file RandomGenerator.h
+    \brief This file defines the RandomGenerator class, which implements a
+           seedable pseudo-random generator with independent streams
+  */
+
+#ifndef ASLAM_CALIBRATION_STATISTICS_RANDOM_GENERATOR_H
+#define ASLAM_CALIBRATION_STATISTICS_RANDOM_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace aslam {
+  namespace calibration {
+
+    /** The RandomGenerator class implements the xoshiro256** generator of
+        Blackman and Vigna with uniform sampling and ziggurat normal
+        sampling. A generator is defined by a seed and a stream index, the
+        streams of a seed being separated by 2^128 draws. Each thread owns a
+        generator which is seeded from a global seed and a per-thread stream,
+        such that Monte-Carlo runs are reproducible whatever the number of
+        threads, provided each worker selects its stream. When enabled, the
+        Randomizer and the distributions sample from the thread generator
+        instead of random().
+        \brief Seedable pseudo-random generator with independent streams
+      */
+    class RandomGenerator {
+    public:
+      /** \name Types definitions
+        @{
+        */
+      /// Type of the generated numbers
+      typedef uint64_t result_type;
+      /** @}
+        */
+
+      /** \name Constructors/destructor
+        @{
+        */
+      /// Constructs generator from seed and stream
+      RandomGenerator(uint64_t seed = 0, size_t stream = 0);
+      /// Copy constructor
+      RandomGenerator(const RandomGenerator& other);
+      /// Assignment operator
+      RandomGenerator& operator = (const RandomGenerator& other);
+      /// Destructor
+      virtual ~RandomGenerator();
+      /** @}
+        */
+
+      /** \name Accessors
+        @{
+        */
+      /// Sets the seed and the stream of the generator
+      void setSeed(uint64_t seed, size_t stream = 0);
+      /// Returns the seed of the generator
+      uint64_t getSeed() const;
+      /// Returns the stream of the generator
+      size_t getStream() const;
+      /// Returns the generator of the calling thread
+      static RandomGenerator& getInstance();
+      /// Sets the global seed, the thread generators are reseeded on next use
+      static void setGlobalSeed(uint64_t seed);
+      /// Returns the global seed
+      static uint64_t getGlobalSeed();
+      /// Sets the stream of the calling thread generator
+      static void setThreadStream(size_t stream);
+      /// Enables the thread generators for the Randomizer and distributions
+      static void setEnabled(bool enabled);
+      /// Checks if the thread generators are enabled
+      static bool isEnabled();
+      /// Returns the smallest generated number
+      static constexpr result_type min() {
+        return 0;
+      }
+      /// Returns the largest generated number
+      static constexpr result_type max() {
+        return UINT64_MAX;
+      }
+      /** @}
+        */
+
+      /** \name Methods
+        @{
+        */
+      /// Returns the next number
+      result_type operator()();
+      /// Advances the generator by 2^128 draws
+      void jump();
+      /// Returns a sample from a uniform distribution on [0, 1)
+      double sampleUniform();
+      /// Returns a sample from a standard normal distribution
+      double sampleNormal();
+      /** @}
+        */
+
+    protected:
+      /** \name Protected methods
+        @{
+        */
+      /// Samples from the normal tail beyond the ziggurat base
+      double sampleNormalTail(bool negative);
+      /** @}
+        */
+
+      /** \name Protected members
+        @{
+        */
+      /// State of the generator
+      uint64_t mState[4];
+      /// Seed of the generator
+      uint64_t mSeed;
+      /// Stream of the generator
+      size_t mStream;
+      /** @}
+        */
+
+    };
+
+  }
+}
+
+#endif // ASLAM_CALIBRATION_STATISTICS_RANDOM_GENERATOR_H
@@ -33,7 +33,8 @@ namespace aslam {
   namespace calibration {
 
     /** The Randomizer class implements random sampling from several
-        distributions
+        distributions. It samples from random() or, when they are enabled,
+        from the thread generators of RandomGenerator.
         \brief Random sampling from distributions
       */
     template <typename T = double, int M = 1> class Randomizer :
@@ -72,7 +73,7 @@ namespace aslam {
       /** \name Accessors
         @{
         */
-      /// Sets the seed of the random sampler
+      /// Sets the seed of random() and the global seed of RandomGenerator
       void setSeed(const T& seed);
       /// Returns the seed of the random sampler
       static T getSeed();
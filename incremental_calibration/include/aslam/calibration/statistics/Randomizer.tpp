@@ -18,6 +18,7 @@
 
 #include "aslam/calibration/base/Timestamp.h"
 #include "aslam/calibration/exceptions/BadArgumentException.h"
+#include "aslam/calibration/statistics/RandomGenerator.h"
 
 namespace aslam {
   namespace calibration {
@@ -77,6 +78,7 @@ namespace aslam {
     void Randomizer<T, M>::setSeed(const T& seed) {
       mSeed = seed;
       srandom(seed);
+      RandomGenerator::setGlobalSeed(seed);
     }
 
     template <typename T, int M>
@@ -103,8 +105,11 @@ namespace aslam {
           "Randomizer<T, M>::sampleUniform(): minimum support must be smaller "
           "than maximum support",
           __FILE__, __LINE__);
-      return minSupport + Traits::template round<T, true>(random() /
-        (double)RAND_MAX * (maxSupport - minSupport));
+      const double u = RandomGenerator::isEnabled() ?
+        RandomGenerator::getInstance().sampleUniform() :
+        random() / (double)RAND_MAX;
+      return minSupport + Traits::template round<T, true>(u *
+        (maxSupport - minSupport));
     }
 
     template <typename T, int M>
@@ -114,6 +119,9 @@ namespace aslam {
           "Randomizer<T, M>::sampleNormal(): "
           "variance must be strictly positive",
           __FILE__, __LINE__);
+      if (RandomGenerator::isEnabled())
+        return Traits::template round<T, true>(mean + sqrt(variance) *
+          RandomGenerator::getInstance().sampleNormal());
       double u, v, s;
       do {
         u = 2.0 * sampleUniform() - 1.0;
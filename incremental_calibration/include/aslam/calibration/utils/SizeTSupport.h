@@ -32,7 +32,8 @@ namespace Eigen {
   /** The NumTraits<size_t> structure defines support for size_t type in Eigen.
       \brief Eigen support for size_t
     */
-  template<> struct NumTraits<size_t> {
+  template<> struct NumTraits<size_t> :
+    GenericNumTraits<size_t> {
     /// Real definition
     typedef size_t Real;
     /// Floating point definition
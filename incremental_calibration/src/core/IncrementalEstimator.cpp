@@ -59,6 +59,7 @@ namespace aslam {
         _peakMemoryUsage(0),
         _memoryUsage(0),
         _numFlops(0.0),
+        _totalNumFlops(0.0),
         _initialCost(0.0),
         _finalCost(0.0) {
       // create linear solver and trust region policy for the optimizer
@@ -85,6 +86,7 @@ namespace aslam {
         _peakMemoryUsage(0),
         _memoryUsage(0),
         _numFlops(0.0),
+        _totalNumFlops(0.0),
         _initialCost(0.0),
         _finalCost(0.0) {
       // create the optimizer, linear solver, and trust region policy
@@ -192,6 +194,10 @@ namespace aslam {
       return _numFlops;
     }
 
+    double IncrementalEstimator::getTotalNumFlops() const {
+      return _totalNumFlops;
+    }
+
     const Eigen::MatrixXd& IncrementalEstimator::getNobsBasis(bool scaled)
         const {
       if (scaled)
@@ -299,6 +305,7 @@ namespace aslam {
       _peakMemoryUsage = linearSolver->getPeakMemoryUsage();
       _memoryUsage = linearSolver->getMemoryUsage();
       _numFlops = linearSolver->getNumFlops();
+      _totalNumFlops += _numFlops;
       _initialCost = srv.JStart;
       _finalCost = srv.JFinal;
 
@@ -395,6 +402,7 @@ namespace aslam {
       ret.sigma2Theta = linearSolver->getCovariance();
       ret.sigma2ThetaObs = linearSolver->getRowSpaceCovariance();
       ret.singularValues = linearSolver->getSingularValues();
+      _totalNumFlops += linearSolver->getNumFlops();
 
       // check if the solution is valid
       bool solutionValid = true;
@@ -142,22 +142,33 @@ namespace aslam {
     }
 
     void OptimizationProblem::addErrorTerm(const ErrorTermSP& errorTerm) {
-      if (!errorTerm)
-        throw NullPointerException("errorTerm", __FILE__, __LINE__,
-          __PRETTY_FUNCTION__);
-      if (isErrorTermInProblem(errorTerm.get()))
-        throw InvalidOperationException("error term already included",
-          __FILE__, __LINE__, __PRETTY_FUNCTION__);
-      const size_t numDV = errorTerm->numDesignVariables();
-      for (size_t i = 0; i < numDV; ++i) {
-        const DesignVariable* dv = errorTerm->designVariable(i);
-        if (!isDesignVariableInProblem(dv))
-          throw InvalidOperationException(
-            "error term contains a design variable not in the problem",
+      addErrorTerms(ErrorTermsSP(1, errorTerm));
+    }
+
+    void OptimizationProblem::addErrorTerms(const ErrorTermsSP& errorTerms) {
+      ErrorTermsP batchLookup;
+      batchLookup.reserve(errorTerms.size());
+      for (auto it = errorTerms.cbegin(); it != errorTerms.cend(); ++it) {
+        if (!*it)
+          throw NullPointerException("errorTerm", __FILE__, __LINE__,
+            __PRETTY_FUNCTION__);
+        if (isErrorTermInProblem(it->get()) ||
+            !batchLookup.insert(it->get()).second)
+          throw InvalidOperationException("error term already included",
             __FILE__, __LINE__, __PRETTY_FUNCTION__);
+        const size_t numDV = (*it)->numDesignVariables();
+        for (size_t i = 0; i < numDV; ++i) {
+          const DesignVariable* dv = (*it)->designVariable(i);
+          if (!isDesignVariableInProblem(dv))
+            throw InvalidOperationException(
+              "error term contains a design variable not in the problem",
+              __FILE__, __LINE__, __PRETTY_FUNCTION__);
+        }
       }
-      _errorTermsLookup.insert(errorTerm.get());
-      _errorTerms.push_back(errorTerm);
+      _errorTermsLookup.reserve(_errorTermsLookup.size() + errorTerms.size());
+      _errorTermsLookup.insert(batchLookup.begin(), batchLookup.end());
+      _errorTerms.insert(_errorTerms.end(), errorTerms.begin(),
+        errorTerms.end());
     }
 
     bool OptimizationProblem::
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "aslam/calibration/functions/GammaFunctionTable.h"
+
+#include <cmath>
+
+#include <vector>
+
+#include <boost/math/special_functions/digamma.hpp>
+
+namespace aslam {
+  namespace calibration {
+
+    namespace {
+
+      /// Tables of log-gamma and digamma at half the index
+      struct Tables {
+        Tables() :
+            logGamma(GammaFunctionTable::maxDoubledArgument + 1),
+            digamma(GammaFunctionTable::maxDoubledArgument + 1) {
+          for (size_t k = 1; k <= GammaFunctionTable::maxDoubledArgument;
+              ++k) {
+            logGamma[k] = lgamma(0.5 * k);
+            digamma[k] = boost::math::digamma(0.5 * k);
+          }
+        }
+        /// Log-gamma values
+        std::vector<double> logGamma;
+        /// Digamma values
+        std::vector<double> digamma;
+      };
+
+      /// Returns the tables, built on first use
+      const Tables& getTables() {
+        static const Tables tables;
+        return tables;
+      }
+
+    }
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    double GammaFunctionTable::getLogGamma(size_t doubledArgument) {
+      return getTables().logGamma[doubledArgument];
+    }
+
+    double GammaFunctionTable::getDigamma(size_t doubledArgument) {
+      return getTables().digamma[doubledArgument];
+    }
+
+    bool GammaFunctionTable::lookupLogGamma(double argument, double& value) {
+      const size_t doubledArgument = getDoubledArgument(argument);
+      if (!doubledArgument)
+        return false;
+      value = getLogGamma(doubledArgument);
+      return true;
+    }
+
+    bool GammaFunctionTable::lookupDigamma(double argument, double& value) {
+      const size_t doubledArgument = getDoubledArgument(argument);
+      if (!doubledArgument)
+        return false;
+      value = getDigamma(doubledArgument);
+      return true;
+    }
+
+    double GammaFunctionTable::logGamma(double argument) {
+      double value;
+      return lookupLogGamma(argument, value) ? value : lgamma(argument);
+    }
+
+    double GammaFunctionTable::digamma(double argument) {
+      double value;
+      return lookupDigamma(argument, value) ? value :
+        boost::math::digamma(argument);
+    }
+
+    size_t GammaFunctionTable::getDoubledArgument(double argument) {
+      const double doubledArgument = 2.0 * argument;
+      if (doubledArgument >= 1 && doubledArgument <= maxDoubledArgument &&
+          doubledArgument == floor(doubledArgument))
+        return doubledArgument;
+      else
+        return 0;
+    }
+
+  }
+}
@@ -18,8 +18,14 @@
 
 #include "aslam/calibration/functions/IncompleteGammaPFunction.h"
 
+#include <cmath>
+
+#include <limits>
+
 #include <boost/math/special_functions/gamma.hpp>
 
+#include "aslam/calibration/functions/GammaFunctionTable.h"
+
 namespace aslam {
   namespace calibration {
 
@@ -73,6 +79,16 @@ namespace aslam {
       return boost::math::gamma_p(mAlpha, argument);
     }
 
+    Eigen::ArrayXd IncompleteGammaPFunction::getValues(const Eigen::ArrayXd&
+        arguments) const {
+      const double logGammaAlpha = GammaFunctionTable::logGamma(mAlpha);
+      Eigen::ArrayXd values(arguments.size());
+      double q;
+      for (size_t i = 0; i < static_cast<size_t>(arguments.size()); ++i)
+        evaluate(mAlpha, logGammaAlpha, arguments(i), values(i), q);
+      return values;
+    }
+
     double IncompleteGammaPFunction::getAlpha() const {
       return mAlpha;
     }
@@ -81,5 +97,64 @@ namespace aslam {
       mAlpha = alpha;
     }
 
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    void IncompleteGammaPFunction::evaluate(double alpha, double logGammaAlpha,
+        double x, double& p, double& q) {
+      const size_t maxIterations = 1000;
+      const double epsilon = std::numeric_limits<double>::epsilon();
+      const double tiny = std::numeric_limits<double>::min() / epsilon;
+      if (x <= 0) {
+        p = 0.0;
+        q = 1.0;
+        return;
+      }
+      const double logPrefix = alpha * log(x) - x - logGammaAlpha;
+      if (x < alpha + 1) {
+        double a = alpha;
+        double term = 1.0 / alpha;
+        double sum = term;
+        for (size_t i = 0; i < maxIterations; ++i) {
+          a += 1.0;
+          term *= x / a;
+          sum += term;
+          if (fabs(term) < fabs(sum) * epsilon) {
+            p = sum * exp(logPrefix);
+            q = 1.0 - p;
+            return;
+          }
+        }
+      }
+      else {
+        // modified Lentz evaluation of the continued fraction
+        double b = x + 1.0 - alpha;
+        double c = 1.0 / tiny;
+        double d = 1.0 / b;
+        double h = d;
+        for (size_t i = 1; i <= maxIterations; ++i) {
+          const double a = -(i * (i - alpha));
+          b += 2.0;
+          d = a * d + b;
+          if (fabs(d) < tiny)
+            d = tiny;
+          c = b + a / c;
+          if (fabs(c) < tiny)
+            c = tiny;
+          d = 1.0 / d;
+          const double delta = d * c;
+          h *= delta;
+          if (fabs(delta - 1.0) < epsilon) {
+            q = exp(logPrefix) * h;
+            p = 1.0 - q;
+            return;
+          }
+        }
+      }
+      p = boost::math::gamma_p(alpha, x);
+      q = boost::math::gamma_q(alpha, x);
+    }
+
   }
 }
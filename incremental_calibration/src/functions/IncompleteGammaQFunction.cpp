@@ -20,6 +20,9 @@
 
 #include <boost/math/special_functions/gamma.hpp>
 
+#include "aslam/calibration/functions/IncompleteGammaPFunction.h"
+#include "aslam/calibration/functions/GammaFunctionTable.h"
+
 namespace aslam {
   namespace calibration {
 
@@ -73,6 +76,17 @@ namespace aslam {
       return boost::math::gamma_q(mAlpha, argument);
     }
 
+    Eigen::ArrayXd IncompleteGammaQFunction::getValues(const Eigen::ArrayXd&
+        arguments) const {
+      const double logGammaAlpha = GammaFunctionTable::logGamma(mAlpha);
+      Eigen::ArrayXd values(arguments.size());
+      double p;
+      for (size_t i = 0; i < static_cast<size_t>(arguments.size()); ++i)
+        IncompleteGammaPFunction::evaluate(mAlpha, logGammaAlpha, arguments(i),
+          p, values(i));
+      return values;
+    }
+
     double IncompleteGammaQFunction::getAlpha() const {
       return mAlpha;
     }
@@ -20,6 +20,8 @@
 
 #include <cmath>
 
+#include "aslam/calibration/functions/GammaFunctionTable.h"
+
 namespace aslam {
   namespace calibration {
 
@@ -38,14 +40,18 @@ namespace aslam {
 /******************************************************************************/
 
     double LogFactorialFunction::getValue(const VariableType& argument) const {
-      if (argument) {
-        double value = 0.0;
-        for (size_t x = 1; x < argument; ++x)
-          value += log(x + 1);
-        return value;
-      }
+      if (2 * (argument + 1) <= GammaFunctionTable::maxDoubledArgument)
+        return GammaFunctionTable::getLogGamma(2 * (argument + 1));
       else
-        return 0.0;
+        return lgamma(argument + 1.0);
+    }
+
+    Eigen::ArrayXd LogFactorialFunction::getValues(const Eigen::Array<
+        VariableType, Eigen::Dynamic, 1>& arguments) const {
+      Eigen::ArrayXd values(arguments.size());
+      for (size_t i = 0; i < static_cast<size_t>(arguments.size()); ++i)
+        values(i) = getValue(arguments(i));
+      return values;
     }
 
   }
@@ -18,6 +18,11 @@
 
 #include "aslam/calibration/statistics/ChiSquareDistribution.h"
 
+#include <map>
+#include <utility>
+
+#include <boost/thread/mutex.hpp>
+
 namespace aslam {
   namespace calibration {
 
@@ -78,5 +83,22 @@ namespace aslam {
       return getDegrees() * pow(1.0 - 2.0 / (9 * getDegrees()), 3);
     }
 
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    double ChiSquareDistribution::getQuantile(double degrees, double
+        probability) {
+      static std::map<std::pair<double, double>, double> quantiles;
+      static boost::mutex mutex;
+      const std::pair<double, double> key(degrees, probability);
+      boost::mutex::scoped_lock lock(mutex);
+      auto it = quantiles.find(key);
+      if (it == quantiles.end())
+        it = quantiles.insert(std::make_pair(key,
+          ChiSquareDistribution(degrees).invcdf(probability))).first;
+      return it->second;
+    }
+
   }
 }
@@ -19,6 +19,7 @@
 #include "aslam/calibration/statistics/NormalDistribution.h"
 
 #include "aslam/calibration/statistics/Randomizer.h"
+#include "aslam/calibration/statistics/RandomGenerator.h"
 #include "aslam/calibration/exceptions/BadArgumentException.h"
 
 namespace aslam {
@@ -140,6 +141,22 @@ namespace aslam {
       return randomizer.sampleNormal(mMean, mVariance);
     }
 
+    void NormalDistribution<1>::getSamples(Eigen::VectorXd& samples, size_t
+        numSamples) const {
+      samples.resize(numSamples);
+      if (RandomGenerator::isEnabled()) {
+        RandomGenerator& generator = RandomGenerator::getInstance();
+        for (size_t i = 0; i < numSamples; ++i)
+          samples(i) = generator.sampleNormal();
+      }
+      else {
+        const static Randomizer<double> randomizer;
+        for (size_t i = 0; i < numSamples; ++i)
+          samples(i) = randomizer.sampleNormal();
+      }
+      samples = (samples.array() * sqrt(mVariance) + mMean).matrix();
+    }
+
     double NormalDistribution<1>::KLDivergence(const NormalDistribution<1>&
         other) const {
       return 0.5 * (log(other.mVariance * mPrecision) +
@@ -0,0 +1,281 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "aslam/calibration/statistics/RandomGenerator.h"
+
+#include <cmath>
+
+#include <atomic>
+
+#include "aslam/calibration/base/Timestamp.h"
+
+namespace aslam {
+  namespace calibration {
+
+    namespace {
+
+      /// Number of blocks of the ziggurat
+      const size_t zigguratBlocks = 128;
+      /// Start of the tail of the ziggurat
+      const double zigguratR = 3.442619855899;
+      /// Area of a block of the ziggurat
+      const double zigguratV = 9.91256303526217e-3;
+      /// Scale of a 53-bit integer to [0, 1)
+      const double uniformScale = 1.0 / 9007199254740992.0;
+
+      /// Ziggurat tables of Doornik for the standard normal distribution
+      struct ZigguratTables {
+        ZigguratTables() {
+          double f = exp(-0.5 * zigguratR * zigguratR);
+          x[0] = zigguratV / f;
+          x[1] = zigguratR;
+          x[zigguratBlocks] = 0;
+          for (size_t i = 2; i < zigguratBlocks; ++i) {
+            x[i] = sqrt(-2.0 * log(zigguratV / x[i - 1] + f));
+            f = exp(-0.5 * x[i] * x[i]);
+          }
+          for (size_t i = 0; i < zigguratBlocks; ++i)
+            r[i] = x[i + 1] / x[i];
+        }
+        /// Right edges of the blocks
+        double x[zigguratBlocks + 1];
+        /// Ratios of the right edges of consecutive blocks
+        double r[zigguratBlocks];
+      };
+
+      /// Returns the ziggurat tables
+      const ZigguratTables& getZigguratTables() {
+        static const ZigguratTables tables;
+        return tables;
+      }
+
+      /// State shared by the thread generators
+      struct GlobalState {
+        GlobalState() :
+            seed(Timestamp::now() * 1e6),
+            epoch(0),
+            numStreams(0),
+            enabled(false) {
+        }
+        /// Global seed
+        std::atomic<uint64_t> seed;
+        /// Incremented on each change of the global seed
+        std::atomic<size_t> epoch;
+        /// Number of streams assigned to threads
+        std::atomic<size_t> numStreams;
+        /// Thread generators enabled
+        std::atomic<bool> enabled;
+      };
+
+      /// Returns the state shared by the thread generators
+      GlobalState& getGlobalState() {
+        static GlobalState state;
+        return state;
+      }
+
+      /// Generator of a thread
+      struct ThreadGenerator {
+        ThreadGenerator() :
+            stream(getGlobalState().numStreams++),
+            epoch(getGlobalState().epoch),
+            generator(getGlobalState().seed, stream) {
+        }
+        /// Stream of the thread
+        size_t stream;
+        /// Epoch of the global seed used for seeding
+        size_t epoch;
+        /// Generator
+        RandomGenerator generator;
+      };
+
+      /// Returns the generator of the calling thread
+      ThreadGenerator& getThreadGenerator() {
+        static thread_local ThreadGenerator generator;
+        return generator;
+      }
+
+      /// Rotates left
+      inline uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+      }
+
+      /// Returns the next number of a splitmix64 sequence
+      inline uint64_t splitMix64(uint64_t& x) {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+      }
+
+    }
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+    RandomGenerator::RandomGenerator(uint64_t seed, size_t stream) {
+      setSeed(seed, stream);
+    }
+
+    RandomGenerator::RandomGenerator(const RandomGenerator& other) :
+        mSeed(other.mSeed),
+        mStream(other.mStream) {
+      for (size_t i = 0; i < 4; ++i)
+        mState[i] = other.mState[i];
+    }
+
+    RandomGenerator& RandomGenerator::operator = (const RandomGenerator&
+        other) {
+      if (this != &other) {
+        for (size_t i = 0; i < 4; ++i)
+          mState[i] = other.mState[i];
+        mSeed = other.mSeed;
+        mStream = other.mStream;
+      }
+      return *this;
+    }
+
+    RandomGenerator::~RandomGenerator() {
+    }
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+    void RandomGenerator::setSeed(uint64_t seed, size_t stream) {
+      mSeed = seed;
+      mStream = stream;
+      uint64_t x = seed;
+      for (size_t i = 0; i < 4; ++i)
+        mState[i] = splitMix64(x);
+      for (size_t i = 0; i < stream; ++i)
+        jump();
+    }
+
+    uint64_t RandomGenerator::getSeed() const {
+      return mSeed;
+    }
+
+    size_t RandomGenerator::getStream() const {
+      return mStream;
+    }
+
+    RandomGenerator& RandomGenerator::getInstance() {
+      ThreadGenerator& thread = getThreadGenerator();
+      const GlobalState& global = getGlobalState();
+      const size_t epoch = global.epoch;
+      if (thread.epoch != epoch) {
+        thread.generator.setSeed(global.seed, thread.stream);
+        thread.epoch = epoch;
+      }
+      return thread.generator;
+    }
+
+    void RandomGenerator::setGlobalSeed(uint64_t seed) {
+      GlobalState& global = getGlobalState();
+      global.seed = seed;
+      global.epoch++;
+    }
+
+    uint64_t RandomGenerator::getGlobalSeed() {
+      return getGlobalState().seed;
+    }
+
+    void RandomGenerator::setThreadStream(size_t stream) {
+      ThreadGenerator& thread = getThreadGenerator();
+      const GlobalState& global = getGlobalState();
+      thread.stream = stream;
+      thread.epoch = global.epoch;
+      thread.generator.setSeed(global.seed, stream);
+    }
+
+    void RandomGenerator::setEnabled(bool enabled) {
+      getGlobalState().enabled = enabled;
+    }
+
+    bool RandomGenerator::isEnabled() {
+      return getGlobalState().enabled;
+    }
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    RandomGenerator::result_type RandomGenerator::operator()() {
+      const uint64_t result = rotl(mState[1] * 5, 7) * 9;
+      const uint64_t t = mState[1] << 17;
+      mState[2] ^= mState[0];
+      mState[3] ^= mState[1];
+      mState[1] ^= mState[2];
+      mState[0] ^= mState[3];
+      mState[2] ^= t;
+      mState[3] = rotl(mState[3], 45);
+      return result;
+    }
+
+    void RandomGenerator::jump() {
+      static const uint64_t jumpPolynomial[] = {0x180ec6d33cfd0abaULL,
+        0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+      uint64_t state[4] = {0, 0, 0, 0};
+      for (size_t i = 0; i < 4; ++i)
+        for (size_t b = 0; b < 64; ++b) {
+          if (jumpPolynomial[i] & (1ULL << b))
+            for (size_t j = 0; j < 4; ++j)
+              state[j] ^= mState[j];
+          (*this)();
+        }
+      for (size_t i = 0; i < 4; ++i)
+        mState[i] = state[i];
+    }
+
+    double RandomGenerator::sampleUniform() {
+      return ((*this)() >> 11) * uniformScale;
+    }
+
+    double RandomGenerator::sampleNormal() {
+      const ZigguratTables& tables = getZigguratTables();
+      while (true) {
+        // the low bits select the block, the high bits the abscissa
+        const uint64_t bits = (*this)();
+        const size_t i = bits & (zigguratBlocks - 1);
+        const double u = 2.0 * ((bits >> 11) * uniformScale) - 1.0;
+        if (fabs(u) < tables.r[i])
+          return u * tables.x[i];
+        if (i == 0)
+          return sampleNormalTail(u < 0);
+        const double x = u * tables.x[i];
+        const double f0 = exp(-0.5 * (tables.x[i] * tables.x[i] - x * x));
+        const double f1 = exp(-0.5 * (tables.x[i + 1] * tables.x[i + 1] -
+          x * x));
+        if (f1 + sampleUniform() * (f0 - f1) < 1.0)
+          return x;
+      }
+    }
+
+    double RandomGenerator::sampleNormalTail(bool negative) {
+      double x, y;
+      do {
+        x = log(1.0 - sampleUniform()) / zigguratR;
+        y = log(1.0 - sampleUniform());
+      }
+      while (-2.0 * y < x * x);
+      return negative ? x - zigguratR : zigguratR - x;
+    }
+
+  }
+}
@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file EstimatorMLNormalTest.cpp
+    \brief This file tests the EstimatorML class for normal distributions.
+  */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "aslam/calibration/statistics/EstimatorML.h"
+#include "aslam/calibration/statistics/NormalDistribution.h"
+
+TEST(AslamCalibrationTestSuite, testEstimatorMLNormalMv) {
+  // Points far from the origin challenge the sum of squares formula
+  Eigen::Matrix2d covariance;
+  covariance << 1.0, 0.3, 0.3, 0.5;
+  const Eigen::Vector2d offset(1e6, -1e6);
+  std::vector<Eigen::Vector2d> points;
+  aslam::calibration::NormalDistribution<2>(offset, covariance).getSamples(
+    points, 1000);
+
+  // Reference two-pass estimates
+  Eigen::Vector2d mean = Eigen::Vector2d::Zero();
+  for (auto it = points.cbegin(); it != points.cend(); ++it)
+    mean += *it;
+  mean /= double(points.size());
+  Eigen::Matrix2d scatter = Eigen::Matrix2d::Zero();
+  for (auto it = points.cbegin(); it != points.cend(); ++it)
+    scatter += (*it - mean) * (*it - mean).transpose();
+
+  // Streaming estimator
+  aslam::calibration::EstimatorML<aslam::calibration::NormalDistribution<2> >
+    estimator;
+  ASSERT_FALSE(estimator.getValid());
+  estimator.addPoint(points.front());
+  ASSERT_FALSE(estimator.getValid());
+  estimator.addPoints(points.cbegin() + 1, points.cend());
+  ASSERT_EQ(estimator.getNumPoints(), points.size());
+  ASSERT_TRUE(estimator.getValid());
+  ASSERT_EQ(estimator.getScatter(), estimator.getScatter().transpose());
+  ASSERT_TRUE((estimator.getDistribution().getMean() - mean).norm() < 1e-6);
+  ASSERT_TRUE((estimator.getDistribution().getCovariance() -
+    scatter / double(points.size())).norm() < 1e-6);
+
+  // Merged partial estimators
+  aslam::calibration::EstimatorML<aslam::calibration::NormalDistribution<2> >
+    first, second, empty;
+  first.addPoints(points.cbegin(), points.cbegin() + 300);
+  second.addPoints(points.cbegin() + 300, points.cend());
+  first.merge(second);
+  first.merge(empty);
+  ASSERT_EQ(first.getNumPoints(), points.size());
+  ASSERT_TRUE((first.getMean() - mean).norm() < 1e-6);
+  ASSERT_TRUE((first.getScatter() - scatter).norm() < 1e-6);
+  empty.merge(first);
+  ASSERT_TRUE((empty.getDistribution().getCovariance() -
+    scatter / double(points.size())).norm() < 1e-6);
+
+  // Reset
+  estimator.reset();
+  ASSERT_EQ(estimator.getNumPoints(), 0);
+  ASSERT_FALSE(estimator.getValid());
+  ASSERT_EQ(estimator.getMean(), Eigen::Vector2d::Zero());
+  ASSERT_EQ(estimator.getScatter(), Eigen::Matrix2d::Zero());
+  ASSERT_EQ(estimator.getDistribution().getMean(), Eigen::Vector2d::Zero());
+  ASSERT_EQ(estimator.getDistribution().getCovariance(),
+    Eigen::Matrix2d::Identity());
+}
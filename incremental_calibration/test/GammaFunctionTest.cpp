@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file GammaFunctionTest.cpp
+    \brief This file tests the gamma-family functions.
+  */
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include <boost/math/special_functions/gamma.hpp>
+#include <boost/math/special_functions/digamma.hpp>
+
+#include "aslam/calibration/functions/GammaFunctionTable.h"
+#include "aslam/calibration/functions/LogGammaFunction.h"
+#include "aslam/calibration/functions/LogFactorialFunction.h"
+#include "aslam/calibration/functions/DigammaFunction.h"
+#include "aslam/calibration/functions/IncompleteGammaPFunction.h"
+#include "aslam/calibration/functions/IncompleteGammaQFunction.h"
+#include "aslam/calibration/statistics/ChiSquareDistribution.h"
+
+using namespace aslam::calibration;
+
+TEST(AslamCalibrationTestSuite, testGammaFunctionTable) {
+  // Tabulated values at integer and half-integer arguments
+  double value;
+  ASSERT_TRUE(GammaFunctionTable::lookupLogGamma(0.5, value));
+  ASSERT_NEAR(value, 0.5 * log(M_PI), 1e-14);
+  ASSERT_TRUE(GammaFunctionTable::lookupLogGamma(7.0, value));
+  ASSERT_NEAR(value, log(720.0), 1e-12);
+  ASSERT_TRUE(GammaFunctionTable::lookupDigamma(1.0, value));
+  ASSERT_NEAR(value, -0.5772156649015329, 1e-14);
+  ASSERT_FALSE(GammaFunctionTable::lookupLogGamma(0.3, value));
+  ASSERT_FALSE(GammaFunctionTable::lookupLogGamma(0.0, value));
+  ASSERT_FALSE(GammaFunctionTable::lookupDigamma(
+    GammaFunctionTable::maxDoubledArgument, value));
+  ASSERT_NEAR(GammaFunctionTable::logGamma(2.3), lgamma(2.3), 1e-14);
+  ASSERT_NEAR(GammaFunctionTable::digamma(2.3), boost::math::digamma(2.3),
+    1e-14);
+
+  // Functions use the tables and agree with their definitions
+  const LogFactorialFunction logFactorial;
+  double logFactorialValue = 0.0;
+  for (size_t n = 1; n < 2000; ++n) {
+    logFactorialValue += log(n);
+    ASSERT_NEAR(logFactorial(n), logFactorialValue,
+      1e-12 * logFactorialValue);
+  }
+  ASSERT_EQ(logFactorial(0), 0.0);
+  const LogGammaFunction<double> logGamma(2);
+  ASSERT_NEAR(logGamma(3.5), lgamma(3.5) + lgamma(3.0) + 0.5 * log(M_PI),
+    1e-12);
+  Eigen::Array<size_t, Eigen::Dynamic, 1> integers(3);
+  integers << 0, 5, 3000;
+  const Eigen::ArrayXd logFactorials = logFactorial.getValues(integers);
+  for (size_t i = 0; i < 3; ++i)
+    ASSERT_EQ(logFactorials(i), logFactorial(integers(i)));
+  const DigammaFunction<double> digamma;
+  Eigen::ArrayXd reals(3);
+  reals << 0.5, 4.25, 10.0;
+  const Eigen::ArrayXd digammas = digamma.getValues(reals);
+  for (size_t i = 0; i < 3; ++i)
+    ASSERT_NEAR(digammas(i), boost::math::digamma(reals(i)), 1e-14);
+}
+
+TEST(AslamCalibrationTestSuite, testIncompleteGammaBatch) {
+  const double alphas[] = {0.5, 1.0, 2.5, 10.0, 150.0};
+  Eigen::ArrayXd x = Eigen::ArrayXd::LinSpaced(400, 0.0, 300.0);
+  for (size_t i = 0; i < sizeof(alphas) / sizeof(alphas[0]); ++i) {
+    const IncompleteGammaPFunction p(alphas[i]);
+    const IncompleteGammaQFunction q(alphas[i]);
+    const Eigen::ArrayXd pValues = p.getValues(x);
+    const Eigen::ArrayXd qValues = q.getValues(x);
+    for (size_t j = 0; j < static_cast<size_t>(x.size()); ++j) {
+      ASSERT_NEAR(pValues(j), p(x(j)), 1e-12);
+      ASSERT_NEAR(qValues(j), q(x(j)), 1e-12);
+    }
+  }
+}
+
+TEST(AslamCalibrationTestSuite, testChiSquareBatch) {
+  const ChiSquareDistribution chiSquare(2);
+  const Eigen::ArrayXd values = Eigen::ArrayXd::LinSpaced(100, 0.0, 20.0);
+  const Eigen::ArrayXd cdfs = chiSquare.cdfs(values);
+  for (size_t i = 0; i < static_cast<size_t>(values.size()); ++i)
+    ASSERT_NEAR(cdfs(i), chiSquare.cdf(values(i)), 1e-12);
+
+  // Cached quantiles are the inverse of the cumulative density function
+  const double q = ChiSquareDistribution::getQuantile(2, 0.975);
+  ASSERT_NEAR(q, -2.0 * log(0.025), 1e-9);
+  ASSERT_EQ(ChiSquareDistribution::getQuantile(2, 0.975), q);
+  ASSERT_NEAR(ChiSquareDistribution(3).cdf(
+    ChiSquareDistribution::getQuantile(3, 0.99)), 0.99, 1e-9);
+}
@@ -0,0 +1,158 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file GridTest.cpp
+    \brief This file tests the Grid class.
+  */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "aslam/calibration/data-structures/Grid.h"
+#include "aslam/calibration/data-structures/MappedGrid.h"
+#include "aslam/calibration/data-structures/SparseGrid.h"
+#include "aslam/calibration/statistics/Histogram.h"
+#include "aslam/calibration/statistics/NormalDistribution.h"
+#include "aslam/calibration/exceptions/InvalidOperationException.h"
+
+TEST(AslamCalibrationTestSuite, testGrid) {
+  typedef aslam::calibration::Grid<double, size_t, 3> Grid3d;
+  Grid3d grid(Eigen::Vector3d(-1.0, 0.0, 2.0), Eigen::Vector3d(1.0, 3.0, 2.5),
+    Eigen::Vector3d(0.5, 0.25, 0.1));
+  size_t value = 0;
+  for (auto it = grid.getCellBegin(); it != grid.getCellEnd(); ++it)
+    *it = value++;
+
+  // Binary round trip
+  std::stringstream binary;
+  grid.writeBinary(binary);
+  ASSERT_EQ(binary.str().size(), Grid3d::getBinaryCellOffset(3) +
+    sizeof(size_t) * grid.getNumCellsTot());
+  Grid3d binaryGrid(Eigen::Vector3d::Zero(), Eigen::Vector3d::Ones(),
+    Eigen::Vector3d::Ones());
+  binaryGrid.readBinary(binary);
+  ASSERT_EQ(binaryGrid.getMinimum(), grid.getMinimum());
+  ASSERT_EQ(binaryGrid.getMaximum(), grid.getMaximum());
+  ASSERT_EQ(binaryGrid.getResolution(), grid.getResolution());
+  ASSERT_EQ(binaryGrid.getNumCells(), grid.getNumCells());
+  ASSERT_EQ(binaryGrid.getCells(), grid.getCells());
+
+  // Text round trip
+  std::stringstream text;
+  text << grid;
+  Grid3d textGrid(Eigen::Vector3d::Zero(), Eigen::Vector3d::Ones(),
+    Eigen::Vector3d::Ones());
+  text >> textGrid;
+  ASSERT_EQ(textGrid.getNumCells(), grid.getNumCells());
+  ASSERT_EQ(textGrid.getCells(), grid.getCells());
+
+  // Mismatching types and corrupted streams are rejected
+  std::stringstream wrongType(binary.str());
+  aslam::calibration::Grid<double, float, 3> floatGrid(
+    Eigen::Vector3d::Zero(), Eigen::Vector3d::Ones(), Eigen::Vector3d::Ones());
+  ASSERT_THROW(floatGrid.readBinary(wrongType),
+    aslam::calibration::InvalidOperationException);
+  std::stringstream truncated(binary.str().substr(0,
+    binary.str().size() - 1));
+  ASSERT_THROW(binaryGrid.readBinary(truncated),
+    aslam::calibration::InvalidOperationException);
+}
+
+TEST(AslamCalibrationTestSuite, testMappedHistogram) {
+  typedef aslam::calibration::Histogram<double, 2> Histogram2d;
+  Histogram2d histogram(Eigen::Vector2d(-5.0, -5.0), Eigen::Vector2d(5.0, 5.0),
+    Eigen::Vector2d(0.25, 0.5));
+  std::vector<Eigen::Vector2d> samples;
+  Eigen::Matrix2d covariance;
+  covariance << 1.0, 0.4, 0.4, 2.0;
+  aslam::calibration::NormalDistribution<2>(Eigen::Vector2d(0.5, -0.5),
+    covariance).getSamples(samples, 10000);
+  histogram.addSamples(samples);
+
+  // Files are written in binary format
+  const std::string filename = "testMappedHistogram.bin";
+  {
+    std::ofstream file(filename.c_str(), std::ios::binary);
+    file << histogram;
+  }
+  Histogram2d loaded;
+  {
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    file >> loaded;
+  }
+  ASSERT_EQ(loaded.getCells(), histogram.getCells());
+
+  // The mapped histogram shares the cells of the file
+  {
+    Histogram2d::Mapped mapped(filename);
+    ASSERT_EQ(mapped.getNumCells(), histogram.getNumCells());
+    ASSERT_EQ(reinterpret_cast<size_t>(mapped.getCells()) %
+      Histogram2d::binaryAlignment, 0);
+    ASSERT_TRUE(std::equal(mapped.getCellBegin(), mapped.getCellEnd(),
+      histogram.getCellBegin()));
+    ASSERT_EQ(mapped(samples[0]), histogram(samples[0]));
+    ASSERT_EQ(Histogram2d::computeSum(mapped), histogram.getSum());
+    ASSERT_EQ(Histogram2d::computeMean(mapped), histogram.getMean());
+    ASSERT_EQ(Histogram2d::computeMode(mapped), histogram.getMode());
+    ASSERT_EQ(Histogram2d::computeCovariance(mapped),
+      histogram.getCovariance());
+    ASSERT_EQ(mapped.getGrid().getCells(), histogram.getCells());
+  }
+  typedef aslam::calibration::MappedGrid<double, double, 3> MappedGrid3d;
+  ASSERT_THROW(MappedGrid3d mapped(filename),
+    aslam::calibration::InvalidOperationException);
+  std::remove(filename.c_str());
+}
+
+TEST(AslamCalibrationTestSuite, testSparseGrid) {
+  typedef aslam::calibration::Grid<double, size_t, 3> Grid3d;
+  typedef aslam::calibration::SparseGrid<double, size_t, 3> SparseGrid3d;
+  const Eigen::Vector3d minimum(-1.0, 0.0, 2.0), maximum(1.0, 3.0, 2.5),
+    resolution(0.5, 0.25, 0.1);
+  Grid3d grid(minimum, maximum, resolution);
+  SparseGrid3d sparse(minimum, maximum, resolution);
+  ASSERT_EQ(sparse.getNumCells(), grid.getNumCells());
+  ASSERT_EQ(sparse.getNumCellsTot(), grid.getNumCellsTot());
+  ASSERT_EQ(sparse.getNumOccupiedCells(), 0);
+
+  // Same coordinate and index API as the dense grid
+  const Eigen::Vector3d points[] = {Eigen::Vector3d(0.1, 1.2, 2.33),
+    Eigen::Vector3d(-1.0, 3.0, 2.5), Eigen::Vector3d(0.1, 1.2, 2.34)};
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(sparse.getIndex(points[i]), grid.getIndex(points[i]));
+    ASSERT_EQ(sparse.getCoordinates(sparse.getIndex(points[i])),
+      grid.getCoordinates(grid.getIndex(points[i])));
+    sparse(points[i])++;
+    grid(points[i])++;
+  }
+  ASSERT_FALSE(sparse.isInRange(Eigen::Vector3d(2.0, 0.0, 2.0)));
+  ASSERT_EQ(sparse.getNumOccupiedCells(), 2);
+  ASSERT_EQ(sparse(points[0]), 2);
+  ASSERT_TRUE(sparse.isOccupied(sparse.getIndex(points[1])));
+  const SparseGrid3d& constSparse = sparse;
+  ASSERT_EQ(constSparse[Grid3d::Index(1, 1, 1)], 0);
+  ASSERT_EQ(sparse.getNumOccupiedCells(), 2);
+  for (auto it = sparse.getCellBegin(); it != sparse.getCellEnd(); ++it)
+    ASSERT_EQ(it->second, grid.getCells()[it->first]);
+  sparse.reset();
+  ASSERT_EQ(sparse.getNumOccupiedCells(), 0);
+}
@@ -0,0 +1,111 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file HistogramTest.cpp
+    \brief This file tests the Histogram class.
+  */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "aslam/calibration/statistics/Histogram.h"
+#include "aslam/calibration/statistics/NormalDistribution.h"
+#include "aslam/calibration/exceptions/BadArgumentException.h"
+
+TEST(AslamCalibrationTestSuite, testHistogramMv) {
+  typedef aslam::calibration::Histogram<double, 2> Histogram2d;
+  const Eigen::Vector2d min(-5.0, -5.0), max(5.0, 5.0), binSize(0.25, 0.5);
+  std::vector<Eigen::Vector2d> samples;
+  Eigen::Matrix2d covariance;
+  covariance << 1.0, 0.4, 0.4, 2.0;
+  aslam::calibration::NormalDistribution<2>(Eigen::Vector2d(0.5, -0.5),
+    covariance).getSamples(samples, 50000);
+  samples.push_back(max);
+  samples.push_back(Eigen::Vector2d(6.0, 0.0));
+
+  // Flat indices agree with the checked grid indices
+  Histogram2d serial(min, max, binSize);
+  size_t numInRange = 0;
+  for (auto it = samples.cbegin(); it != samples.cend(); ++it) {
+    size_t linIdx;
+    const bool inRange = serial.getLinearIndex(*it, linIdx);
+    ASSERT_EQ(inRange, serial.isInRange(*it));
+    if (inRange) {
+      numInRange++;
+      ASSERT_EQ(linIdx, serial.computeLinearIndex(serial.getIndex(*it)));
+      ASSERT_EQ(serial.computeIndex(linIdx), serial.getIndex(*it));
+    }
+    serial.addSample(*it);
+  }
+  ASSERT_EQ(serial.getSum(), numInRange);
+
+  // Parallel accumulation gives the same counts
+  Histogram2d parallel(min, max, binSize);
+  parallel.addSamples(samples, 4, 1000);
+  ASSERT_EQ(parallel.getCells(), serial.getCells());
+
+  // Merging partial histograms gives the same counts
+  Histogram2d first(min, max, binSize), second(min, max, binSize);
+  first.addSamples(std::vector<Eigen::Vector2d>(samples.begin(),
+    samples.begin() + 1000));
+  second.addSamples(std::vector<Eigen::Vector2d>(samples.begin() + 1000,
+    samples.end()));
+  first.merge(second);
+  ASSERT_EQ(first.getCells(), serial.getCells());
+  ASSERT_THROW(first.merge(Histogram2d(min, max, Eigen::Vector2d(0.5, 0.5))),
+    aslam::calibration::BadArgumentException<Eigen::Vector2d>);
+
+  // Moments over the bin centers
+  Eigen::Vector2d mean = Eigen::Vector2d::Zero();
+  double sum = 0;
+  for (size_t i = 0; i < serial.getNumCellsTot(); ++i) {
+    mean += serial.getCoordinates(serial.computeIndex(i)) *
+      serial.getCells()[i];
+    sum += serial.getCells()[i];
+  }
+  mean /= sum;
+  ASSERT_TRUE((serial.getMean() - mean).norm() < 1e-9);
+  ASSERT_TRUE((serial.getMean() - Eigen::Vector2d(0.5, -0.5)).norm() < 5e-2);
+  ASSERT_TRUE((serial.getCovariance() - covariance).norm() < 1e-1);
+  ASSERT_TRUE((serial.getMode() - Eigen::Vector2d(0.5, -0.5)).norm() < 1.0);
+}
+
+TEST(AslamCalibrationTestSuite, testSparseHistogramMv) {
+  typedef aslam::calibration::Histogram<double, 3> Histogram3d;
+  const Eigen::Vector3d min(-5.0, -5.0, -5.0), max(5.0, 5.0, 5.0),
+    binSize(0.1, 0.1, 0.1);
+  std::vector<Eigen::Vector3d> samples;
+  aslam::calibration::NormalDistribution<3>(Eigen::Vector3d(0.5, -0.5, 1.0),
+    Eigen::Matrix3d::Identity() * 0.1).getSamples(samples, 20000);
+
+  // The sparse histogram only stores occupied cells and matches the dense one
+  Histogram3d dense(min, max, binSize);
+  dense.addSamples(samples);
+  Histogram3d::Sparse sparse(min, max, binSize);
+  sparse.addSamples(samples, 4, 1000);
+  ASSERT_LT(sparse.getNumOccupiedCells(), dense.getNumCellsTot() / 10);
+  for (auto it = sparse.getCellBegin(); it != sparse.getCellEnd(); ++it)
+    ASSERT_EQ(it->second, dense.getCells()[it->first]);
+  ASSERT_EQ(sparse.getSum(), dense.getSum());
+  ASSERT_TRUE((sparse.getMean() - dense.getMean()).norm() < 1e-9);
+  ASSERT_TRUE((sparse.getCovariance() - dense.getCovariance()).norm() < 1e-9);
+  ASSERT_EQ(sparse.getCells().at(sparse.computeLinearIndex(
+    sparse.getIndex(sparse.getMode()))), dense(dense.getMode()));
+  ASSERT_NEAR(sparse.getNormalized().getSum(), 1.0, 1e-9);
+}
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file NormalDistributionTest.cpp
+    \brief This file tests the NormalDistribution class.
+  */
+
+#include <cmath>
+
+#include <Eigen/LU>
+
+#include <gtest/gtest.h>
+
+#include "aslam/calibration/statistics/NormalDistribution.h"
+#include "aslam/calibration/statistics/RandomGenerator.h"
+#include "aslam/calibration/exceptions/BadArgumentException.h"
+
+TEST(AslamCalibrationTestSuite, testNormalDistributionSamples) {
+  aslam::calibration::RandomGenerator::setEnabled(true);
+  aslam::calibration::RandomGenerator::setThreadStream(0);
+
+  // Multivariate samples, one per row
+  Eigen::Matrix3d covariance;
+  covariance << 2.0, 0.5, 0.1, 0.5, 1.0, 0.2, 0.1, 0.2, 0.5;
+  const Eigen::Vector3d mean(1.0, -2.0, 3.0);
+  const aslam::calibration::NormalDistribution<3> dist3(mean, covariance);
+  const size_t numSamples = 100000;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> samples;
+  dist3.getSamples(samples, numSamples);
+  ASSERT_EQ((size_t)samples.rows(), numSamples);
+  const Eigen::Vector3d sampleMean = samples.colwise().mean().transpose();
+  ASSERT_TRUE((sampleMean - mean).cwiseAbs().maxCoeff() < 2e-2);
+  const Eigen::Matrix<double, Eigen::Dynamic, 3> centered =
+    samples.rowwise() - sampleMean.transpose();
+  const Eigen::Matrix3d sampleCovariance = centered.transpose() * centered /
+    double(numSamples - 1);
+  ASSERT_TRUE((sampleCovariance - covariance).cwiseAbs().maxCoeff() < 5e-2);
+
+  // Dynamic size samples
+  const aslam::calibration::NormalDistribution<Eigen::Dynamic> distX(
+    Eigen::VectorXd::Zero(2), Eigen::MatrixXd::Identity(2, 2));
+  Eigen::MatrixXd samplesX;
+  distX.getSamples(samplesX, 10);
+  ASSERT_EQ(samplesX.rows(), 10);
+  ASSERT_EQ(samplesX.cols(), 2);
+
+  // Univariate samples
+  const aslam::calibration::NormalDistribution<1> dist1(-1.0, 4.0);
+  Eigen::VectorXd samples1;
+  dist1.getSamples(samples1, numSamples);
+  ASSERT_EQ((size_t)samples1.size(), numSamples);
+  const double sampleMean1 = samples1.mean();
+  ASSERT_NEAR(sampleMean1, -1.0, 3e-2);
+  ASSERT_NEAR((samples1.array() - sampleMean1).square().sum() /
+    double(numSamples - 1), 4.0, 1e-1);
+
+  aslam::calibration::RandomGenerator::setEnabled(false);
+}
+
+TEST(AslamCalibrationTestSuite, testNormalDistributionDensity) {
+  Eigen::Matrix3d covariance;
+  covariance << 2.0, 0.5, 0.1, 0.5, 1.0, 0.2, 0.1, 0.2, 0.5;
+  const Eigen::Vector3d mean(1.0, -2.0, 3.0);
+  const aslam::calibration::NormalDistribution<3> dist(mean, covariance);
+
+  // Cholesky based quantities against the explicit inverse and determinant
+  const Eigen::Matrix3d precision = covariance.inverse();
+  ASSERT_TRUE((dist.getPrecision() - precision).norm() < 1e-12);
+  ASSERT_NEAR(dist.getDeterminant(), covariance.determinant(), 1e-12);
+  ASSERT_NEAR(dist.getLogDeterminant(), log(covariance.determinant()),
+    1e-12);
+  const Eigen::Vector3d x(0.5, -1.0, 2.0);
+  const double md2 = (x - mean).transpose() * precision * (x - mean);
+  ASSERT_NEAR(dist.mahalanobisDistance(x), md2, 1e-12);
+  ASSERT_NEAR(dist.logpdf(x), -0.5 * md2 - 1.5 * log(2.0 * M_PI) -
+    0.5 * log(covariance.determinant()), 1e-12);
+
+  // Batch evaluation matches the point-wise evaluation
+  Eigen::Matrix<double, Eigen::Dynamic, 3> points(4, 3);
+  points << 0.5, -1.0, 2.0, 1.0, -2.0, 3.0, 3.0, 0.0, 1.0, -1.0, 1.0, 4.0;
+  const Eigen::VectorXd distances = dist.mahalanobisDistances(points);
+  const Eigen::VectorXd logpdfs = dist.logpdfs(points);
+  ASSERT_EQ(distances.size(), 4);
+  ASSERT_EQ(logpdfs.size(), 4);
+  for (size_t i = 0; i < 4; ++i) {
+    const Eigen::Vector3d point = points.row(i).transpose();
+    ASSERT_NEAR(distances(i), dist.mahalanobisDistance(point), 1e-12);
+    ASSERT_NEAR(logpdfs(i), dist.logpdf(point), 1e-12);
+  }
+
+  // KL-divergence
+  const aslam::calibration::NormalDistribution<3> other(
+    Eigen::Vector3d::Zero(), Eigen::Matrix3d::Identity() * 2.0);
+  const Eigen::Matrix3d otherPrecision = Eigen::Matrix3d::Identity() * 0.5;
+  ASSERT_NEAR(dist.KLDivergence(other), 0.5 * (log(8.0 /
+    covariance.determinant()) + (otherPrecision * covariance).trace() - 3 +
+    mean.transpose() * otherPrecision * mean), 1e-12);
+  ASSERT_NEAR(dist.KLDivergence(dist), 0.0, 1e-12);
+
+  // Singular covariances are rejected
+  ASSERT_THROW(aslam::calibration::NormalDistribution<2>(
+    Eigen::Vector2d::Zero(), Eigen::Matrix2d::Zero()),
+    aslam::calibration::BadArgumentException<Eigen::Matrix2d>);
+}
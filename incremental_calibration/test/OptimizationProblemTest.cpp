@@ -32,11 +32,15 @@
 #include "aslam/calibration/data-structures/VectorDesignVariable.h"
 #include "aslam/calibration/exceptions/OutOfBoundException.h"
 #include "aslam/calibration/exceptions/InvalidOperationException.h"
+#include "aslam/calibration/exceptions/NullPointerException.h"
 
 class DummyErrorTerm :
   public aslam::backend::ErrorTermFs<3> {
 public:
   DummyErrorTerm() = default;
+  DummyErrorTerm(aslam::backend::DesignVariable* dv) {
+    setDesignVariables(dv);
+  };
   DummyErrorTerm(const DummyErrorTerm& other) = delete;
   DummyErrorTerm& operator = (const DummyErrorTerm& other) = delete;
   virtual ~DummyErrorTerm() {};
@@ -131,3 +135,34 @@ TEST(AslamCalibrationTestSuite, testOptimizationProblem) {
   dv1->getParameters(dv1Param);
   ASSERT_EQ(dv1Param, Eigen::Vector2d::Zero());
 }
+
+TEST(AslamCalibrationTestSuite, testOptimizationProblemAddErrorTerms) {
+  OptimizationProblem problem;
+  auto et1 = boost::make_shared<DummyErrorTerm>();
+  auto et2 = boost::make_shared<DummyErrorTerm>();
+  auto et3 = boost::make_shared<DummyErrorTerm>();
+  problem.addErrorTerm(et1);
+  problem.addErrorTerms({et2, et3});
+  ASSERT_EQ(problem.numErrorTerms(), 3);
+  ASSERT_EQ(problem.getErrorTerms(),
+    OptimizationProblem::ErrorTermsSP({et1, et2, et3}));
+  ASSERT_TRUE(problem.isErrorTermInProblem(et3.get()));
+  auto et4 = boost::make_shared<DummyErrorTerm>();
+  ASSERT_THROW(problem.addErrorTerms({et4, et1}), InvalidOperationException);
+  ASSERT_THROW(problem.addErrorTerms({et4, et4}), InvalidOperationException);
+  ASSERT_FALSE(problem.isErrorTermInProblem(et4.get()));
+  ASSERT_EQ(problem.numErrorTerms(), 3);
+  auto dv1 = boost::make_shared<VectorDesignVariable<2> >();
+  auto dv2 = boost::make_shared<VectorDesignVariable<2> >();
+  problem.addDesignVariable(dv1);
+  auto et5 = boost::make_shared<DummyErrorTerm>(dv1.get());
+  auto et6 = boost::make_shared<DummyErrorTerm>(dv2.get());
+  ASSERT_THROW(problem.addErrorTerms({et5, et6}), InvalidOperationException);
+  ASSERT_FALSE(problem.isErrorTermInProblem(et5.get()));
+  ASSERT_THROW(problem.addErrorTerms({et5, nullptr}), NullPointerException);
+  ASSERT_FALSE(problem.isErrorTermInProblem(et5.get()));
+  ASSERT_EQ(problem.numErrorTerms(), 3);
+  problem.addErrorTerms({et5});
+  ASSERT_TRUE(problem.isErrorTermInProblem(et5.get()));
+  ASSERT_EQ(problem.numErrorTerms(), 4);
+}
@@ -0,0 +1,92 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file RandomGeneratorTest.cpp
+    \brief This file tests the RandomGenerator class.
+  */
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "aslam/calibration/statistics/RandomGenerator.h"
+#include "aslam/calibration/statistics/Randomizer.h"
+
+namespace {
+
+  /// Draws numbers from the thread generator after selecting a stream
+  void drawFromStream(size_t stream, std::vector<double>& samples) {
+    aslam::calibration::RandomGenerator::setThreadStream(stream);
+    aslam::calibration::RandomGenerator& generator =
+      aslam::calibration::RandomGenerator::getInstance();
+    for (size_t i = 0; i < samples.size(); ++i)
+      samples[i] = generator.sampleNormal();
+  }
+
+}
+
+TEST(AslamCalibrationTestSuite, testRandomGenerator) {
+  // Same seed and stream yield the same sequence
+  aslam::calibration::RandomGenerator g1(42), g2(42), g3(42, 1), g4(43);
+  const uint64_t first = g1();
+  ASSERT_EQ(first, g2());
+  ASSERT_NE(first, g3());
+  ASSERT_NE(first, g4());
+
+  // Stream splitting is a jump
+  aslam::calibration::RandomGenerator g5(42);
+  g5.jump();
+  aslam::calibration::RandomGenerator g6(42, 1);
+  for (size_t i = 0; i < 10; ++i)
+    ASSERT_EQ(g5(), g6());
+
+  // Uniform samples lie in [0, 1) and normal samples have unit moments
+  aslam::calibration::RandomGenerator g7(7);
+  const size_t numSamples = 200000;
+  double sum = 0, squaredSum = 0;
+  for (size_t i = 0; i < numSamples; ++i) {
+    const double u = g7.sampleUniform();
+    ASSERT_GE(u, 0.0);
+    ASSERT_LT(u, 1.0);
+    const double x = g7.sampleNormal();
+    sum += x;
+    squaredSum += x * x;
+  }
+  ASSERT_NEAR(sum / numSamples, 0.0, 1e-2);
+  ASSERT_NEAR(squaredSum / numSamples, 1.0, 2e-2);
+
+  // Thread generators only depend on the global seed and the stream
+  aslam::calibration::RandomGenerator::setGlobalSeed(5);
+  std::vector<double> serial(100), threaded(100);
+  drawFromStream(3, serial);
+  std::thread thread(drawFromStream, 3, std::ref(threaded));
+  thread.join();
+  ASSERT_EQ(serial, threaded);
+
+  // The Randomizer is switchable to the thread generators
+  aslam::calibration::RandomGenerator::setEnabled(true);
+  aslam::calibration::Randomizer<double> randomizer;
+  randomizer.setSeed(11);
+  aslam::calibration::RandomGenerator::setThreadStream(0);
+  const double x1 = randomizer.sampleNormal();
+  randomizer.setSeed(11);
+  aslam::calibration::RandomGenerator::setThreadStream(0);
+  ASSERT_EQ(x1, randomizer.sampleNormal());
+  aslam::calibration::RandomGenerator::setEnabled(false);
+}
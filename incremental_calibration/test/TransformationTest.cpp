@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file TransformationTest.cpp
+    \brief This file tests the Transformation class.
+  */
+
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <Eigen/StdVector>
+
+#include <gtest/gtest.h>
+
+#include "aslam/calibration/geometry/Transformation.h"
+
+using namespace aslam::calibration;
+
+TEST(AslamCalibrationTestSuite, testTransformation2d) {
+  const Transformation<double, 2> first(1.0, -2.0, 0.3);
+  const Transformation<double, 2> second(-0.5, 0.25, -1.2);
+  const Eigen::Matrix<double, 2, Eigen::Dynamic> points =
+    Eigen::Matrix<double, 2, Eigen::Dynamic>::Random(2, 100);
+
+  // Batched transformation matches the per-point path
+  Eigen::Matrix<double, 2, Eigen::Dynamic> transformed(2, points.cols());
+  first.transform(points, transformed);
+  for (size_t i = 0; i < static_cast<size_t>(points.cols()); ++i)
+    ASSERT_TRUE((transformed.col(i) -
+      first(Eigen::Vector2d(points.col(i)))).norm() < 1e-12);
+  Eigen::MatrixXd block = Eigen::MatrixXd::Zero(2, 10);
+  first.transform(points.leftCols(10), block.leftCols(10));
+  ASSERT_TRUE((block - transformed.leftCols(10)).norm() < 1e-12);
+
+  // Composition applies the right-hand side first
+  const Transformation<double, 2> composed = first * second;
+  for (size_t i = 0; i < static_cast<size_t>(points.cols()); ++i) {
+    const Eigen::Vector2d point = points.col(i);
+    ASSERT_TRUE((composed(point) - first(second(point))).norm() < 1e-12);
+  }
+  std::vector<Transformation<double, 2>,
+    Eigen::aligned_allocator<Transformation<double, 2> > > sequence;
+  sequence.push_back(first);
+  sequence.push_back(second);
+  sequence.push_back(first.getInverse());
+  Transformation<double, 2> chain = Transformation<double, 2>::compose(
+    sequence.begin(), sequence.end());
+  const Eigen::Vector2d point = points.col(0);
+  ASSERT_TRUE((chain(point) - first(second(first.getInverse()(point)))).norm()
+    < 1e-12);
+  const Eigen::Vector2d transformedPoint = chain(point);
+  chain.inverse();
+  ASSERT_TRUE((chain(transformedPoint) - point).norm() < 1e-12);
+  chain.inverse();
+  ASSERT_TRUE((chain(point) - transformedPoint).norm() < 1e-12);
+}
+
+TEST(AslamCalibrationTestSuite, testTransformation3d) {
+  const Transformation<double, 3> first(1.0, -2.0, 0.5, 0.1, -0.2, 0.3);
+  const Transformation<double, 3> second(-0.5, 0.25, 2.0, 0.7, 0.4, -1.2);
+  const Eigen::Matrix<double, 3, Eigen::Dynamic> points =
+    Eigen::Matrix<double, 3, Eigen::Dynamic>::Random(3, 100);
+
+  // Batched transformation matches the per-point path
+  Eigen::Matrix<double, 3, Eigen::Dynamic> transformed(3, points.cols());
+  first.transform(points, transformed);
+  for (size_t i = 0; i < static_cast<size_t>(points.cols()); ++i)
+    ASSERT_TRUE((transformed.col(i) -
+      first(Eigen::Vector3d(points.col(i)))).norm() < 1e-12);
+
+  // Composition applies the right-hand side first
+  Transformation<double, 3> composed(first);
+  composed *= second;
+  Eigen::Matrix<double, 3, Eigen::Dynamic> twice(3, points.cols());
+  second.transform(points, transformed);
+  first.transform(transformed, twice);
+  Eigen::Matrix<double, 3, Eigen::Dynamic> once(3, points.cols());
+  composed.transform(points, once);
+  ASSERT_TRUE((once - twice).norm() < 1e-12);
+  Transformation<double, 3> squared(first);
+  squared *= squared;
+  ASSERT_TRUE((squared.getTransformationMatrix() -
+    first.getTransformationMatrix() * first.getTransformationMatrix()).norm()
+    < 1e-12);
+
+  // Transformations built from a matrix can be inverted
+  Eigen::Matrix4d matrix = Eigen::Matrix4d::Identity();
+  matrix.topLeftCorner<3, 3>() = Eigen::AngleAxisd(0.4,
+    Eigen::Vector3d::UnitZ()).toRotationMatrix();
+  matrix.topRightCorner<3, 1>() = Eigen::Vector3d(1.0, 2.0, 3.0);
+  const Transformation<double, 3> fromMatrix(matrix);
+  const Eigen::Vector3d point = points.col(0);
+  ASSERT_TRUE((fromMatrix.getInverse()(fromMatrix(point)) - point).norm() <
+    1e-12);
+}
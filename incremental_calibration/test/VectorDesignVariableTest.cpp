@@ -62,4 +62,21 @@ TEST(AslamCalibrationTestSuite, testVectorDesignVariable) {
   ASSERT_EQ(Eigen::Vector3d::Ones(), dv1Param);
   ASSERT_THROW(dv1.setParameters(Eigen::Vector2d::Ones()),
     aslam::calibration::OutOfBoundException<int>);
+
+  // Versions
+  ASSERT_NE(dv1.getVersion(), 0);
+  ASSERT_NE(dv1.getVersion(), dv4.getVersion());
+  size_t version = dv1.getVersion();
+  dv1.setValue(aslam::calibration::VectorDesignVariable<3>::Container::Ones());
+  ASSERT_NE(dv1.getVersion(), version);
+  version = dv1.getVersion();
+  const Eigen::Vector3d dp = Eigen::Vector3d::Ones();
+  dv1.update(dp.data(), 3);
+  ASSERT_NE(dv1.getVersion(), version);
+  version = dv1.getVersion();
+  dv1.revertUpdate();
+  ASSERT_NE(dv1.getVersion(), version);
+  version = dv1.getVersion();
+  dv1.setParameters(Eigen::Vector3d::Zero());
+  ASSERT_NE(dv1.getVersion(), version);
 }
@@ -24,6 +24,8 @@
 #ifndef ASLAM_CALIBRATION_2DLRF_ERROR_TERM_MOTION_H
 #define ASLAM_CALIBRATION_2DLRF_ERROR_TERM_MOTION_H
 
+#include <cstddef>
+
 #include <aslam/backend/ErrorTerm.hpp>
 
 namespace aslam {
@@ -32,7 +34,8 @@ namespace aslam {
     template <int M> class VectorDesignVariable;
 
     /** The class ErrorTermMotion implements a motion model for the 2D-LRF
-        problem.
+        problem. The predicted input and the Jacobians are computed in a single
+        pass and cached until the version of a state changes.
         \brief 2D-LRF motion model
       */
     class ErrorTermMotion :
@@ -98,6 +101,10 @@ namespace aslam {
       /// Evaluate the Jacobians
       virtual void evaluateJacobiansImplementation(
         aslam::backend::JacobianContainer& J);
+      /// Evaluate the prediction and the Jacobians if the states have changed
+      void linearize();
+      /// Invalidates the cached prediction and Jacobians
+      void invalidate();
       /** @}
         */
 
@@ -114,6 +121,14 @@ namespace aslam {
       Input _uk;
       /// Covariance matrix
       Covariance _Q;
+      /// Versions of the states of the cached linearization
+      size_t _versions[2];
+      /// Cached input predicted from the states
+      Input _prediction;
+      /// Cached Jacobian with respect to the state at time k-1
+      Eigen::Matrix<double, 3, 3> _Jxkm1;
+      /// Cached Jacobian with respect to the state at time k
+      Eigen::Matrix<double, 3, 3> _Jxk;
       /** @}
         */
 
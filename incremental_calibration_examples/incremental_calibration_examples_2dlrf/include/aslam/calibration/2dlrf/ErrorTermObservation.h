@@ -24,6 +24,8 @@
 #ifndef ASLAM_CALIBRATION_2DLRF_ERROR_TERM_OBSERVATION_H
 #define ASLAM_CALIBRATION_2DLRF_ERROR_TERM_OBSERVATION_H
 
+#include <cstddef>
+
 #include <aslam/backend/ErrorTerm.hpp>
 
 namespace aslam {
@@ -32,7 +34,8 @@ namespace aslam {
     template <int M> class VectorDesignVariable;
 
     /** The class ErrorTermObservation implements an observation model for the
-        2D-LRF problem.
+        2D-LRF problem. The error and the Jacobians are computed in a single
+        pass and cached until the version of a design variable changes.
         \brief 2D-LRF observation model
       */
     class ErrorTermObservation :
@@ -94,6 +97,10 @@ namespace aslam {
       /// Evaluate the Jacobians
       virtual void evaluateJacobiansImplementation(
         aslam::backend::JacobianContainer& J);
+      /// Evaluate the error and the Jacobians if the variables have changed
+      void linearize();
+      /// Invalidates the cached error and Jacobians
+      void invalidate();
       /** @}
         */
 
@@ -112,6 +119,16 @@ namespace aslam {
       double _b;
       /// Covariance matrix
       Covariance _R;
+      /// Versions of the variables of the cached linearization
+      size_t _versions[3];
+      /// Cached error
+      error_t _error;
+      /// Cached Jacobian with respect to the state
+      Eigen::Matrix<double, 2, 3> _Jxk;
+      /// Cached Jacobian with respect to the landmark
+      Eigen::Matrix<double, 2, 2> _Jxl;
+      /// Cached Jacobian with respect to the calibration parameters
+      Eigen::Matrix<double, 2, 3> _JTheta;
       /** @}
         */
 
@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file LandmarkGrid.h
+    \brief This file defines the LandmarkGrid class, which implements a spatial
+           index over the landmarks of the 2D-LRF problem.
+  */
+
+#ifndef ASLAM_CALIBRATION_2DLRF_LANDMARK_GRID_H
+#define ASLAM_CALIBRATION_2DLRF_LANDMARK_GRID_H
+
+#include <cstddef>
+
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <aslam/calibration/data-structures/Grid.h>
+
+namespace aslam {
+  namespace calibration {
+
+    /** The class LandmarkGrid implements a spatial index over the landmarks
+        of the 2D-LRF problem. The landmarks are binned into the cells of a
+        uniform grid, such that the landmarks visible from a pose are found
+        by visiting the cells within the maximum range only. The landmarks
+        indices are stored cell after cell in a single array and each cell of
+        the grid holds the offset of its first landmark.
+        \brief Landmarks spatial index
+      */
+    class LandmarkGrid {
+    public:
+      /** \name Types definitions
+        @{
+        */
+      /// Landmarks container
+      typedef std::vector<Eigen::Matrix<double, 2, 1> > Landmarks;
+      /// Grid type, each cell holds the offset of its landmarks
+      typedef Grid<double, size_t, 2> LandmarksGrid;
+      /// Self type
+      typedef LandmarkGrid Self;
+      /** @}
+        */
+
+      /** \name Constructors/destructor
+        @{
+        */
+      /// Constructs the index of landmarks inside [minimum, maximum]
+      LandmarkGrid(const Landmarks& landmarks, const Eigen::Vector2d& minimum,
+        const Eigen::Vector2d& maximum, double resolution);
+      /// Copy constructor
+      LandmarkGrid(const Self& other) = delete;
+      /// Copy assignment operator
+      LandmarkGrid& operator = (const Self& other) = delete;
+      /// Move constructor
+      LandmarkGrid(Self&& other) = delete;
+      /// Move assignment operator
+      LandmarkGrid& operator = (Self&& other) = delete;
+      /// Destructor
+      virtual ~LandmarkGrid();
+      /** @}
+        */
+
+      /** \name Accessors
+        @{
+        */
+      /// Returns the landmarks
+      const Landmarks& getLandmarks() const;
+      /// Returns the grid
+      const LandmarksGrid& getGrid() const;
+      /** @}
+        */
+
+      /** \name Methods
+        @{
+        */
+      /// Returns the sorted indices of the landmarks within range of a point
+      void getLandmarksInRange(const Eigen::Vector2d& point, double range,
+        std::vector<size_t>& indices) const;
+      /** Returns the sorted indices of the landmarks visible from a sensor
+          pose [x, y, theta], with maximum range and field of view centered
+          on the heading
+        */
+      void getVisibleLandmarks(const Eigen::Vector3d& pose, double maxRange,
+        double fov, std::vector<size_t>& indices) const;
+      /** @}
+        */
+
+    protected:
+      /** \name Protected members
+        @{
+        */
+      /// Landmarks
+      Landmarks _landmarks;
+      /// Grid of offsets into the landmarks indices
+      LandmarksGrid _grid;
+      /// Landmarks indices sorted by cell
+      std::vector<size_t> _indices;
+      /** @}
+        */
+
+    };
+
+  }
+}
+
+#endif // ASLAM_CALIBRATION_2DLRF_LANDMARK_GRID_H
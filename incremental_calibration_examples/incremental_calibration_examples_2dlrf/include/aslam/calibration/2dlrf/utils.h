@@ -23,6 +23,8 @@
 #ifndef ASLAM_CALIBRATION_2DLRF_UTILS_H
 #define ASLAM_CALIBRATION_2DLRF_UTILS_H
 
+#include <cstddef>
+
 #include <vector>
 
 #include <Eigen/Core>
@@ -30,6 +32,28 @@
 namespace aslam {
   namespace calibration {
 
+    template <int M> class VectorDesignVariable;
+
+    /** \name Types definitions
+      @{
+      */
+    /// Range and bearing measurement of a landmark
+    struct LandmarkObservation {
+      /// Constructs observation of a landmark
+      LandmarkObservation(size_t landmark = 0, double r = 0, double b = 0) :
+          landmark(landmark),
+          r(r),
+          b(b) {}
+      /// Landmark index
+      size_t landmark;
+      /// Range measurement
+      double r;
+      /// Bearing measurement
+      double b;
+    };
+    /** @}
+      */
+
     /** \name Methods
       @{
       */
@@ -42,6 +66,17 @@ namespace aslam {
       const Eigen::Matrix<double, 3, 1>& Theta_hat,
       const std::vector<std::vector<double> >& r,
       const std::vector<std::vector<double> >& b);
+    /// Inits landmarks positions from noisy observations of the visible ones
+    void initLandmarks(std::vector<Eigen::Matrix<double, 2, 1> >& x_l_hat,
+      const std::vector<Eigen::Matrix<double, 3, 1> >& x_odom,
+      const Eigen::Matrix<double, 3, 1>& Theta_hat,
+      const std::vector<std::vector<LandmarkObservation> >& observations,
+      size_t nl);
+    /** Returns the cosine and sine of the heading of a pose, the last ones
+        computed in the calling thread are reused for the same pose version
+      */
+    void getHeadingTrigonometry(const VectorDesignVariable<3>& x, double& c,
+      double& s);
     /** @}
       */
 
@@ -24,6 +24,8 @@
 
 #include <aslam/calibration/data-structures/VectorDesignVariable.h>
 
+#include "aslam/calibration/2dlrf/utils.h"
+
 namespace aslam {
   namespace calibration {
 
@@ -41,6 +43,7 @@ namespace aslam {
         _Q(Q) {
       setInvR(_Q.inverse());
       setDesignVariables(xkm1, xk);
+      invalidate();
     }
 
     ErrorTermMotion::ErrorTermMotion(const ErrorTermMotion& other) :
@@ -50,6 +53,7 @@ namespace aslam {
         _T(other._T),
         _uk(other._uk),
         _Q(other._Q) {
+      invalidate();
     }
 
     ErrorTermMotion& ErrorTermMotion::operator =
@@ -61,6 +65,7 @@ namespace aslam {
        _T = other._T;
        _uk = other._uk;
        _Q = other._Q;
+       invalidate();
       }
       return *this;
     }
@@ -78,6 +83,7 @@ namespace aslam {
 
     void ErrorTermMotion::setTimestep(double T) {
       _T = T;
+      invalidate();
     }
 
     const ErrorTermMotion::Input& ErrorTermMotion::getInput() const {
@@ -108,43 +114,45 @@ namespace aslam {
 /* Methods                                                                    */
 /******************************************************************************/
 
+    void ErrorTermMotion::invalidate() {
+      _versions[0] = _versions[1] = 0;
+    }
+
+    void ErrorTermMotion::linearize() {
+      if (_versions[0] == _xkm1->getVersion() &&
+          _versions[1] == _xk->getVersion())
+        return;
+      double ct, st;
+      getHeadingTrigonometry(*_xkm1, ct, st);
+      const Eigen::Matrix<double, 3, 1> dx = _xk->getValue() -
+        _xkm1->getValue();
+      _prediction(0) = (ct * dx(0) + st * dx(1)) / _T;
+      _prediction(1) = (-st * dx(0) + ct * dx(1)) / _T;
+      _prediction(2) = dx(2) / _T;
+      _Jxk = Eigen::Matrix<double, 3, 3>::Zero();
+      _Jxk(0, 0) = -ct / _T;
+      _Jxk(0, 1) = -st / _T;
+      _Jxk(1, 0) = st / _T;
+      _Jxk(1, 1) = -ct / _T;
+      _Jxk(2, 2) = -1 / _T;
+      _Jxkm1 = -_Jxk;
+      _Jxkm1(0, 2) = (st * dx(0) - ct * dx(1)) / _T;
+      _Jxkm1(1, 2) = (ct * dx(0) + st * dx(1)) / _T;
+      _versions[0] = _xkm1->getVersion();
+      _versions[1] = _xk->getVersion();
+    }
+
     double ErrorTermMotion::evaluateErrorImplementation() {
-      Eigen::Matrix<double, 3, 3> B = Eigen::Matrix<double, 3, 3>::Identity();
-      B(0, 0) = cos((_xkm1->getValue())(2));
-      B(0, 1) = sin((_xkm1->getValue())(2));
-      B(1, 0) = -sin((_xkm1->getValue())(2));
-      B(1, 1) = cos((_xkm1->getValue())(2));
-      error_t error = _uk -
-        (1 / _T * B * (_xk->getValue() - _xkm1->getValue()));
-      setError(error);
+      linearize();
+      setError(_uk - _prediction);
       return evaluateChiSquaredError();
     }
 
     void ErrorTermMotion::evaluateJacobiansImplementation(
         aslam::backend::JacobianContainer& jacobians) {
-      Eigen::Matrix<double, 3, 3> Hxk = Eigen::Matrix<double, 3, 3>::Zero();
-      Hxk(0, 0) = cos((_xkm1->getValue())(2));
-      Hxk(0, 1) = sin((_xkm1->getValue())(2));
-      Hxk(1, 0) = -sin((_xkm1->getValue())(2));
-      Hxk(1, 1) = cos((_xkm1->getValue())(2));
-      Hxk(2, 2) = 1;
-      Eigen::Matrix<double, 3, 3> Hxkm1 =
-        Eigen::Matrix<double, 3, 3>::Zero();
-      Hxkm1(0, 0) = -cos((_xkm1->getValue())(2));
-      Hxkm1(0, 1) = -sin((_xkm1->getValue())(2));
-      Hxkm1(0, 2) = -sin((_xkm1->getValue())(2)) *
-        ((_xk->getValue())(0) - (_xkm1->getValue())(0)) +
-        cos((_xkm1->getValue())(2)) *
-        ((_xk->getValue())(1) - (_xkm1->getValue())(1));
-      Hxkm1(1, 0) = sin((_xkm1->getValue())(2));
-      Hxkm1(1, 1) = -cos((_xkm1->getValue())(2));
-      Hxkm1(1, 2) = -cos((_xkm1->getValue())(2)) *
-        ((_xk->getValue())(0) - (_xkm1->getValue())(0)) -
-        sin((_xkm1->getValue())(2)) *
-        ((_xk->getValue())(1) - (_xkm1->getValue())(1));
-      Hxkm1(2, 2) = -1;
-      jacobians.add(_xkm1, -Hxkm1 / _T);
-      jacobians.add(_xk, -Hxk / _T);
+      linearize();
+      jacobians.add(_xkm1, _Jxkm1);
+      jacobians.add(_xk, _Jxk);
     }
 
   }
@@ -24,6 +24,8 @@
 
 #include <aslam/calibration/data-structures/VectorDesignVariable.h>
 
+#include "aslam/calibration/2dlrf/utils.h"
+
 namespace aslam {
   namespace calibration {
 
@@ -42,6 +44,7 @@ namespace aslam {
         _R(R) {
       setInvR(_R.inverse());
       setDesignVariables(xk, xl, Theta);
+      invalidate();
     }
 
     ErrorTermObservation::ErrorTermObservation(
@@ -53,6 +56,7 @@ namespace aslam {
         _r(other._r),
         _b(other._b),
         _R(other._R) {
+      invalidate();
     }
 
     ErrorTermObservation& ErrorTermObservation::operator =
@@ -65,6 +69,7 @@ namespace aslam {
        _r = other._r;
        _b = other._b;
        _R = other._R;
+       invalidate();
       }
       return *this;
     }
@@ -82,6 +87,7 @@ namespace aslam {
 
     void ErrorTermObservation::setRange(double r) {
       _r = r;
+      invalidate();
     }
 
     double ErrorTermObservation::getBearing() const {
@@ -90,6 +96,7 @@ namespace aslam {
 
     void ErrorTermObservation::setBearing(double b) {
       _b = b;
+      invalidate();
     }
 
     const ErrorTermObservation::Covariance&
@@ -109,9 +116,17 @@ namespace aslam {
 /* Methods                                                                    */
 /******************************************************************************/
 
-    double ErrorTermObservation::evaluateErrorImplementation() {
-      const double ct = cos((_xk->getValue())(2));
-      const double st = sin((_xk->getValue())(2));
+    void ErrorTermObservation::invalidate() {
+      _versions[0] = _versions[1] = _versions[2] = 0;
+    }
+
+    void ErrorTermObservation::linearize() {
+      if (_versions[0] == _xk->getVersion() &&
+          _versions[1] == _xl->getVersion() &&
+          _versions[2] == _Theta->getVersion())
+        return;
+      double ct, st;
+      getHeadingTrigonometry(*_xk, ct, st);
       const double dxct = (_Theta->getValue())(0) * ct;
       const double dxst = (_Theta->getValue())(0) * st;
       const double dyct = (_Theta->getValue())(1) * ct;
@@ -122,49 +137,42 @@ namespace aslam {
         - dyct;
       const double temp1 = aa * aa + bb * bb;
       const double temp2 = sqrt(temp1);
-      error_t error;
-      error(0) = _r - temp2;
-      error(1) = sm::kinematics::angleMod(_b - (atan2(bb, aa) -
+      _error(0) = _r - temp2;
+      _error(1) = sm::kinematics::angleMod(_b - (atan2(bb, aa) -
         (_xk->getValue())(2) - (_Theta->getValue())(2)));
-      setError(error);
+      _Jxk(0, 0) = aa / temp2;
+      _Jxk(0, 1) = bb / temp2;
+      _Jxk(0, 2) = -(aa * (dxst + dyct) + bb * (-dxct + dyst)) / temp2;
+      _Jxk(1, 0) = -bb / temp1;
+      _Jxk(1, 1) = aa / temp1;
+      _Jxk(1, 2) = -(aa * (-dxct + dyst) - bb * (dxst + dyct)) / temp1 + 1;
+      _Jxl(0, 0) = -aa / temp2;
+      _Jxl(0, 1) = -bb / temp2;
+      _Jxl(1, 0) = bb / temp1;
+      _Jxl(1, 1) = -aa / temp1;
+      _JTheta(0, 0) = (aa * ct + bb * st) / temp2;
+      _JTheta(0, 1) = -(aa * st - bb * ct) / temp2;
+      _JTheta(0, 2) = 0;
+      _JTheta(1, 0) = -(-aa * st + bb * ct) / temp1;
+      _JTheta(1, 1) = (aa * ct + bb * st) / temp1;
+      _JTheta(1, 2) = 1;
+      _versions[0] = _xk->getVersion();
+      _versions[1] = _xl->getVersion();
+      _versions[2] = _Theta->getVersion();
+    }
+
+    double ErrorTermObservation::evaluateErrorImplementation() {
+      linearize();
+      setError(_error);
       return evaluateChiSquaredError();
     }
 
     void ErrorTermObservation::evaluateJacobiansImplementation(
         aslam::backend::JacobianContainer& jacobians) {
-      const double ct = cos((_xk->getValue())(2));
-      const double st = sin((_xk->getValue())(2));
-      const double dxct = (_Theta->getValue())(0) * ct;
-      const double dxst = (_Theta->getValue())(0) * st;
-      const double dyct = (_Theta->getValue())(1) * ct;
-      const double dyst = (_Theta->getValue())(1) * st;
-      const double aa = (_xl->getValue())(0) - (_xk->getValue())(0) - dxct
-        + dyst;
-      const double bb = (_xl->getValue())(1) - (_xk->getValue())(1) - dxst
-        - dyct;
-      const double temp1 = aa * aa + bb * bb;
-      const double temp2 = sqrt(temp1);
-      Eigen::Matrix<double, 2, 3> Gxk = Eigen::Matrix<double, 2, 3>::Zero();
-      Gxk(0, 0) = -aa / temp2;
-      Gxk(0, 1) = -bb / temp2;
-      Gxk(0, 2) = (aa * (dxst + dyct) + bb * (-dxct + dyst)) / temp2;
-      Gxk(1, 0) = bb / temp1;
-      Gxk(1, 1) = -aa / temp1;
-      Gxk(1, 2) = (aa * (-dxct + dyst) - bb * (dxst + dyct)) / temp1 - 1;
-      Eigen::Matrix<double, 2, 2> Glk = Eigen::Matrix<double, 2, 2>::Zero();
-      Glk(0, 0) = aa / temp2;
-      Glk(0, 1) = bb / temp2;
-      Glk(1, 0) = -bb / temp1;
-      Glk(1, 1) = aa / temp1;
-      Eigen::Matrix<double, 2, 3> Gtk = Eigen::Matrix<double, 2, 3>::Zero();
-      Gtk(0, 0) = -(aa * ct + bb * st) / temp2;
-      Gtk(0, 1) = (aa * st - bb * ct) / temp2;
-      Gtk(1, 0) = (-aa * st + bb * ct) / temp1;
-      Gtk(1, 1) = -(aa * ct + bb * st) / temp1;
-      Gtk(1, 2) = -1;
-      jacobians.add(_xk, -Gxk);
-      jacobians.add(_xl, -Glk);
-      jacobians.add(_Theta, -Gtk);
+      linearize();
+      jacobians.add(_xk, _Jxk);
+      jacobians.add(_xl, _Jxl);
+      jacobians.add(_Theta, _JTheta);
     }
 
   }
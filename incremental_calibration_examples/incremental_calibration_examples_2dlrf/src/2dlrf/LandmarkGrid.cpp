@@ -0,0 +1,123 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "aslam/calibration/2dlrf/LandmarkGrid.h"
+
+#include <cmath>
+
+#include <algorithm>
+
+#include <sm/kinematics/rotations.hpp>
+
+#include <aslam/calibration/exceptions/BadArgumentException.h>
+
+namespace aslam {
+  namespace calibration {
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+    LandmarkGrid::LandmarkGrid(const Landmarks& landmarks, const
+        Eigen::Vector2d& minimum, const Eigen::Vector2d& maximum, double
+        resolution) :
+        _landmarks(landmarks),
+        _grid(minimum, maximum, Eigen::Vector2d::Constant(resolution)),
+        _indices(landmarks.size()) {
+      // counting sort of the landmarks by cell
+      std::vector<size_t> cells(_landmarks.size());
+      std::vector<size_t> counts(_grid.getNumCellsTot() + 1, 0);
+      for (size_t i = 0; i < _landmarks.size(); ++i) {
+        if (!_grid.isInRange(_landmarks[i]))
+          throw BadArgumentException<size_t>(i,
+            "LandmarkGrid::LandmarkGrid(): landmark out of the grid",
+            __FILE__, __LINE__, __PRETTY_FUNCTION__);
+        cells[i] = _grid.computeLinearIndex(_grid.getIndex(_landmarks[i]));
+        counts[cells[i] + 1]++;
+      }
+      for (size_t i = 1; i < counts.size(); ++i)
+        counts[i] += counts[i - 1];
+      std::copy(counts.begin(), counts.end() - 1, _grid.getCellBegin());
+      for (size_t i = 0; i < _landmarks.size(); ++i)
+        _indices[counts[cells[i]]++] = i;
+    }
+
+    LandmarkGrid::~LandmarkGrid() {
+    }
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+    const LandmarkGrid::Landmarks& LandmarkGrid::getLandmarks() const {
+      return _landmarks;
+    }
+
+    const LandmarkGrid::LandmarksGrid& LandmarkGrid::getGrid() const {
+      return _grid;
+    }
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    void LandmarkGrid::getLandmarksInRange(const Eigen::Vector2d& point,
+        double range, std::vector<size_t>& indices) const {
+      indices.clear();
+
+      // cells overlapping the bounding box of the disc, clipped to the grid
+      const Eigen::Vector2d lower = (point.array() - range).max(
+        _grid.getMinimum().array()).matrix();
+      const Eigen::Vector2d upper = (point.array() + range).min(
+        _grid.getMaximum().array()).matrix();
+      if ((lower.array() > upper.array()).any())
+        return;
+      const LandmarksGrid::Index lowerIdx = _grid.getIndex(lower);
+      const LandmarksGrid::Index upperIdx = _grid.getIndex(upper);
+      const double range2 = range * range;
+      LandmarksGrid::Index idx;
+      for (idx(0) = lowerIdx(0); idx(0) <= upperIdx(0); ++idx(0))
+        for (idx(1) = lowerIdx(1); idx(1) <= upperIdx(1); ++idx(1)) {
+          const size_t cell = _grid.computeLinearIndex(idx);
+          const size_t end = cell + 1 < _grid.getNumCellsTot() ?
+            _grid.getCells()[cell + 1] : _indices.size();
+          for (size_t i = _grid.getCells()[cell]; i < end; ++i)
+            if ((_landmarks[_indices[i]] - point).squaredNorm() <= range2)
+              indices.push_back(_indices[i]);
+        }
+      std::sort(indices.begin(), indices.end());
+    }
+
+    void LandmarkGrid::getVisibleLandmarks(const Eigen::Vector3d& pose, double
+        maxRange, double fov, std::vector<size_t>& indices) const {
+      getLandmarksInRange(pose.head<2>(), maxRange, indices);
+      if (fov >= 2 * M_PI)
+        return;
+      size_t numVisible = 0;
+      for (size_t i = 0; i < indices.size(); ++i) {
+        const Eigen::Vector2d d = _landmarks[indices[i]] - pose.head<2>();
+        const double bearing = sm::kinematics::angleMod(
+          std::atan2(d(1), d(0)) - pose(2));
+        if (std::fabs(bearing) <= fov / 2)
+          indices[numVisible++] = indices[i];
+      }
+      indices.resize(numVisible);
+    }
+
+  }
+}
@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file benchmark-error-terms.cpp
+    \brief This file benchmarks the evaluation of the motion and observation
+           error terms on a simulated sine wave path.
+  */
+
+#include <cstdlib>
+#include <cmath>
+
+#include <iostream>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include <Eigen/Core>
+
+#include <sm/kinematics/rotations.hpp>
+
+#include <aslam/backend/ErrorTerm.hpp>
+
+#include <aslam/calibration/statistics/UniformDistribution.h>
+#include <aslam/calibration/statistics/NormalDistribution.h>
+#include <aslam/calibration/data-structures/VectorDesignVariable.h>
+#include <aslam/calibration/base/Timestamp.h>
+
+#include "aslam/calibration/2dlrf/utils.h"
+#include "aslam/calibration/2dlrf/ErrorTermMotion.h"
+#include "aslam/calibration/2dlrf/ErrorTermObservation.h"
+
+using namespace aslam::calibration;
+using namespace sm::kinematics;
+
+int main(int argc, char** argv) {
+  if (argc > 4) {
+    std::cerr << "Usage: " << argv[0]
+      << " [<num_steps>] [<num_landmarks>] [<num_runs>]" << std::endl;
+    return -1;
+  }
+  const size_t steps = argc > 1 ? atoi(argv[1]) : 5000;
+  const size_t nl = argc > 2 ? atoi(argv[2]) : 17;
+  const size_t numRuns = argc > 3 ? atoi(argv[3]) : 20;
+
+  // problem parameters of the online simulation
+  const double T = 0.1;
+  const Eigen::Vector3d Theta(0.219, 0.1, 0.78);
+  const Eigen::Vector3d Q_diag(0.00044, 1e-6, 0.00082);
+  const Eigen::Vector2d R_diag(0.00090, 0.00067);
+  const Eigen::Matrix3d Q = Q_diag.asDiagonal();
+  const Eigen::Matrix2d R = R_diag.asDiagonal();
+  std::vector<Eigen::Vector3d> u_true;
+  genSineWavePath(u_true, steps, 1.0, 0.01, T);
+  std::vector<Eigen::Vector2d> x_l;
+  UniformDistribution<double, 2>(Eigen::Vector2d(0, 0),
+    Eigen::Vector2d(30, 30)).getSamples(x_l, nl);
+  Eigen::Matrix<double, Eigen::Dynamic, 3> motionNoise;
+  NormalDistribution<3>(Eigen::Vector3d::Zero(), Q).getSamples(motionNoise,
+    steps);
+  Eigen::Matrix<double, Eigen::Dynamic, 2> observationNoise;
+  NormalDistribution<2>(Eigen::Vector2d::Zero(), R).getSamples(
+    observationNoise, steps * nl);
+
+  // design variables at the true values, every landmark is seen at each step
+  std::vector<boost::shared_ptr<VectorDesignVariable<3> > > dv_x;
+  dv_x.reserve(steps);
+  std::vector<boost::shared_ptr<VectorDesignVariable<2> > > dv_x_l;
+  dv_x_l.reserve(nl);
+  for (size_t j = 0; j < nl; ++j)
+    dv_x_l.push_back(boost::make_shared<VectorDesignVariable<2> >(x_l[j]));
+  auto dv_Theta = boost::make_shared<VectorDesignVariable<3> >(Theta);
+  std::vector<boost::shared_ptr<ErrorTermMotion> > e_mot;
+  e_mot.reserve(steps);
+  std::vector<boost::shared_ptr<ErrorTermObservation> > e_obs;
+  e_obs.reserve(steps * nl);
+  Eigen::Vector3d xk(1, 1, 0);
+  for (size_t i = 0; i < steps; ++i) {
+    if (i > 0) {
+      const double c = cos(xk(2));
+      const double s = sin(xk(2));
+      xk += T * Eigen::Vector3d(c * u_true[i](0) - s * u_true[i](1),
+        s * u_true[i](0) + c * u_true[i](1), u_true[i](2));
+      xk(2) = angleMod(xk(2));
+    }
+    dv_x.push_back(boost::make_shared<VectorDesignVariable<3> >(xk));
+    if (i > 0)
+      e_mot.push_back(boost::make_shared<ErrorTermMotion>(dv_x[i - 1].get(),
+        dv_x[i].get(), T, u_true[i] + motionNoise.row(i).transpose(), Q));
+    const double c = cos(xk(2));
+    const double s = sin(xk(2));
+    const Eigen::Vector2d sensor(xk(0) + Theta(0) * c - Theta(1) * s,
+      xk(1) + Theta(0) * s + Theta(1) * c);
+    for (size_t j = 0; j < nl; ++j) {
+      const Eigen::Vector2d d = x_l[j] - sensor;
+      e_obs.push_back(boost::make_shared<ErrorTermObservation>(
+        dv_x[i].get(), dv_x_l[j].get(), dv_Theta.get(),
+        d.norm() + observationNoise(i * nl + j, 0),
+        angleMod(atan2(d(1), d(0)) - xk(2) - Theta(2) +
+        observationNoise(i * nl + j, 1)), R));
+    }
+  }
+
+  // one Gauss-Newton iteration: error and Jacobians of each term in the
+  // order of the batches, an update of all the variables, and the errors
+  // again for the step acceptance
+  const double dx[3] = {1e-6, -1e-6, 1e-7};
+  double chi2 = 0;
+  const double before = Timestamp::now();
+  for (size_t r = 0; r < numRuns; ++r) {
+    for (size_t i = 0; i < steps; ++i) {
+      if (i > 0) {
+        aslam::backend::JacobianContainer J(3);
+        chi2 += e_mot[i - 1]->evaluateError();
+        e_mot[i - 1]->evaluateJacobians(J);
+      }
+      for (size_t j = 0; j < nl; ++j) {
+        aslam::backend::JacobianContainer J(2);
+        chi2 += e_obs[i * nl + j]->evaluateError();
+        e_obs[i * nl + j]->evaluateJacobians(J);
+      }
+    }
+    for (auto it = dv_x.cbegin(); it != dv_x.cend(); ++it)
+      (*it)->update(dx, 3);
+    for (auto it = dv_x_l.cbegin(); it != dv_x_l.cend(); ++it)
+      (*it)->update(dx, 2);
+    dv_Theta->update(dx, 3);
+    for (auto it = e_mot.cbegin(); it != e_mot.cend(); ++it)
+      chi2 += (*it)->evaluateError();
+    for (auto it = e_obs.cbegin(); it != e_obs.cend(); ++it)
+      chi2 += (*it)->evaluateError();
+  }
+  const double iterationTime = (Timestamp::now() - before) / numRuns;
+
+  std::cout << "error terms: " << e_mot.size() + e_obs.size() << std::endl;
+  std::cout << "  iteration [s]: " << iterationTime << std::endl;
+  std::cout << "  chi2: " << chi2 << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,392 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file benchmark-scaling.cpp
+    \brief This file benchmarks the incremental calibration against a single
+           batch optimization of the 2D-LRF problem for growing problem sizes.
+  */
+
+#include <cmath>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include <Eigen/Core>
+
+#include <sm/kinematics/rotations.hpp>
+
+#include <sm/BoostPropertyTree.hpp>
+
+#include <aslam/backend/Optimizer2Options.hpp>
+#include <aslam/backend/GaussNewtonTrustRegionPolicy.hpp>
+#include <aslam/backend/Optimizer2.hpp>
+
+#include <aslam/calibration/statistics/Randomizer.h>
+#include <aslam/calibration/statistics/RandomGenerator.h>
+#include <aslam/calibration/statistics/UniformDistribution.h>
+#include <aslam/calibration/statistics/NormalDistribution.h>
+#include <aslam/calibration/data-structures/VectorDesignVariable.h>
+#include <aslam/calibration/core/IncrementalEstimator.h>
+#include <aslam/calibration/core/OptimizationProblem.h>
+#include <aslam/calibration/base/Timestamp.h>
+#include <aslam-tsvd-solver/aslam-tsvd-solver.h>
+
+#include "aslam/calibration/2dlrf/utils.h"
+#include "aslam/calibration/2dlrf/LandmarkGrid.h"
+#include "aslam/calibration/2dlrf/ErrorTermMotion.h"
+#include "aslam/calibration/2dlrf/ErrorTermObservation.h"
+
+using namespace aslam::calibration;
+using namespace aslam::backend;
+using namespace sm::kinematics;
+using namespace sm;
+
+typedef aslam::backend::AslamTruncatedSvdSolver LinearSolver;
+
+namespace {
+
+  /// Simulated dataset of the 2D-LRF problem
+  struct Dataset {
+    /// Timestep size
+    double T;
+    /// Integrated odometry
+    std::vector<Eigen::Vector3d> x_odom;
+    /// Measured control input
+    std::vector<Eigen::Vector3d> u_noise;
+    /// Observations of the visible landmarks at each step
+    std::vector<std::vector<LandmarkObservation> > obs;
+    /// Landmarks guess
+    std::vector<Eigen::Vector2d> x_l_hat;
+    /// Covariance matrix for motion model
+    Eigen::Matrix3d Q;
+    /// Covariance matrix for observation model
+    Eigen::Matrix2d R;
+    /// True calibration parameters
+    Eigen::Vector3d Theta;
+    /// Guessed calibration parameters
+    Eigen::Vector3d Theta_hat;
+  };
+
+  /// Result of a calibration run
+  struct Result {
+    /// Elapsed time [s]
+    double time;
+    /// Peak memory usage of the linear solver [byte]
+    size_t peakMemory;
+    /// Number of flops of the linear solver over all solves
+    double flops;
+    /// Number of batches accepted
+    size_t numBatches;
+    /// Estimated calibration parameters
+    Eigen::Vector3d Theta;
+  };
+
+  /// Parses a whitespace-separated list of sizes
+  std::vector<size_t> parseSizes(const std::string& list) {
+    std::vector<size_t> sizes;
+    std::istringstream stream(list);
+    size_t size;
+    while (stream >> size)
+      sizes.push_back(size);
+    return sizes;
+  }
+
+  /// Simulates a dataset with a fixed seed
+  void simulate(const PropertyTree& config, size_t steps, size_t nl, int seed,
+      Dataset& data) {
+    Randomizer<double> randomizer;
+    randomizer.setSeed(seed);
+    RandomGenerator::setThreadStream(0);
+
+    data.T = config.getDouble("problem/timestep");
+    std::vector<Eigen::Vector3d> u_true;
+    genSineWavePath(u_true, steps,
+      config.getDouble("problem/sineWaveAmplitude"),
+      config.getDouble("problem/sineWaveFrequency"), data.T);
+    const Eigen::Vector2d min(config.getDouble("problem/groundMinX"),
+      config.getDouble("problem/groundMinY"));
+    const Eigen::Vector2d max(config.getDouble("problem/groundMaxX"),
+      config.getDouble("problem/groundMaxY"));
+    const double maxRange = config.getDouble("problem/observation/maxRange",
+      (max - min).norm());
+    const double fov = config.getDouble("problem/observation/fov", 2 * M_PI);
+    data.Q = Eigen::Matrix3d::Zero();
+    data.Q(0, 0) = config.getDouble("problem/motion/sigma2_x");
+    data.Q(1, 1) = config.getDouble("problem/motion/sigma2_y");
+    data.Q(2, 2) = config.getDouble("problem/motion/sigma2_t");
+    data.R = Eigen::Matrix2d::Zero();
+    data.R(0, 0) = config.getDouble("problem/observation/sigma2_r");
+    data.R(1, 1) = config.getDouble("problem/observation/sigma2_b");
+    data.Theta = Eigen::Vector3d(config.getDouble("problem/thetaTrue/x"),
+      config.getDouble("problem/thetaTrue/y"),
+      config.getDouble("problem/thetaTrue/t"));
+    data.Theta_hat = Eigen::Vector3d(config.getDouble("problem/thetaHat/x"),
+      config.getDouble("problem/thetaHat/y"),
+      config.getDouble("problem/thetaHat/t"));
+    std::vector<Eigen::Vector2d> x_l;
+    UniformDistribution<double, 2>(min, max).getSamples(x_l, nl);
+    const LandmarkGrid landmarkGrid(x_l, min, max, config.getDouble(
+      "problem/landmarkGridResolution", std::min(maxRange,
+      (max - min).minCoeff())));
+
+    const Eigen::Vector3d x_0(config.getDouble("problem/x0/x"),
+      config.getDouble("problem/x0/y"), config.getDouble("problem/x0/t"));
+    Eigen::Vector3d x_true = x_0;
+    data.x_odom.assign(1, x_0);
+    data.u_noise.assign(1, Eigen::Vector3d::Zero());
+    data.obs.assign(1, std::vector<LandmarkObservation>());
+    const NormalDistribution<3> motionNoise(Eigen::Vector3d::Zero(), data.Q);
+    const NormalDistribution<2> observationNoise(Eigen::Vector2d::Zero(),
+      data.R);
+    Eigen::Matrix<double, Eigen::Dynamic, 3> motionNoiseSamples;
+    motionNoise.getSamples(motionNoiseSamples, steps);
+    Eigen::Matrix<double, Eigen::Dynamic, 2> observationNoiseSamples;
+    std::vector<size_t> visible;
+    for (size_t i = 1; i < steps; ++i) {
+      Eigen::Matrix3d B = Eigen::Matrix3d::Identity();
+      B(0, 0) = cos(x_true(2));
+      B(0, 1) = -sin(x_true(2));
+      B(1, 0) = sin(x_true(2));
+      B(1, 1) = cos(x_true(2));
+      x_true += data.T * B * u_true[i];
+      x_true(2) = angleMod(x_true(2));
+      data.u_noise.push_back(u_true[i] +
+        motionNoiseSamples.row(i).transpose());
+      B(0, 0) = cos(data.x_odom[i - 1](2));
+      B(0, 1) = -sin(data.x_odom[i - 1](2));
+      B(1, 0) = sin(data.x_odom[i - 1](2));
+      B(1, 1) = cos(data.x_odom[i - 1](2));
+      Eigen::Vector3d xk = data.x_odom[i - 1] + data.T * B * data.u_noise[i];
+      xk(2) = angleMod(xk(2));
+      data.x_odom.push_back(xk);
+      const double ct = cos(x_true(2));
+      const double st = sin(x_true(2));
+      const Eigen::Vector3d sensorPose(x_true(0) + data.Theta(0) * ct -
+        data.Theta(1) * st, x_true(1) + data.Theta(0) * st + data.Theta(1) *
+        ct, x_true(2) + data.Theta(2));
+      landmarkGrid.getVisibleLandmarks(sensorPose, maxRange, fov, visible);
+      observationNoise.getSamples(observationNoiseSamples, visible.size());
+      std::vector<LandmarkObservation> obsk;
+      obsk.reserve(visible.size());
+      for (size_t k = 0; k < visible.size(); ++k) {
+        const double aa = x_l[visible[k]](0) - sensorPose(0);
+        const double bb = x_l[visible[k]](1) - sensorPose(1);
+        obsk.push_back(LandmarkObservation(visible[k], sqrt(aa * aa + bb * bb)
+          + observationNoiseSamples(k, 0), angleMod(atan2(bb, aa) -
+          sensorPose(2) + observationNoiseSamples(k, 1))));
+      }
+      data.obs.push_back(obsk);
+    }
+    initLandmarks(data.x_l_hat, data.x_odom, data.Theta_hat, data.obs, nl);
+  }
+
+  /// Creates the landmarks design variables
+  void createLandmarks(const Dataset& data,
+      std::vector<boost::shared_ptr<VectorDesignVariable<2> > >& dv_x_l) {
+    dv_x_l.clear();
+    dv_x_l.reserve(data.x_l_hat.size());
+    for (auto it = data.x_l_hat.cbegin(); it != data.x_l_hat.cend(); ++it) {
+      dv_x_l.push_back(boost::make_shared<VectorDesignVariable<2> >(*it));
+      dv_x_l.back()->setActive(true);
+    }
+  }
+
+  /// Runs the incremental calibration
+  Result runIncremental(const PropertyTree& config, const Dataset& data,
+      size_t batchSize) {
+    std::vector<boost::shared_ptr<VectorDesignVariable<2> > > dv_x_l;
+    createLandmarks(data, dv_x_l);
+    auto dv_Theta = boost::make_shared<VectorDesignVariable<3> >(
+      data.Theta_hat);
+    dv_Theta->setActive(true);
+    IncrementalEstimator estimator(PropertyTree(config, "estimator"));
+    Result result = {0.0, 0, 0.0, 0, Eigen::Vector3d::Zero()};
+    const size_t steps = data.x_odom.size();
+    std::vector<bool> l_batch(dv_x_l.size(), false);
+    const double before = Timestamp::now();
+    for (size_t i = 0; i < steps; i += batchSize) {
+      auto batch = boost::make_shared<IncrementalEstimator::Batch>();
+      auto dv_xkm1 = boost::make_shared<VectorDesignVariable<3> >(
+        data.x_odom[i]);
+      dv_xkm1->setActive(true);
+      batch->addDesignVariable(dv_xkm1, 0);
+      batch->addDesignVariable(dv_Theta, 2);
+      std::vector<size_t> l_batch_idx;
+      for (size_t j = i + 1; j < i + batchSize && j < steps; ++j)
+        for (auto it = data.obs[j].cbegin(); it != data.obs[j].cend(); ++it)
+          if (!l_batch[it->landmark]) {
+            l_batch[it->landmark] = true;
+            l_batch_idx.push_back(it->landmark);
+          }
+      std::sort(l_batch_idx.begin(), l_batch_idx.end());
+      for (auto it = l_batch_idx.cbegin(); it != l_batch_idx.cend(); ++it) {
+        batch->addDesignVariable(dv_x_l[*it], 1);
+        l_batch[*it] = false;
+      }
+      for (size_t j = i + 1; j < i + batchSize && j < steps; ++j) {
+        auto dv_xk = boost::make_shared<VectorDesignVariable<3> >(
+          data.x_odom[j]);
+        dv_xk->setActive(true);
+        batch->addDesignVariable(dv_xk, 0);
+        batch->addErrorTerm(boost::make_shared<ErrorTermMotion>(dv_xkm1.get(),
+          dv_xk.get(), data.T, data.u_noise[j], data.Q));
+        for (auto it = data.obs[j].cbegin(); it != data.obs[j].cend(); ++it)
+          batch->addErrorTerm(boost::make_shared<ErrorTermObservation>(
+            dv_xk.get(), dv_x_l[it->landmark].get(), dv_Theta.get(), it->r,
+            it->b, data.R));
+        dv_xkm1 = dv_xk;
+      }
+      const IncrementalEstimator::ReturnValue ret = estimator.addBatch(batch);
+      if (ret.batchAccepted)
+        result.numBatches++;
+      result.peakMemory = std::max(result.peakMemory,
+        estimator.getPeakMemoryUsage());
+    }
+    result.time = Timestamp::now() - before;
+    result.flops = estimator.getTotalNumFlops();
+    result.Theta = dv_Theta->getValue();
+    return result;
+  }
+
+  /// Runs a single batch optimization over the whole dataset
+  Result runBatch(const PropertyTree& config, const Dataset& data) {
+    std::vector<boost::shared_ptr<VectorDesignVariable<2> > > dv_x_l;
+    createLandmarks(data, dv_x_l);
+    auto dv_Theta = boost::make_shared<VectorDesignVariable<3> >(
+      data.Theta_hat);
+    dv_Theta->setActive(true);
+    Result result = {0.0, 0, 0.0, 1, Eigen::Vector3d::Zero()};
+    const double before = Timestamp::now();
+    auto problem = boost::make_shared<OptimizationProblem>();
+    problem->addDesignVariable(dv_Theta, 2);
+    const size_t steps = data.x_odom.size();
+    std::vector<boost::shared_ptr<VectorDesignVariable<3> > > dv_x;
+    dv_x.reserve(steps);
+    for (size_t i = 0; i < steps; ++i) {
+      dv_x.push_back(boost::make_shared<VectorDesignVariable<3> >(
+        data.x_odom[i]));
+      dv_x[i]->setActive(true);
+      problem->addDesignVariable(dv_x[i], 0);
+    }
+    std::vector<bool> l_observed(dv_x_l.size(), false);
+    for (size_t i = 1; i < steps; ++i)
+      for (auto it = data.obs[i].cbegin(); it != data.obs[i].cend(); ++it)
+        l_observed[it->landmark] = true;
+    for (size_t i = 0; i < dv_x_l.size(); ++i)
+      if (l_observed[i])
+        problem->addDesignVariable(dv_x_l[i], 1);
+    problem->setGroupsOrdering({0, 1, 2});
+    for (size_t i = 1; i < steps; ++i) {
+      problem->addErrorTerm(boost::make_shared<ErrorTermMotion>(
+        dv_x[i - 1].get(), dv_x[i].get(), data.T, data.u_noise[i], data.Q));
+      for (auto it = data.obs[i].cbegin(); it != data.obs[i].cend(); ++it)
+        problem->addErrorTerm(boost::make_shared<ErrorTermObservation>(
+          dv_x[i].get(), dv_x_l[it->landmark].get(), dv_Theta.get(), it->r,
+          it->b, data.R));
+    }
+    Optimizer2 optimizer(PropertyTree(config, "estimator/optimizer"),
+      boost::make_shared<LinearSolver>(PropertyTree(config,
+      "estimator/optimizer/linearSolver")),
+      boost::make_shared<GaussNewtonTrustRegionPolicy>());
+    optimizer.setProblem(problem);
+    size_t JCols = 0;
+    for (auto it = problem->getGroupsOrdering().cbegin();
+        it != problem->getGroupsOrdering().cend(); ++it)
+      JCols += problem->getGroupDim(*it);
+    auto linearSolver = optimizer.getSolver<LinearSolver>();
+    linearSolver->setMargStartIndex(JCols - problem->getGroupDim(2));
+    optimizer.optimize();
+    linearSolver->analyzeMarginal();
+    result.time = Timestamp::now() - before;
+    result.peakMemory = linearSolver->getPeakMemoryUsage();
+    result.flops = linearSolver->getNumFlops();
+    result.Theta = dv_Theta->getValue();
+    return result;
+  }
+
+  /// Writes a result line in CSV format
+  void writeResult(std::ostream& stream, const std::string& mode,
+      size_t steps, size_t nl, size_t batchSize, int seed,
+      const Dataset& data, const Result& result) {
+    stream << mode << "," << steps << "," << nl << "," << batchSize << ","
+      << seed << "," << result.time << "," << result.peakMemory << ","
+      << result.flops << "," << result.numBatches << ","
+      << result.Theta(0) << "," << result.Theta(1) << "," << result.Theta(2)
+      << "," << (result.Theta.head<2>() - data.Theta.head<2>()).norm() << ","
+      << std::fabs(angleMod(result.Theta(2) - data.Theta(2))) << std::endl;
+  }
+
+}
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " <conf_file> <csv_file>"
+      << std::endl;
+    return -1;
+  }
+
+  // load configuration file
+  BoostPropertyTree propertyTree;
+  propertyTree.loadXml(argv[1]);
+  const PropertyTree config(propertyTree, "lrf");
+  RandomGenerator::setEnabled(
+    config.getBool("problem/threadRandomGenerator", false));
+
+  // sweep parameters
+  const std::vector<size_t> stepsSweep = parseSizes(
+    config.getString("benchmark/steps"));
+  const std::vector<size_t> landmarksSweep = parseSizes(
+    config.getString("benchmark/numLandmarks"));
+  const std::vector<size_t> batchSizeSweep = parseSizes(
+    config.getString("benchmark/batchSize"));
+  const int seed = config.getInt("benchmark/seed", 0);
+  const bool runOffline = config.getBool("benchmark/offline", true);
+
+  std::ofstream csv(argv[2]);
+  csv << "mode,steps,landmarks,batch_size,seed,time_s,peak_memory_bytes,"
+    "flops,num_batches,theta_x,theta_y,theta_t,error_xy,error_t" << std::endl;
+  for (auto steps = stepsSweep.cbegin(); steps != stepsSweep.cend(); ++steps)
+    for (auto nl = landmarksSweep.cbegin(); nl != landmarksSweep.cend();
+        ++nl) {
+      // the same dataset is used by all the runs of a size
+      Dataset data;
+      simulate(config, *steps, *nl, seed, data);
+      for (auto batchSize = batchSizeSweep.cbegin();
+          batchSize != batchSizeSweep.cend(); ++batchSize) {
+        std::cout << "incremental: " << *steps << " steps, " << *nl
+          << " landmarks, batch size " << *batchSize << std::endl;
+        writeResult(csv, "incremental", *steps, *nl, *batchSize, seed, data,
+          runIncremental(config, data, *batchSize));
+      }
+      if (runOffline) {
+        std::cout << "batch: " << *steps << " steps, " << *nl << " landmarks"
+          << std::endl;
+        writeResult(csv, "batch", *steps, *nl, *steps, seed, data,
+          runBatch(config, data));
+      }
+    }
+
+  return 0;
+}
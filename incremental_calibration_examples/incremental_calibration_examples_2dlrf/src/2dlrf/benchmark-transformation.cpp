@@ -0,0 +1,142 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file benchmark-transformation.cpp
+    \brief This file benchmarks the batched point transformation and the
+           composition of transformations against the per-point path.
+  */
+
+#include <cstdlib>
+
+#include <iostream>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/StdVector>
+
+#include <aslam/calibration/geometry/Transformation.h>
+#include <aslam/calibration/base/Timestamp.h>
+
+using namespace aslam::calibration;
+
+namespace {
+
+  /// Benchmarks the point transformations of a given dimension
+  template <int M>
+  void benchmark(const Transformation<double, M>& transformation,
+      size_t numPoints, size_t numRuns) {
+    typedef Eigen::Matrix<double, M, 1> Point;
+    typedef Eigen::Matrix<double, M, Eigen::Dynamic> Points;
+    const Points points = Points::Random(M, numPoints);
+    Points perPoint(M, numPoints);
+    Points batched(M, numPoints);
+
+    double before = Timestamp::now();
+    for (size_t r = 0; r < numRuns; ++r)
+      for (size_t i = 0; i < numPoints; ++i)
+        perPoint.col(i) = transformation(Point(points.col(i)));
+    const double perPointTime = (Timestamp::now() - before) / numRuns;
+
+    before = Timestamp::now();
+    for (size_t r = 0; r < numRuns; ++r)
+      transformation.transform(points, batched);
+    const double batchedTime = (Timestamp::now() - before) / numRuns;
+
+    std::cout << M << "D points: " << numPoints << std::endl;
+    std::cout << "  per-point [s]: " << perPointTime << std::endl;
+    std::cout << "  batched [s]: " << batchedTime << std::endl;
+    std::cout << "  speedup: " << perPointTime / batchedTime << std::endl;
+    std::cout << "  max difference: "
+      << (perPoint - batched).cwiseAbs().maxCoeff() << std::endl;
+  }
+
+  /// Benchmarks the composition of a sequence of transformations
+  template <int M>
+  void benchmarkCompose(const std::vector<Transformation<double, M>,
+      Eigen::aligned_allocator<Transformation<double, M> > >& sequence,
+      size_t numRuns) {
+    typedef Eigen::Matrix<double, M + 1, M + 1> Matrix;
+    Transformation<double, M> chained(Matrix::Identity().eval());
+    double before = Timestamp::now();
+    for (size_t r = 0; r < numRuns; ++r) {
+      chained = Transformation<double, M>(Matrix::Identity().eval());
+      for (auto it = sequence.cbegin(); it != sequence.cend(); ++it)
+        chained = chained * *it;
+    }
+    const double chainedTime = (Timestamp::now() - before) / numRuns;
+
+    Matrix product = Matrix::Identity();
+    before = Timestamp::now();
+    for (size_t r = 0; r < numRuns; ++r) {
+      product = Matrix::Identity();
+      for (auto it = sequence.cbegin(); it != sequence.cend(); ++it)
+        product = product * it->getTransformationMatrix();
+    }
+    const double matrixTime = (Timestamp::now() - before) / numRuns;
+
+    Transformation<double, M> composed(product);
+    before = Timestamp::now();
+    for (size_t r = 0; r < numRuns; ++r)
+      composed = Transformation<double, M>::compose(sequence.cbegin(),
+        sequence.cend());
+    const double composeTime = (Timestamp::now() - before) / numRuns;
+
+    std::cout << M << "D compositions: " << sequence.size() << std::endl;
+    std::cout << "  chained products [s]: " << chainedTime << std::endl;
+    std::cout << "  homogeneous products [s]: " << matrixTime << std::endl;
+    std::cout << "  compose [s]: " << composeTime << std::endl;
+    std::cout << "  speedup: " << chainedTime / composeTime << std::endl;
+    std::cout << "  max difference: "
+      << (chained.getTransformationMatrix() -
+      composed.getTransformationMatrix()).cwiseAbs().maxCoeff()
+      << std::endl;
+  }
+
+}
+
+int main(int argc, char** argv) {
+  if (argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " [<num_points>] [<num_runs>]"
+      << std::endl;
+    return -1;
+  }
+  const size_t numPoints = argc > 1 ? atoi(argv[1]) : 100000;
+  const size_t numRuns = argc > 2 ? atoi(argv[2]) : 10;
+
+  benchmark<2>(Transformation<double, 2>(0.219, 0.1, 0.78), numPoints,
+    numRuns);
+  benchmark<3>(Transformation<double, 3>(0.5, -0.2, 1.0, 0.1, 0.2, 0.3),
+    numPoints, numRuns);
+
+  // odometry-like chains of small increments
+  std::vector<Transformation<double, 2>,
+    Eigen::aligned_allocator<Transformation<double, 2> > > sequence2d;
+  std::vector<Transformation<double, 3>,
+    Eigen::aligned_allocator<Transformation<double, 3> > > sequence3d;
+  sequence2d.reserve(numPoints);
+  sequence3d.reserve(numPoints);
+  for (size_t i = 0; i < numPoints; ++i) {
+    sequence2d.push_back(Transformation<double, 2>(0.1, 0.0, 1e-3));
+    sequence3d.push_back(Transformation<double, 3>(0.1, 0.0, 0.0, 0.0, 0.0,
+      1e-3));
+  }
+  benchmarkCompose<2>(sequence2d, numRuns);
+  benchmarkCompose<3>(sequence3d, numRuns);
+
+  return 0;
+}
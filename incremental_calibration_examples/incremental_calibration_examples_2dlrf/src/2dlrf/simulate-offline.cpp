@@ -42,6 +42,7 @@
 #include <aslam/calibration/core/OptimizationProblem.h>
 #include <aslam/calibration/statistics/UniformDistribution.h>
 #include <aslam/calibration/statistics/NormalDistribution.h>
+#include <aslam/calibration/statistics/RandomGenerator.h>
 #include <aslam/calibration/data-structures/VectorDesignVariable.h>
 #include <aslam/calibration/geometry/Transformation.h>
 #include <aslam/calibration/base/Timestamp.h>
@@ -67,6 +68,10 @@ int main(int argc, char** argv) {
   BoostPropertyTree propertyTree;
   propertyTree.loadXml(argv[1]);
 
+  // sample from the per-thread generators instead of random()
+  RandomGenerator::setEnabled(
+    propertyTree.getBool("lrf/problem/threadRandomGenerator", false));
+
   // steps to simulate
   const size_t steps = propertyTree.getInt("lrf/problem/steps");
 
@@ -146,6 +151,13 @@ int main(int argc, char** argv) {
   x_odom.push_back(x_0);
   u_noise.push_back(Eigen::Vector3d::Zero());
 
+  // noise distributions, the covariances are factorized only once
+  const NormalDistribution<3> motionNoise(Eigen::Vector3d::Zero(), Q);
+  const NormalDistribution<2> observationNoise(Eigen::Vector2d::Zero(), R);
+  Eigen::Matrix<double, Eigen::Dynamic, 3> motionNoiseSamples;
+  motionNoise.getSamples(motionNoiseSamples, steps);
+  Eigen::Matrix<double, Eigen::Dynamic, 2> observationNoiseSamples;
+
   // simulate
   for (size_t i = 1; i < steps; ++i) {
     Eigen::Matrix3d B = Eigen::Matrix3d::Identity();
@@ -156,8 +168,7 @@ int main(int argc, char** argv) {
     Eigen::Vector3d xk = x_true[i - 1] + T * B * u_true[i];
     xk(2) = angleMod(xk(2));
     x_true.push_back(xk);
-    u_noise.push_back(u_true[i] +
-      NormalDistribution<3>(Eigen::Vector3d::Zero(), Q).getSample());
+    u_noise.push_back(u_true[i] + motionNoiseSamples.row(i).transpose());
     B(0, 0) = cos(x_odom[i - 1](2));
     B(0, 1) = -sin(x_odom[i - 1](2));
     B(1, 0) = sin(x_odom[i - 1](2));
@@ -167,6 +178,7 @@ int main(int argc, char** argv) {
     x_odom.push_back(xk);
     const double ct = cos(x_true[i](2));
     const double st = sin(x_true[i](2));
+    observationNoise.getSamples(observationNoiseSamples, nl);
     std::vector<double> rk(nl, 0);
     std::vector<double> bk(nl, 0);
     for (size_t j = 0; j < nl; ++j) {
@@ -175,10 +187,10 @@ int main(int argc, char** argv) {
       const double bb = x_l[j](1) - x_true[i](1) - Theta(0) * st -
         Theta(1) * ct;
       const double range = sqrt(aa * aa + bb * bb) +
-        NormalDistribution<1>(0, R(0, 0)).getSample();
+        observationNoiseSamples(j, 0);
       rk[j] = range;
       bk[j] = angleMod(atan2(bb, aa) - x_true[i](2) - Theta(2) +
-        NormalDistribution<1>(0, R(1, 1)).getSample());
+        observationNoiseSamples(j, 1));
     }
     r.push_back(rk);
     b.push_back(bk);
@@ -320,8 +332,7 @@ int main(int argc, char** argv) {
   }
   Transformation<double, 3> trans(threePointSvd(l, l_est));
   Eigen::MatrixXd l_est_trans = Eigen::MatrixXd::Zero(3, nl);
-  for (size_t i = 0; i < nl; ++i)
-    l_est_trans.col(i) = trans(l_est.col(i));
+  trans.transform(l_est, l_est_trans);
   std::ofstream l_est_trans_log("l_est_trans.txt");
   for (size_t i = 0; i < nl; ++i)
     l_est_trans_log << l_est_trans.col(i).head<2>().transpose() << std::endl;
@@ -25,6 +25,7 @@
 #include <iomanip>
 #include <fstream>
 #include <vector>
+#include <algorithm>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
@@ -40,6 +41,7 @@
 
 #include <aslam/calibration/statistics/UniformDistribution.h>
 #include <aslam/calibration/statistics/NormalDistribution.h>
+#include <aslam/calibration/statistics/RandomGenerator.h>
 #include <aslam/calibration/data-structures/VectorDesignVariable.h>
 #include <aslam/calibration/geometry/Transformation.h>
 #include <aslam/calibration/core/IncrementalEstimator.h>
@@ -48,6 +50,7 @@
 #include <aslam/calibration/base/Timestamp.h>
 
 #include "aslam/calibration/2dlrf/utils.h"
+#include "aslam/calibration/2dlrf/LandmarkGrid.h"
 #include "aslam/calibration/2dlrf/ErrorTermMotion.h"
 #include "aslam/calibration/2dlrf/ErrorTermObservation.h"
 
@@ -65,6 +68,10 @@ int main(int argc, char** argv) {
   BoostPropertyTree propertyTree;
   propertyTree.loadXml(argv[1]);
 
+  // sample from the per-thread generators instead of random()
+  RandomGenerator::setEnabled(
+    propertyTree.getBool("lrf/problem/threadRandomGenerator", false));
+
   // steps to simulate
   const size_t steps = propertyTree.getInt("lrf/problem/steps");
 
@@ -100,15 +107,16 @@ int main(int argc, char** argv) {
   const Eigen::Vector2d max(propertyTree.getDouble("lrf/problem/groundMaxX"),
     propertyTree.getDouble("lrf/problem/groundMaxY"));
 
-  // bearing measurements
-  std::vector<std::vector<double> > b;
-  b.reserve(steps);
-  b.push_back(std::vector<double>(nl, 0));
+  // range and bearing measurements of the visible landmarks
+  std::vector<std::vector<LandmarkObservation> > obs;
+  obs.reserve(steps);
+  obs.push_back(std::vector<LandmarkObservation>());
 
-  // range measurements
-  std::vector<std::vector<double> > r;
-  r.reserve(steps);
-  r.push_back(std::vector<double>(nl, 0));
+  // sensor range and field of view, everything is visible by default
+  const double maxRange = propertyTree.getDouble(
+    "lrf/problem/observation/maxRange", (max - min).norm());
+  const double fov = propertyTree.getDouble("lrf/problem/observation/fov",
+    2 * M_PI);
 
   // covariance matrix for motion model
   Eigen::Matrix3d Q = Eigen::Matrix3d::Zero();
@@ -125,6 +133,11 @@ int main(int argc, char** argv) {
   std::vector<Eigen::Vector2d> x_l;
   UniformDistribution<double, 2>(min, max).getSamples(x_l, nl);
 
+  // spatial index over the landmarks
+  const LandmarkGrid landmarkGrid(x_l, min, max, propertyTree.getDouble(
+    "lrf/problem/landmarkGridResolution", std::min(maxRange,
+    (max - min).minCoeff())));
+
   // true calibration parameters
   const Eigen::Vector3d Theta(propertyTree.getDouble("lrf/problem/thetaTrue/x"),
     propertyTree.getDouble("lrf/problem/thetaTrue/y"),
@@ -144,6 +157,13 @@ int main(int argc, char** argv) {
   x_odom.push_back(x_0);
   u_noise.push_back(Eigen::Vector3d::Zero());
 
+  // noise distributions, the covariances are factorized only once
+  const NormalDistribution<3> motionNoise(Eigen::Vector3d::Zero(), Q);
+  const NormalDistribution<2> observationNoise(Eigen::Vector2d::Zero(), R);
+  Eigen::Matrix<double, Eigen::Dynamic, 3> motionNoiseSamples;
+  motionNoise.getSamples(motionNoiseSamples, steps);
+  Eigen::Matrix<double, Eigen::Dynamic, 2> observationNoiseSamples;
+
   // simulate
   for (size_t i = 1; i < steps; ++i) {
     Eigen::Matrix3d B = Eigen::Matrix3d::Identity();
@@ -154,8 +174,7 @@ int main(int argc, char** argv) {
     Eigen::Vector3d xk = x_true[i - 1] + T * B * u_true[i];
     xk(2) = angleMod(xk(2));
     x_true.push_back(xk);
-    u_noise.push_back(u_true[i] +
-      NormalDistribution<3>(Eigen::Vector3d::Zero(), Q).getSample());
+    u_noise.push_back(u_true[i] + motionNoiseSamples.row(i).transpose());
     B(0, 0) = cos(x_odom[i - 1](2));
     B(0, 1) = -sin(x_odom[i - 1](2));
     B(1, 0) = sin(x_odom[i - 1](2));
@@ -165,26 +184,29 @@ int main(int argc, char** argv) {
     x_odom.push_back(xk);
     const double ct = cos(x_true[i](2));
     const double st = sin(x_true[i](2));
-    std::vector<double> rk(nl, 0);
-    std::vector<double> bk(nl, 0);
-    for (size_t j = 0; j < nl; ++j) {
-      const double aa = x_l[j](0) - x_true[i](0) - Theta(0) * ct +
-        Theta(1) * st;
-      const double bb = x_l[j](1) - x_true[i](1) - Theta(0) * st -
-        Theta(1) * ct;
+    const Eigen::Vector3d sensorPose(x_true[i](0) + Theta(0) * ct -
+      Theta(1) * st, x_true[i](1) + Theta(0) * st + Theta(1) * ct,
+      x_true[i](2) + Theta(2));
+    std::vector<size_t> visible;
+    landmarkGrid.getVisibleLandmarks(sensorPose, maxRange, fov, visible);
+    observationNoise.getSamples(observationNoiseSamples, visible.size());
+    std::vector<LandmarkObservation> obsk;
+    obsk.reserve(visible.size());
+    for (size_t k = 0; k < visible.size(); ++k) {
+      const size_t j = visible[k];
+      const double aa = x_l[j](0) - sensorPose(0);
+      const double bb = x_l[j](1) - sensorPose(1);
       const double range = sqrt(aa * aa + bb * bb) +
-        NormalDistribution<1>(0, R(0, 0)).getSample();
-      rk[j] = range;
-      bk[j] = angleMod(atan2(bb, aa) - x_true[i](2) - Theta(2) +
-        NormalDistribution<1>(0, R(1, 1)).getSample());
+        observationNoiseSamples(k, 0);
+      obsk.push_back(LandmarkObservation(j, range, angleMod(atan2(bb, aa) -
+        x_true[i](2) - Theta(2) + observationNoiseSamples(k, 1))));
     }
-    r.push_back(rk);
-    b.push_back(bk);
+    obs.push_back(obsk);
   }
 
   // landmark guess
   std::vector<Eigen::Vector2d> x_l_hat;
-  initLandmarks(x_l_hat, x_odom, Theta_hat, r, b);
+  initLandmarks(x_l_hat, x_odom, Theta_hat, obs, nl);
 
   // create landmarks design variables
   std::vector<boost::shared_ptr<VectorDesignVariable<2> > > dv_x_l;
@@ -207,6 +229,10 @@ int main(int argc, char** argv) {
   // batch size
   const size_t batchSize = propertyTree.getInt("lrf/estimator/batchSize");
 
+  // landmarks observed in the current batch and in any batch
+  std::vector<bool> l_batch(nl, false);
+  std::vector<bool> l_observed(nl, false);
+
   // run over the dataset
   for (size_t i = 0; i < steps; i += batchSize) {
 
@@ -221,9 +247,20 @@ int main(int argc, char** argv) {
     // add the calibration variable to the batch
     batch->addDesignVariable(dv_Theta, 2);
 
-    // add the landmarks in the story
-    for (size_t k = 0; k < nl; ++k)
-      batch->addDesignVariable(dv_x_l[k], 1);
+    // add the landmarks observed in the batch
+    std::vector<size_t> l_batch_idx;
+    for (size_t j = i + 1; j < i + batchSize && j < steps; ++j)
+      for (auto it = obs[j].cbegin(); it != obs[j].cend(); ++it)
+        if (!l_batch[it->landmark]) {
+          l_batch[it->landmark] = true;
+          l_batch_idx.push_back(it->landmark);
+        }
+    std::sort(l_batch_idx.begin(), l_batch_idx.end());
+    for (auto it = l_batch_idx.cbegin(); it != l_batch_idx.cend(); ++it) {
+      batch->addDesignVariable(dv_x_l[*it], 1);
+      l_batch[*it] = false;
+      l_observed[*it] = true;
+    }
 
     // create other state variables and error terms
     for (size_t j = i + 1; j < i + batchSize && j < steps; ++j) {
@@ -240,9 +277,9 @@ int main(int argc, char** argv) {
       batch->addErrorTerm(e_mot);
 
       // observation error terms
-      for (size_t k = 0; k < nl; ++k) {
+      for (auto it = obs[j].cbegin(); it != obs[j].cend(); ++it) {
         auto e_obs = boost::make_shared<ErrorTermObservation>(dv_xk.get(),
-          dv_x_l[k].get(), dv_Theta.get(), r[j][k], b[j][k], R);
+          dv_x_l[it->landmark].get(), dv_Theta.get(), it->r, it->b, R);
         batch->addErrorTerm(e_obs);
       }
       // switch state variable
@@ -341,21 +378,25 @@ int main(int argc, char** argv) {
   for (size_t i = 0; i < nl; ++i)
     l_log << x_l[i].transpose() << std::endl;
 
-  // align landmarks
-  Eigen::MatrixXd l = Eigen::MatrixXd::Zero(3, nl);
-  Eigen::MatrixXd l_est = Eigen::MatrixXd::Zero(3, nl);
-  for (size_t i = 0; i < nl; ++i) {
-    l(0, i) = x_l[i](0);
-    l(1, i) = x_l[i](1);
-    l_est(0, i) = dv_x_l[i]->getValue()(0);
-    l_est(1, i) = dv_x_l[i]->getValue()(1);
+  // align landmarks, the never observed ones were not estimated
+  const size_t nlo = std::count(l_observed.begin(), l_observed.end(), true);
+  std::cout << "observed landmarks: " << nlo << " out of " << nl << std::endl;
+  Eigen::MatrixXd l = Eigen::MatrixXd::Zero(3, nlo);
+  Eigen::MatrixXd l_est = Eigen::MatrixXd::Zero(3, nlo);
+  for (size_t i = 0, k = 0; i < nl; ++i) {
+    if (!l_observed[i])
+      continue;
+    l(0, k) = x_l[i](0);
+    l(1, k) = x_l[i](1);
+    l_est(0, k) = dv_x_l[i]->getValue()(0);
+    l_est(1, k) = dv_x_l[i]->getValue()(1);
+    ++k;
   }
   Transformation<double, 3> trans(threePointSvd(l, l_est));
-  Eigen::MatrixXd l_est_trans = Eigen::MatrixXd::Zero(3, nl);
-  for (size_t i = 0; i < nl; ++i)
-    l_est_trans.col(i) = trans(l_est.col(i));
+  Eigen::MatrixXd l_est_trans = Eigen::MatrixXd::Zero(3, nlo);
+  trans.transform(l_est, l_est_trans);
   std::ofstream l_est_trans_log("l_est_trans.txt");
-  for (size_t i = 0; i < nl; ++i)
+  for (size_t i = 0; i < nlo; ++i)
     l_est_trans_log << l_est_trans.col(i).head<2>().transpose() << std::endl;
 
   // align poses
@@ -21,6 +21,7 @@
            mode.
   */
 
+#include <iostream>
 #include <vector>
 
 #include <boost/make_shared.hpp>
@@ -30,6 +31,8 @@
 #include <sm/kinematics/rotations.hpp>
 #include <sm/kinematics/three_point_methods.hpp>
 
+#include <sm/BoostPropertyTree.hpp>
+
 #include <aslam/backend/OptimizationProblem.hpp>
 #include <aslam/backend/Optimizer2Options.hpp>
 #include <aslam/backend/SparseQrLinearSystemSolver.hpp>
@@ -39,6 +42,7 @@
 
 #include <aslam/calibration/statistics/UniformDistribution.h>
 #include <aslam/calibration/statistics/NormalDistribution.h>
+#include <aslam/calibration/statistics/RandomGenerator.h>
 #include <aslam/calibration/data-structures/VectorDesignVariable.h>
 #include <aslam/calibration/geometry/Transformation.h>
 #include <aslam/calibration/base/Timestamp.h>
@@ -51,8 +55,23 @@
 using namespace aslam::calibration;
 using namespace aslam::backend;
 using namespace sm::kinematics;
+using namespace sm;
 
 int main(int argc, char** argv) {
+  if (argc > 2) {
+    std::cerr << "Usage: " << argv[0] << " [conf_file]" << std::endl;
+    return -1;
+  }
+
+  // load the optional configuration file
+  BoostPropertyTree propertyTree;
+  if (argc == 2)
+    propertyTree.loadXml(argv[1]);
+
+  // sample from the per-thread generators instead of random()
+  RandomGenerator::setEnabled(
+    propertyTree.getBool("lrf/problem/threadRandomGenerator", false));
+
   // steps to simulate
   const size_t steps = 5000;
 
@@ -125,6 +144,15 @@ int main(int argc, char** argv) {
   x_odom.push_back(x_0);
   u_noise.push_back(Eigen::Matrix<double, 3, 1>::Zero());
 
+  // noise distributions, the covariances are factorized only once
+  const NormalDistribution<3> motionNoise(Eigen::Matrix<double, 3, 1>::Zero(),
+    Q);
+  const NormalDistribution<2> observationNoise(
+    Eigen::Matrix<double, 2, 1>::Zero(), R);
+  Eigen::Matrix<double, Eigen::Dynamic, 3> motionNoiseSamples;
+  motionNoise.getSamples(motionNoiseSamples, steps);
+  Eigen::Matrix<double, Eigen::Dynamic, 2> observationNoiseSamples;
+
   // simulate
   for (size_t i = 1; i < steps; ++i) {
     Eigen::Matrix<double, 3, 3> B = Eigen::Matrix<double, 3, 3>::Identity();
@@ -135,8 +163,7 @@ int main(int argc, char** argv) {
     Eigen::Matrix<double, 3, 1> xk = x_true[i - 1] + T * B * u_true[i];
     xk(2) = angleMod(xk(2));
     x_true.push_back(xk);
-    u_noise.push_back(u_true[i] + NormalDistribution<3>(
-      Eigen::Matrix<double, 3, 1>::Zero(), Q).getSample());
+    u_noise.push_back(u_true[i] + motionNoiseSamples.row(i).transpose());
     B(0, 0) = cos(x_odom[i - 1](2));
     B(0, 1) = -sin(x_odom[i - 1](2));
     B(1, 0) = sin(x_odom[i - 1](2));
@@ -146,6 +173,7 @@ int main(int argc, char** argv) {
     x_odom.push_back(xk);
     const double ct = cos(x_true[i](2));
     const double st = sin(x_true[i](2));
+    observationNoise.getSamples(observationNoiseSamples, nl);
     std::vector<double> rk(nl, 0);
     std::vector<double> bk(nl, 0);
     for (size_t j = 0; j < nl; ++j) {
@@ -153,11 +181,11 @@ int main(int argc, char** argv) {
         Theta(1) * st;
       const double bb = x_l[j](1) - x_true[i](1) - Theta(0) * st -
         Theta(1) * ct;
-      const double range = sqrt(aa * aa + bb * bb) + NormalDistribution<1>(
-        0, R(0, 0)).getSample();
+      const double range = sqrt(aa * aa + bb * bb) +
+        observationNoiseSamples(j, 0);
       rk[j] = range;
       bk[j] = angleMod(atan2(bb, aa) - x_true[i](2) - Theta(2) +
-        NormalDistribution<1>(0, R(1, 1)).getSample());
+        observationNoiseSamples(j, 1));
     }
     r.push_back(rk);
     b.push_back(bk);
@@ -338,8 +366,7 @@ int main(int argc, char** argv) {
   Transformation<double, 3> trans(threePointSvd(l, l_est));
   Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> l_est_trans =
     Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>::Zero(3, nl);
-  for (size_t i = 0; i < nl; ++i)
-    l_est_trans.col(i) = trans(l_est.col(i));
+  trans.transform(l_est, l_est_trans);
   std::ofstream l_est_trans_log("l_est_trans.txt");
   for (size_t i = 0; i < nl; ++i)
     l_est_trans_log << l_est_trans.col(i).head<2>().transpose() << std::endl;
@@ -18,6 +18,10 @@
 
 #include "aslam/calibration/2dlrf/utils.h"
 
+#include <cmath>
+
+#include <aslam/calibration/data-structures/VectorDesignVariable.h>
+
 namespace aslam {
   namespace calibration {
 
@@ -72,5 +76,51 @@ namespace aslam {
       }
     }
 
+    void initLandmarks(std::vector<Eigen::Matrix<double, 2, 1> >& x_l_hat,
+        const std::vector<Eigen::Matrix<double, 3, 1> >& x_odom,
+        const Eigen::Matrix<double, 3, 1>& Theta_hat,
+        const std::vector<std::vector<LandmarkObservation> >& observations,
+        size_t nl) {
+      x_l_hat.clear();
+      x_l_hat.assign(nl, Eigen::Matrix<double, 2, 1>::Zero());
+      std::vector<bool> l_found(nl, false);
+      for (size_t i = 0; i < x_odom.size() && i < observations.size(); ++i) {
+        for (auto it = observations[i].cbegin(); it != observations[i].cend();
+            ++it) {
+          const size_t j = it->landmark;
+          if (l_found[j] || it->r <= 0)
+            continue;
+          x_l_hat[j](0) = x_odom[i](0) + Theta_hat(0) * cos(x_odom[i](2)) -
+            Theta_hat(1) * sin(x_odom[i](2)) + it->r *
+            cos(it->b + Theta_hat(2) + x_odom[i](2));
+          x_l_hat[j](1) = x_odom[i](1) + Theta_hat(0) * sin(x_odom[i](2)) +
+            Theta_hat(1) * cos(x_odom[i](2)) + it->r * sin(it->b +
+            Theta_hat(2) + x_odom[i](2));
+          l_found[j] = true;
+        }
+      }
+    }
+
+    void getHeadingTrigonometry(const VectorDesignVariable<3>& x, double& c,
+        double& s) {
+      // the error terms of a pose are mostly evaluated in a row by the same
+      // thread, a single entry per thread avoids any locking
+      struct Entry {
+        const VectorDesignVariable<3>* x;
+        size_t version;
+        double c;
+        double s;
+      };
+      static thread_local Entry entry = {nullptr, 0, 1.0, 0.0};
+      if (entry.x != &x || entry.version != x.getVersion()) {
+        entry.x = &x;
+        entry.version = x.getVersion();
+        entry.c = std::cos(x.getValue()(2));
+        entry.s = std::sin(x.getValue()(2));
+      }
+      c = entry.c;
+      s = entry.s;
+    }
+
   }
 }
@@ -0,0 +1,79 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file LandmarkGridTest.cpp
+    \brief This file tests the LandmarkGrid class.
+  */
+
+#include <cmath>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <sm/kinematics/rotations.hpp>
+
+#include <aslam/calibration/statistics/UniformDistribution.h>
+#include <aslam/calibration/exceptions/BadArgumentException.h>
+
+#include "aslam/calibration/2dlrf/LandmarkGrid.h"
+
+TEST(AslamCalibrationTestSuite, testLandmarkGrid) {
+  // playground and landmarks
+  const Eigen::Vector2d min(0, 0);
+  const Eigen::Vector2d max(30, 30);
+  aslam::calibration::LandmarkGrid::Landmarks x_l;
+  aslam::calibration::UniformDistribution<double, 2>(min, max).getSamples(x_l,
+    1000);
+  aslam::calibration::LandmarkGrid grid(x_l, min, max, 4.0);
+  ASSERT_EQ(grid.getLandmarks().size(), x_l.size());
+
+  // the index must return the same landmarks as a linear scan
+  const double maxRange = 6.0;
+  const double fov = M_PI / 2;
+  std::vector<Eigen::Vector3d> poses;
+  poses.push_back(Eigen::Vector3d(15.0, 15.0, 0.0));
+  poses.push_back(Eigen::Vector3d(0.5, 29.0, -2.5));
+  poses.push_back(Eigen::Vector3d(-3.0, 10.0, 0.0));
+  poses.push_back(Eigen::Vector3d(50.0, 50.0, 1.0));
+  std::vector<size_t> indices;
+  for (auto it = poses.cbegin(); it != poses.cend(); ++it) {
+    std::vector<size_t> inRange;
+    std::vector<size_t> visible;
+    for (size_t i = 0; i < x_l.size(); ++i) {
+      const Eigen::Vector2d d = x_l[i] - it->head<2>();
+      if (d.norm() > maxRange)
+        continue;
+      inRange.push_back(i);
+      if (std::fabs(sm::kinematics::angleMod(atan2(d(1), d(0)) - (*it)(2))) <=
+          fov / 2)
+        visible.push_back(i);
+    }
+    grid.getLandmarksInRange(it->head<2>(), maxRange, indices);
+    ASSERT_EQ(indices, inRange);
+    grid.getVisibleLandmarks(*it, maxRange, fov, indices);
+    ASSERT_EQ(indices, visible);
+    grid.getVisibleLandmarks(*it, maxRange, 2 * M_PI, indices);
+    ASSERT_EQ(indices, inRange);
+  }
+
+  // landmarks outside of the grid
+  x_l.push_back(Eigen::Vector2d(31.0, 0.0));
+  ASSERT_THROW(aslam::calibration::LandmarkGrid(x_l, min, max, 4.0),
+    aslam::calibration::BadArgumentException<size_t>);
+}
@@ -25,9 +25,11 @@
 #define ASLAM_CALIBRATION_CAMERA_CALIBRATOR_H
 
 #include <cstddef>
+#include <cstdint>
 
 #include <string>
 #include <vector>
+#include <deque>
 
 #include <Eigen/Core>
 
@@ -35,6 +37,8 @@
 
 #include <sm/timing/NsecTimeUtilities.hpp>
 
+#include "aslam/calibration/camera/ObservationRecord.h"
+
 namespace cv {
 
   class Mat;
@@ -60,12 +64,16 @@ namespace aslam {
   namespace backend {
 
     class HomogeneousPoint;
+    class TransformationExpression;
 
   }
   namespace calibration {
 
     class IncrementalEstimator;
     class OptimizationProblem;
+    class ReprojectionErrorStatistics;
+    class ViewNoveltyFilter;
+    class PyramidTargetExtractor;
 
     /** The class CameraCalibrator implements the camera calibration algorithm.
         \brief Camera calibration algorithm.
@@ -107,6 +115,11 @@ namespace aslam {
       /// Camera intrinsics design variable containter shared pointer
       typedef boost::shared_ptr<CameraDesignVariableContainer>
         CameraDesignVariableContainerPtr;
+      /// Coarse-to-fine extractor shared pointer
+      typedef boost::shared_ptr<PyramidTargetExtractor>
+        PyramidTargetExtractorPtr;
+      /// View novelty filter shared pointer
+      typedef boost::shared_ptr<ViewNoveltyFilter> ViewNoveltyFilterPtr;
       /// Self type
       typedef CameraCalibrator Self;
       /// Options for the camera calibrator
@@ -135,6 +148,16 @@ namespace aslam {
             batchNumImages(1),
             useMEstimator(false),
             sigma2(1.0),
+            useViewErrorTerms(false),
+            pyramidLevels(0),
+            pyramidRefinementWindow(0),
+            useNoveltyFilter(false),
+            noveltyImageCellSize(32.0),
+            noveltyAngleResolution(0.17),
+            noveltyDistanceResolution(0.1),
+            noveltyMaxDistance(5.0),
+            noveltyMinNewImageCells(3),
+            numDetectionThreads(1),
             verbose(false) {}
         /// Number of rows in the checkerboard
         size_t rows;
@@ -180,6 +203,26 @@ namespace aslam {
         bool useMEstimator;
         /// Variance of the measurements (assume isotropic Gaussian)
         double sigma2;
+        /// Use one reprojection error term per view instead of per corner
+        bool useViewErrorTerms;
+        /// Coarse-to-fine pyramid levels, without outlier filter (0: off)
+        size_t pyramidLevels;
+        /// Half size of the full resolution refinement windows (0: auto)
+        size_t pyramidRefinementWindow;
+        /// Skip views that add neither pose diversity nor image coverage
+        bool useNoveltyFilter;
+        /// Size of an image cell for the coverage in pixels
+        double noveltyImageCellSize;
+        /// Resolution of the target tilt angles for the poses in radians
+        double noveltyAngleResolution;
+        /// Resolution of the target distance for the poses in meters
+        double noveltyDistanceResolution;
+        /// Distance of the last pose distance cell in meters
+        double noveltyMaxDistance;
+        /// Number of uncovered image cells a view with a known pose must hit
+        size_t noveltyMinNewImageCells;
+        /// Number of detection threads for addImages (0: hardware concurrency)
+        size_t numDetectionThreads;
         /// Verbose mode
         bool verbose;
       };
@@ -218,6 +261,8 @@ namespace aslam {
       const IncrementalEstimatorPtr getEstimator() const;
       /// Returns the incremental estimator
       IncrementalEstimatorPtr getEstimator();
+      /// Returns the calibration target
+      const CalibrationTargetPtr& getCalibrationTarget() const;
       /// Returns the number of images in the current batch
       size_t getBatchNumImages() const;
       /// Returns the current projection parameters
@@ -233,9 +278,9 @@ namespace aslam {
       /// Returns the current distortion standard deviation
       Eigen::VectorXd getDistortionStandardDeviation() const;
       /// Returns the current batch observations
-      const std::vector<ObservationPtr>& getBatchObservations() const;
-      /// Returns the current estimator observations
-      const std::vector<ObservationPtr>& getEstimatorObservations() const;
+      const std::vector<ObservationRecord>& getBatchObservations() const;
+      /// Returns the current estimator observations in acceptance order
+      const std::deque<ObservationRecord>& getEstimatorObservations() const;
       /// Returns the transformation matrix for an observation
       Eigen::Matrix4d getTransformation(size_t idx) const;
       /// Returns the current initial cost for the estimator
@@ -250,6 +295,10 @@ namespace aslam {
         double& maxXError, double& maxYError, size_t& numOutliers);
       /// Returns the last checkerboard image
       void getLastCheckerboardImage(cv::Mat& image) const;
+      /// Returns the view novelty filter, null before the first view
+      const ViewNoveltyFilterPtr& getNoveltyFilter() const;
+      /// Returns the number of views skipped by the novelty filter
+      size_t getNumSkippedViews() const;
       /// Returns the errors and the squared mahalanobis distances
       void getErrors(std::vector<Eigen::Vector2d>& errors, std::vector<double>&
         errorsMd2);
@@ -261,12 +310,57 @@ namespace aslam {
         */
       /// Init geometry from an image
       bool initGeometry(const cv::Mat& image);
-      /// Add an image to the calibrator
+      /// Init geometry from a target detection
+      bool initGeometry(const Observation& observation);
+      /// Add an image to the calibrator, false if it is not committed
       bool addImage(const cv::Mat& image, sm::timing::NsecTime timestamp);
+      /** Add images to the calibrator, detecting the targets in parallel,
+          and returns the number of views committed to the batch.
+          The observations committed to the batch are returned in
+          observations and the extracted targets, before their completion
+          with the current geometry, in targets, null if not found.
+        */
+      size_t addImages(const std::vector<cv::Mat>& images,
+        const std::vector<sm::timing::NsecTime>& timestamps,
+        std::vector<ObservationPtr>* observations = NULL,
+        std::vector<ObservationPtr>* targets = NULL);
+      /// Add a detection extracted beforehand, false if it is not committed
+      bool addDetection(const ObservationPtr& observation,
+        sm::timing::NsecTime timestamp);
       /// Process the current batch
       void processBatch();
       /// Write camera parameters to property tree
       void write(sm::PropertyTree& config) const;
+      /// Reads the options from a property tree
+      static Options readOptions(const sm::PropertyTree& config);
+      /// Creates an uninitialized camera geometry of the projection type
+      static CameraGeometryPtr createGeometry(const Options& options);
+      /// Creates a calibration target from the options
+      static CalibrationTargetPtr createCalibrationTarget(const Options&
+        options);
+      /// Creates a detector on a geometry for a calibration target
+      static DetectorPtr createDetector(const Options& options, const
+        CameraGeometryPtr& geometry, const CalibrationTargetPtr&
+        calibrationTarget);
+      /// Hashes the options the target extraction depends on
+      static uint64_t hashDetectionOptions(const Options& options);
+      /** Adds the reprojection error terms of an observation to a batch,
+          either one term per corner or a single term for the view
+        */
+      static void addReprojectionErrors(OptimizationProblem& batch,
+        const Options& options, const Observation& observation,
+        const aslam::backend::TransformationExpression& T_c_t_e,
+        const std::vector<LandmarkDesignVariablePtr>& landmarks,
+        const CameraGeometryPtr& geometry,
+        CameraDesignVariableContainer* camera);
+      /// Reduces the reprojection errors of an estimator in parallel
+      static ReprojectionErrorStatistics computeStatistics(const
+        IncrementalEstimator& estimator, double outlierThreshold, bool
+        keepErrors);
+      /// Writes the intrinsics of a geometry to property tree
+      static void writeIntrinsics(sm::PropertyTree& config, const Options&
+        options, const CameraGeometryPtr& geometry, const Eigen::VectorXd&
+        projectionStd, const Eigen::VectorXd& distortionStd);
       /** @}
         */
 
@@ -276,6 +370,18 @@ namespace aslam {
         */
       /// Init the vision framework
       void initVisionFramework();
+      /// Returns the number of threads to be used for detection
+      size_t getNumDetectionThreads() const;
+      /// Estimates the target pose of an observation with the current geometry
+      bool estimateTransformation(Observation& observation) const;
+      /// Completes a target extracted by a worker with the current geometry
+      bool completeObservation(const cv::Mat& image, sm::timing::NsecTime
+        timestamp, Observation& observation);
+      /// Commits a detected observation to the batch, false if it is skipped
+      bool commitObservation(const ObservationPtr& observation,
+        sm::timing::NsecTime timestamp);
+      /// Reduces the reprojection errors of the estimator in parallel
+      ReprojectionErrorStatistics computeStatistics(bool keepErrors);
       /// Init batch
       void initBatch();
       /// Add an observation into the batch
@@ -296,6 +402,10 @@ namespace aslam {
       CalibrationTargetPtr _calibrationTarget;
       /// Detector
       DetectorPtr _detector;
+      /// Coarse-to-fine extractor, null at full resolution
+      PyramidTargetExtractorPtr _pyramidExtractor;
+      /// Detectors owned by the detection workers
+      std::vector<DetectorPtr> _workerDetectors;
       /// Camera geometry
       CameraGeometryPtr _geometry;
       /// Landmark design variables
@@ -307,13 +417,13 @@ namespace aslam {
       /// Camera intrinsics design variable container
       CameraDesignVariableContainerPtr _cameraDesignVariableContainer;
       /// Observations in the current batch
-      std::vector<ObservationPtr> _batchObservations;
+      std::vector<ObservationRecord> _batchObservations;
       /// Observations accepted by the estimator
-      std::vector<ObservationPtr> _estimatorObservations;
-      /// Last observation
+      std::deque<ObservationRecord> _estimatorObservations;
+      /// Last observation, the only one retaining its image
       ObservationPtr _lastObservation;
-      /// Quantile for outlier detection
-      double _q;
+      /// View novelty filter
+      ViewNoveltyFilterPtr _noveltyFilter;
       /** @}
         */
 
@@ -28,6 +28,7 @@
 
 #include <string>
 #include <vector>
+#include <deque>
 
 #include <Eigen/Core>
 
@@ -35,8 +36,8 @@
 
 #include <sm/timing/NsecTimeUtilities.hpp>
 
-#include <aslam/calibration/statistics/EstimatorML.h>
-#include <aslam/calibration/statistics/NormalDistribution.h>
+#include "aslam/calibration/camera/ObservationRecord.h"
+#include "aslam/calibration/camera/ReprojectionErrorStatistics.h"
 
 namespace cv {
 
@@ -174,8 +175,12 @@ namespace aslam {
       const Options& getOptions() const;
       /// Returns the current options
       Options& getOptions();
+      /// Returns the calibration target
+      const CalibrationTargetPtr& getCalibrationTarget() const;
       /// Returns the current observations
-      const std::vector<ObservationPtr>& getObservations() const;
+      const std::deque<ObservationRecord>& getObservations() const;
+      /// Returns the last observation
+      const ObservationPtr& getLastObservation() const;
       /// Returns the reprojection error mean
       Eigen::VectorXd getReprojectionErrorMean() const;
       /// Returns the reprojection error variance
@@ -202,6 +207,9 @@ namespace aslam {
         */
       /// Add an image to the validator
       bool addImage(const cv::Mat& image, sm::timing::NsecTime timestamp);
+      /// Add a target detection whose corners were extracted beforehand
+      bool addDetection(const ObservationPtr& observation,
+        sm::timing::NsecTime timestamp);
       /** @}
         */
 
@@ -211,6 +219,9 @@ namespace aslam {
         */
       /// Init the vision framework
       void initVisionFramework(const sm::PropertyTree& config);
+      /// Accumulates the reprojection errors of an observation
+      void addErrors(const ObservationPtr& observation,
+        sm::timing::NsecTime timestamp);
       /** @}
         */
 
@@ -226,17 +237,11 @@ namespace aslam {
       /// Camera geometry
       CameraGeometryPtr _geometry;
       /// Observations
-      std::vector<ObservationPtr> _observations;
-      /// Reprojection error statistics
-      EstimatorML<NormalDistribution<2> > _reprojectionErrorsStatistics;
-      /// Maximum reprojection error in x
-      double _maxXError;
-      /// Maximum reprojection error in y
-      double _maxYError;
-      /// Errors
-      std::vector<Eigen::Vector2d> _errors;
-      /// Squared Mahalanobis distances of the errors
-      std::vector<double> _errorsMd2;
+      std::deque<ObservationRecord> _observations;
+      /// Last observation, the only one retaining its image
+      ObservationPtr _lastObservation;
+      /// Reprojection error statistics keeping the errors
+      ReprojectionErrorStatistics _statistics;
       /** @}
         */
 
@@ -0,0 +1,165 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file DetectionCache.h
+    \brief This file defines the DetectionCache class which stores target
+           detections on disk across runs.
+  */
+
+#ifndef ASLAM_CALIBRATION_CAMERA_DETECTION_CACHE_H
+#define ASLAM_CALIBRATION_CAMERA_DETECTION_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <unordered_map>
+
+#include <boost/shared_ptr.hpp>
+
+#include <sm/timing/NsecTimeUtilities.hpp>
+
+#include "aslam/calibration/camera/ObservationRecord.h"
+
+namespace aslam {
+  namespace cameras {
+
+    class GridCalibrationTargetBase;
+    class GridCalibrationTargetObservation;
+
+  }
+  namespace calibration {
+
+    /** The class DetectionCache stores the corners of the target detections
+        in an append-only file, keyed by the hash of the image content. The
+        file is bound to a hash of the target and detector configuration and
+        is discarded when the configuration changes. The entries loaded at
+        construction are read-only, so lookups may run concurrently with
+        insertions; inserted entries become visible in the next run.
+        \brief On-disk cache of target detections
+      */
+    class DetectionCache {
+    public:
+      /** \name Types definitions
+        @{
+        */
+      /// Calibration target type
+      typedef aslam::cameras::GridCalibrationTargetBase CalibrationTarget;
+      /// Calibration target shared pointer type
+      typedef boost::shared_ptr<CalibrationTarget> CalibrationTargetPtr;
+      /// Grid observation
+      typedef aslam::cameras::GridCalibrationTargetObservation Observation;
+      /// Grid observation shared pointer
+      typedef boost::shared_ptr<Observation> ObservationPtr;
+      /// Cache entry
+      struct Entry {
+        /// Target found in the image
+        bool found;
+        /// Corners of the target
+        ObservationRecord record;
+      };
+      /// Self type
+      typedef DetectionCache Self;
+      /** @}
+        */
+
+      /** \name Constructors/destructor
+        @{
+        */
+      /// Opens the cache file for a target and a configuration hash
+      DetectionCache(const std::string& filename, const CalibrationTargetPtr&
+        target, uint64_t configHash);
+      /// Copy constructor
+      DetectionCache(const Self& other) = delete;
+      /// Copy assignment operator
+      DetectionCache& operator = (const Self& other) = delete;
+      /// Move constructor
+      DetectionCache(Self&& other) = delete;
+      /// Move assignment operator
+      DetectionCache& operator = (Self&& other) = delete;
+      /// Destructor
+      virtual ~DetectionCache();
+      /** @}
+        */
+
+      /** \name Accessors
+        @{
+        */
+      /// Returns the number of entries loaded from disk
+      size_t getNumEntries() const;
+      /// Returns the number of successful lookups
+      size_t getNumHits() const;
+      /// Returns the number of failed lookups
+      size_t getNumMisses() const;
+      /// Checks whether an image hash is in the cache
+      bool contains(uint64_t imageHash) const;
+      /** @}
+        */
+
+      /** \name Methods
+        @{
+        */
+      /// Looks up an image, observation is null if the target was not found
+      bool lookup(uint64_t imageHash, sm::timing::NsecTime timestamp,
+        ObservationPtr& observation);
+      /// Inserts the detection for an image, null if the target was not found
+      void insert(uint64_t imageHash, const ObservationPtr& observation);
+      /// Hashes the target and detector fields of calibrator options
+      template <typename O> static uint64_t hashOptions(const O& options);
+      /** @}
+        */
+
+    protected:
+      /** \name Protected methods
+        @{
+        */
+      /// Loads the cache file, returns false if it is not compatible
+      bool load();
+      /** @}
+        */
+
+      /** \name Protected members
+        @{
+        */
+      /// Cache filename
+      std::string _filename;
+      /// Calibration target
+      CalibrationTargetPtr _target;
+      /// Configuration hash
+      uint64_t _configHash;
+      /// Entries loaded from disk
+      std::unordered_map<uint64_t, Entry> _entries;
+      /// Output stream for new entries
+      std::ofstream _stream;
+      /// Number of successful lookups
+      size_t _numHits;
+      /// Number of failed lookups
+      size_t _numMisses;
+      /** @}
+        */
+
+    };
+
+  }
+}
+
+#include "aslam/calibration/camera/DetectionCache.tpp"
+
+#endif // ASLAM_CALIBRATION_CAMERA_DETECTION_CACHE_H
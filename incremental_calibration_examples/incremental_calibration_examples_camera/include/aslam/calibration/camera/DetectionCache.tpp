@@ -0,0 +1,50 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include <sstream>
+#include <iomanip>
+#include <limits>
+
+#include "aslam/calibration/camera/ImageSequenceReader.h"
+
+namespace aslam {
+  namespace calibration {
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    template <typename O>
+    uint64_t DetectionCache::hashOptions(const O& options) {
+      std::stringstream stream;
+      // doubles must round-trip, or close option sets share a key
+      stream << std::setprecision(std::numeric_limits<double>::max_digits10);
+      stream << options.rows << " " << options.cols << " "
+        << options.rowSpacingMeters << " " << options.colSpacingMeters << " "
+        << options.useAdaptiveThreshold << " " << options.normalizeImage << " "
+        << options.filterQuads << " " << options.doSubpixelRefinement << " "
+        << options.filterCornerOutliers << " "
+        << options.filterCornerSigmaThreshold << " "
+        << options.filterCornerMinReprojError << " "
+        << options.cameraProjectionType;
+      const std::string key = stream.str();
+      return ImageSequenceReader::hash(key.data(), key.size());
+    }
+
+  }
+}
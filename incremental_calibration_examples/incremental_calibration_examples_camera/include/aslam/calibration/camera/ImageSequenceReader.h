@@ -0,0 +1,243 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file ImageSequenceReader.h
+    \brief This file defines the ImageSequenceReader class which streams
+           grayscale images from a BAG file, a directory or a raw sequence.
+  */
+
+#ifndef ASLAM_CALIBRATION_CAMERA_IMAGE_SEQUENCE_READER_H
+#define ASLAM_CALIBRATION_CAMERA_IMAGE_SEQUENCE_READER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <iosfwd>
+#include <functional>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <boost/exception_ptr.hpp>
+
+#include <opencv2/core/core.hpp>
+
+#include <sm/timing/NsecTimeUtilities.hpp>
+
+namespace sm {
+
+  class PropertyTree;
+
+}
+namespace rosbag {
+
+  class Bag;
+  class View;
+
+}
+namespace aslam {
+  namespace calibration {
+
+    /** The class ImageSequenceReader streams grayscale images in a single pass
+        from a BAG file, a directory of image files or a raw frame sequence.
+        Images are decoded ahead of time by a prefetching thread.
+
+        In a directory, the timestamp is taken from the file name when it is
+        a number of nanoseconds. Such files are read in timestamp order,
+        followed by the other files in lexicographic order.
+
+        A raw sequence starts with the magic "ASLAMRAW", a 32-bit version,
+        width and height, followed by frames made of a 64-bit timestamp in
+        nanoseconds and width x height 8-bit pixels.
+
+        Each frame comes with a hash of its undecoded content, and a predicate
+        on that hash can skip the decoding.
+        \brief Image sequence reader
+      */
+    class ImageSequenceReader {
+    public:
+      /** \name Types definitions
+        @{
+        */
+      /// Sequence type
+      enum class SequenceType {
+        /// ROS BAG file
+        bag,
+        /// Directory of image files
+        directory,
+        /// Raw frame sequence
+        raw
+      };
+      /// Decoded frame
+      struct Frame {
+        /// Image, empty if the decoding was skipped
+        cv::Mat image;
+        /// Timestamp
+        sm::timing::NsecTime timestamp;
+        /// Hash of the undecoded content
+        uint64_t hash;
+      };
+      /// Predicate on the content hash telling whether to decode a frame
+      typedef std::function<bool(uint64_t)> DecodePredicate;
+      /// Self type
+      typedef ImageSequenceReader Self;
+      /// Options for the image sequence reader
+      struct Options {
+        /// Default constructor
+        Options() :
+            rosTopic(""),
+            queueSize(16),
+            framePeriod(100000000) {}
+        /// ROS topic of the images in a BAG file
+        std::string rosTopic;
+        /// Maximum number of decoded images waiting in the queue
+        size_t queueSize;
+        /// Frame period for files without timestamp in the name [ns]
+        sm::timing::NsecTime framePeriod;
+      };
+      /** @}
+        */
+
+      /** \name Constructors/destructor
+        @{
+        */
+      /// Constructs reader from path and options
+      ImageSequenceReader(const std::string& path, const Options& options =
+        Options());
+      /// Constructs reader from path and configuration in property tree
+      ImageSequenceReader(const std::string& path, const sm::PropertyTree&
+        config);
+      /// Copy constructor
+      ImageSequenceReader(const Self& other) = delete;
+      /// Copy assignment operator
+      ImageSequenceReader& operator = (const Self& other) = delete;
+      /// Move constructor
+      ImageSequenceReader(Self&& other) = delete;
+      /// Move assignment operator
+      ImageSequenceReader& operator = (Self&& other) = delete;
+      /// Destructor
+      virtual ~ImageSequenceReader();
+      /** @}
+        */
+
+      /** \name Accessors
+        @{
+        */
+      /// Returns the options
+      const Options& getOptions() const;
+      /// Returns the sequence type
+      SequenceType getSequenceType() const;
+      /// Returns the number of images in the sequence
+      size_t getNumImages() const;
+      /// Returns the number of images read so far
+      size_t getNumImagesRead() const;
+      /// Sets the decode predicate, must be called before the first read
+      void setDecodePredicate(const DecodePredicate& predicate);
+      /** @}
+        */
+
+      /** \name Methods
+        @{
+        */
+      /// Reads the next image, returns false at the end of the sequence
+      bool read(cv::Mat& image, sm::timing::NsecTime& timestamp);
+      /// Reads the next frame, returns false at the end of the sequence
+      bool read(Frame& frame);
+      /// Hashes a block of memory (64-bit FNV-1a)
+      static uint64_t hash(const void* data, size_t size, uint64_t seed =
+        14695981039346656037ULL);
+      /// Writes the header of a raw sequence
+      static void writeRawHeader(std::ostream& stream, size_t width, size_t
+        height);
+      /// Writes a grayscale frame to a raw sequence
+      static void writeRawFrame(std::ostream& stream, const cv::Mat& image,
+        sm::timing::NsecTime timestamp);
+      /** @}
+        */
+
+    protected:
+      /** \name Protected methods
+        @{
+        */
+      /// Opens the sequence
+      void open();
+      /// Decodes the sequence, runs in the prefetching thread
+      void decode();
+      /// Decodes a BAG file
+      void decodeBag();
+      /// Decodes a directory
+      void decodeDirectory();
+      /// Decodes a raw sequence
+      void decodeRaw();
+      /// Returns whether a frame with this hash should be decoded
+      bool decodeFrame(uint64_t hash) const;
+      /// Pushes a decoded frame, returns false if the reader is stopping
+      bool push(const Frame& frame);
+      /** @}
+        */
+
+      /** \name Protected members
+        @{
+        */
+      /// Path to the sequence
+      std::string _path;
+      /// Options
+      Options _options;
+      /// Sequence type
+      SequenceType _sequenceType;
+      /// Image files for a directory
+      std::vector<std::string> _files;
+      /// Image width for a raw sequence
+      size_t _width;
+      /// Image height for a raw sequence
+      size_t _height;
+      /// BAG file
+      boost::shared_ptr<rosbag::Bag> _bag;
+      /// BAG view on the image topic
+      boost::shared_ptr<rosbag::View> _view;
+      /// Number of images in the sequence
+      size_t _numImages;
+      /// Number of images read so far
+      size_t _numImagesRead;
+      /// Decode predicate
+      DecodePredicate _decodePredicate;
+      /// Decoded frames waiting to be read
+      std::deque<Frame> _queue;
+      /// Mutex protecting the queue
+      boost::mutex _mutex;
+      /// Condition signaled when the queue changes
+      boost::condition_variable _condition;
+      /// Set when the prefetching thread has decoded everything
+      bool _done;
+      /// Set when the reader is destroyed
+      bool _stop;
+      /// Exception raised in the prefetching thread
+      boost::exception_ptr _error;
+      /// Prefetching thread
+      boost::thread _thread;
+      /** @}
+        */
+
+    };
+
+  }
+}
+
+#endif // ASLAM_CALIBRATION_CAMERA_IMAGE_SEQUENCE_READER_H
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file ObservationRecord.h
+    \brief This file defines the ObservationRecord structure which holds the
+           corners of a target observation without its image.
+  */
+
+#ifndef ASLAM_CALIBRATION_CAMERA_OBSERVATION_RECORD_H
+#define ASLAM_CALIBRATION_CAMERA_OBSERVATION_RECORD_H
+
+#include <cstddef>
+
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <boost/shared_ptr.hpp>
+
+#include <sm/timing/NsecTimeUtilities.hpp>
+
+namespace aslam {
+  namespace cameras {
+
+    class GridCalibrationTargetBase;
+    class GridCalibrationTargetObservation;
+
+  }
+  namespace calibration {
+
+    /** The structure ObservationRecord holds the timestamp, the corners and
+        the target pose of a target observation. Unlike the observation, it
+        does not retain the source image.
+        \brief Compact target observation
+      */
+    struct ObservationRecord {
+      /** \name Types definitions
+        @{
+        */
+      /// Calibration target shared pointer type
+      typedef boost::shared_ptr<aslam::cameras::GridCalibrationTargetBase>
+        CalibrationTargetPtr;
+      /// Grid observation
+      typedef aslam::cameras::GridCalibrationTargetObservation Observation;
+      /// Grid observation shared pointer
+      typedef boost::shared_ptr<Observation> ObservationPtr;
+      /// Transformation matrix type, unaligned for storage in containers
+      typedef Eigen::Matrix<double, 4, 4, Eigen::DontAlign> Transformation;
+      /** @}
+        */
+
+      /** \name Constructors/destructor
+        @{
+        */
+      /// Default constructor
+      ObservationRecord();
+      /** Constructs record from an observation of a target with numCorners,
+          the timestamp is passed along since the observation time is in
+          seconds and does not preserve nanoseconds
+        */
+      ObservationRecord(const Observation& observation, size_t numCorners,
+        sm::timing::NsecTime timestamp);
+      /** @}
+        */
+
+      /** \name Methods
+        @{
+        */
+      /// Returns the number of corners
+      size_t getNumCorners() const;
+      /// Returns the image point of a corner, false if it is not valid
+      bool imagePoint(size_t i, Eigen::Vector2d& point) const;
+      /// Rebuilds an observation without image on a target
+      ObservationPtr toObservation(const CalibrationTargetPtr& target) const;
+      /** @}
+        */
+
+      /** \name Public members
+        @{
+        */
+      /// Timestamp
+      sm::timing::NsecTime timestamp;
+      /// Corner validity
+      std::vector<unsigned char> valid;
+      /// Corner image points
+      Eigen::Matrix2Xd points;
+      /// Transformation from camera to target
+      Transformation T_t_c;
+      /** @}
+        */
+
+    };
+
+  }
+}
+
+#endif // ASLAM_CALIBRATION_CAMERA_OBSERVATION_RECORD_H
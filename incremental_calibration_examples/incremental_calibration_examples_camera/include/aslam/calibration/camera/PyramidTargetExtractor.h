@@ -0,0 +1,135 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file PyramidTargetExtractor.h
+    \brief This file defines the PyramidTargetExtractor class which extracts
+           target corners coarse-to-fine on an image pyramid.
+  */
+
+#ifndef ASLAM_CALIBRATION_CAMERA_PYRAMID_TARGET_EXTRACTOR_H
+#define ASLAM_CALIBRATION_CAMERA_PYRAMID_TARGET_EXTRACTOR_H
+
+#include <cstddef>
+
+#include <boost/shared_ptr.hpp>
+
+#include <sm/timing/NsecTimeUtilities.hpp>
+
+namespace cv {
+
+  class Mat;
+
+}
+namespace aslam {
+  namespace cameras {
+
+    class GridDetector;
+    class GridCalibrationTargetBase;
+    class GridCalibrationTargetObservation;
+
+  }
+  namespace calibration {
+
+    /** The class PyramidTargetExtractor detects the target on a downsampled
+        copy of the image and refines the corners with a sub-pixel search in
+        local windows of the full resolution image. An image in which the
+        target is not found at the coarse level is rejected without any
+        processing at full resolution.
+        \brief Coarse-to-fine target corner extraction
+      */
+    class PyramidTargetExtractor {
+    public:
+      /** \name Types definitions
+        @{
+        */
+      /// Detector type
+      typedef aslam::cameras::GridDetector Detector;
+      /// Calibration target shared pointer type
+      typedef boost::shared_ptr<aslam::cameras::GridCalibrationTargetBase>
+        CalibrationTargetPtr;
+      /// Grid observation
+      typedef aslam::cameras::GridCalibrationTargetObservation Observation;
+      /// Self type
+      typedef PyramidTargetExtractor Self;
+      /// Options for the extractor
+      struct Options {
+        /// Default constructor
+        Options() :
+            numLevels(2),
+            refinementWindow(0),
+            maxIterations(30),
+            epsilon(0.01) {}
+        /// Number of pyramid levels, each one halves the image size
+        size_t numLevels;
+        /// Half size of the refinement windows in pixels (0: from levels)
+        size_t refinementWindow;
+        /// Maximum number of iterations of the sub-pixel search
+        size_t maxIterations;
+        /// Convergence threshold of the sub-pixel search in pixels
+        double epsilon;
+      };
+      /** @}
+        */
+
+      /** \name Constructors/destructor
+        @{
+        */
+      /// Constructs extractor for a target
+      PyramidTargetExtractor(const CalibrationTargetPtr& target, const
+        Options& options = Options());
+      /// Destructor
+      virtual ~PyramidTargetExtractor();
+      /** @}
+        */
+
+      /** \name Accessors
+        @{
+        */
+      /// Returns the options
+      const Options& getOptions() const;
+      /// Returns the half size of the refinement windows
+      size_t getRefinementWindow() const;
+      /** @}
+        */
+
+      /** \name Methods
+        @{
+        */
+      /// Extracts the corners with a detector, without target pose
+      bool extract(Detector& detector, const cv::Mat& image,
+        sm::timing::NsecTime timestamp, Observation& observation) const;
+      /** @}
+        */
+
+    protected:
+      /** \name Protected members
+        @{
+        */
+      /// Calibration target
+      CalibrationTargetPtr _target;
+      /// Options
+      Options _options;
+      /** @}
+        */
+
+    };
+
+  }
+}
+
+#endif // ASLAM_CALIBRATION_CAMERA_PYRAMID_TARGET_EXTRACTOR_H
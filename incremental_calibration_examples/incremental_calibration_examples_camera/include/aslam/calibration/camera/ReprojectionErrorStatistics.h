@@ -0,0 +1,145 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file ReprojectionErrorStatistics.h
+    \brief This file defines the ReprojectionErrorStatistics class which
+           accumulates the statistics of reprojection errors.
+  */
+
+#ifndef ASLAM_CALIBRATION_CAMERA_REPROJECTION_ERROR_STATISTICS_H
+#define ASLAM_CALIBRATION_CAMERA_REPROJECTION_ERROR_STATISTICS_H
+
+#include <cstddef>
+
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace aslam {
+  namespace calibration {
+
+    /** The class ReprojectionErrorStatistics accumulates the mean, the
+        covariance, the maximum absolute errors and the number of chi-square
+        outliers of reprojection errors in a single pass. Partial statistics
+        computed on disjoint sets of errors can be merged, which allows for
+        parallel reductions with a deterministic result.
+        \brief Reprojection error statistics
+      */
+    class ReprojectionErrorStatistics {
+    public:
+      /** \name Types definitions
+        @{
+        */
+      /// Self type
+      typedef ReprojectionErrorStatistics Self;
+      /** @}
+        */
+
+      /** \name Constructors/destructor
+        @{
+        */
+      /// Constructs with outlier threshold on the squared Mahalanobis distance
+      ReprojectionErrorStatistics(double outlierThreshold = 0.0, bool
+        keepErrors = false);
+      /// Destructor
+      virtual ~ReprojectionErrorStatistics();
+      /** @}
+        */
+
+      /** \name Accessors
+        @{
+        */
+      /// Returns the number of errors
+      size_t getNumErrors() const;
+      /// Checks if the statistics are valid
+      bool getValid() const;
+      /// Returns the mean of the errors
+      Eigen::Vector2d getMean() const;
+      /// Returns the maximum likelihood covariance of the errors
+      Eigen::Matrix2d getCovariance() const;
+      /// Returns the maximum absolute error in x
+      double getMaxXError() const;
+      /// Returns the maximum absolute error in y
+      double getMaxYError() const;
+      /// Returns the number of errors above the outlier threshold
+      size_t getNumOutliers() const;
+      /// Returns the outlier threshold
+      double getOutlierThreshold() const;
+      /// Returns the errors if they are kept
+      const std::vector<Eigen::Vector2d>& getErrors() const;
+      /// Returns the squared Mahalanobis distances if they are kept
+      const std::vector<double>& getMahalanobisDistances() const;
+      /** @}
+        */
+
+      /** \name Methods
+        @{
+        */
+      /// Adds an error with its squared Mahalanobis distance
+      void addError(const Eigen::Vector2d& error, double md2);
+      /// Merges statistics of errors that follow the current ones
+      void merge(const Self& other);
+      /// Resets the statistics
+      void reset();
+      /** Reduces numItems items in parallel, accumulate(i, statistics) adding
+          the errors of item i; the items are reduced in chunks of chunkSize
+          merged in index order, so that the result does not depend on
+          numThreads
+        */
+      template <typename F>
+      static Self reduce(size_t numItems, const F& accumulate,
+        double outlierThreshold = 0.0, bool keepErrors = false,
+        size_t numThreads = 0, size_t chunkSize = 256);
+      /** @}
+        */
+
+    protected:
+      /** \name Protected members
+        @{
+        */
+      /// Outlier threshold on the squared Mahalanobis distance
+      double _outlierThreshold;
+      /// Keep the errors
+      bool _keepErrors;
+      /// Number of errors
+      size_t _numErrors;
+      /// Running mean
+      Eigen::Vector2d _mean;
+      /// Running sum of the squared deviations from the mean
+      Eigen::Matrix2d _scatter;
+      /// Maximum absolute error in x
+      double _maxXError;
+      /// Maximum absolute error in y
+      double _maxYError;
+      /// Number of outliers
+      size_t _numOutliers;
+      /// Errors
+      std::vector<Eigen::Vector2d> _errors;
+      /// Squared Mahalanobis distances
+      std::vector<double> _errorsMd2;
+      /** @}
+        */
+
+    };
+
+  }
+}
+
+#include "aslam/calibration/camera/ReprojectionErrorStatistics.tpp"
+
+#endif // ASLAM_CALIBRATION_CAMERA_REPROJECTION_ERROR_STATISTICS_H
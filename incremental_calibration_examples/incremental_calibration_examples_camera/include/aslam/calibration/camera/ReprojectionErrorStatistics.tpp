@@ -0,0 +1,76 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include <algorithm>
+
+#include <boost/thread.hpp>
+#include <boost/exception_ptr.hpp>
+
+namespace aslam {
+  namespace calibration {
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    template <typename F>
+    ReprojectionErrorStatistics ReprojectionErrorStatistics::reduce(
+        size_t numItems, const F& accumulate, double outlierThreshold,
+        bool keepErrors, size_t numThreads, size_t chunkSize) {
+      chunkSize = std::max(chunkSize, size_t(1));
+      const size_t numChunks = std::max((numItems + chunkSize - 1) /
+        chunkSize, size_t(1));
+      if (!numThreads)
+        numThreads = std::max(boost::thread::hardware_concurrency(), 1u);
+      numThreads = std::min(numThreads, numChunks);
+
+      // the partition only depends on the chunk size, the workers take the
+      // chunks in turn and the chunks are merged in index order
+      std::vector<Self> partials(numChunks, Self(outlierThreshold,
+        keepErrors));
+      std::vector<boost::exception_ptr> errors(numThreads);
+      auto work = [&](size_t worker) {
+        try {
+          for (size_t c = worker; c < numChunks; c += numThreads) {
+            const size_t end = std::min((c + 1) * chunkSize, numItems);
+            for (size_t i = c * chunkSize; i < end; ++i)
+              accumulate(i, partials[c]);
+          }
+        }
+        catch (...) {
+          errors[worker] = boost::current_exception();
+        }
+      };
+      if (numThreads > 1) {
+        boost::thread_group workers;
+        for (size_t i = 0; i < numThreads; ++i)
+          workers.create_thread([&work, i](){work(i);});
+        workers.join_all();
+      }
+      else
+        work(0);
+      for (auto it = errors.cbegin(); it != errors.cend(); ++it)
+        if (*it)
+          boost::rethrow_exception(*it);
+      for (size_t c = 1; c < numChunks; ++c)
+        partials[0].merge(partials[c]);
+      return partials[0];
+    }
+
+  }
+}
@@ -0,0 +1,269 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file RigCalibrator.h
+    \brief This file defines the RigCalibrator class which implements the
+           calibration of a rig of synchronized cameras.
+  */
+
+#ifndef ASLAM_CALIBRATION_CAMERA_RIG_CALIBRATOR_H
+#define ASLAM_CALIBRATION_CAMERA_RIG_CALIBRATOR_H
+
+#include <cstddef>
+
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <boost/shared_ptr.hpp>
+
+#include <sm/timing/NsecTimeUtilities.hpp>
+
+#include "aslam/calibration/camera/CameraCalibrator.h"
+
+namespace cv {
+
+  class Mat;
+
+}
+namespace sm {
+
+  class PropertyTree;
+
+}
+namespace aslam {
+  namespace backend {
+
+    class RotationQuaternion;
+    class EuclideanPoint;
+
+  }
+  namespace calibration {
+
+    class ReprojectionErrorStatistics;
+
+    /** The class RigCalibrator implements the calibration of a rig of
+        synchronized cameras observing the same target. A single incremental
+        estimator holds the intrinsics and the camera to rig transformation
+        of every camera in the calibration group, and one target pose per
+        synchronized frame shared by all the cameras that see the target.
+        The rig frame is the frame of the reference camera. The extrinsics of
+        a camera are initialized from the first frame where it sees the
+        target together with an already initialized camera; frames are only
+        used for this initialization until all the cameras are initialized,
+        the frame completing it being the first one added to the estimator.
+        \brief Camera rig calibration algorithm
+      */
+    class RigCalibrator {
+    public:
+      /** \name Types definitions
+        @{
+        */
+      /// Incremental estimator shared pointer type
+      typedef CameraCalibrator::IncrementalEstimatorPtr
+        IncrementalEstimatorPtr;
+      /// Calibration target shared pointer type
+      typedef CameraCalibrator::CalibrationTargetPtr CalibrationTargetPtr;
+      /// Detector shared pointer type
+      typedef CameraCalibrator::DetectorPtr DetectorPtr;
+      /// Camera geometry shared pointer type
+      typedef CameraCalibrator::CameraGeometryPtr CameraGeometryPtr;
+      /// Landmark design variable shared pointer type
+      typedef CameraCalibrator::LandmarkDesignVariablePtr
+        LandmarkDesignVariablePtr;
+      /// Batch for the estimator
+      typedef CameraCalibrator::BatchPtr BatchPtr;
+      /// Grid observation
+      typedef CameraCalibrator::Observation Observation;
+      /// Grid observation shared pointer
+      typedef CameraCalibrator::ObservationPtr ObservationPtr;
+      /// Camera intrinsics design variable containter shared pointer
+      typedef CameraCalibrator::CameraDesignVariableContainerPtr
+        CameraDesignVariableContainerPtr;
+      /// Rotation design variable shared pointer
+      typedef boost::shared_ptr<aslam::backend::RotationQuaternion>
+        RotationDesignVariablePtr;
+      /// Translation design variable shared pointer
+      typedef boost::shared_ptr<aslam::backend::EuclideanPoint>
+        TranslationDesignVariablePtr;
+      /// Camera of the rig
+      struct Camera {
+        /// Camera geometry
+        CameraGeometryPtr geometry;
+        /// Detector on the geometry
+        DetectorPtr detector;
+        /// Camera intrinsics design variable container
+        CameraDesignVariableContainerPtr intrinsics;
+        /// Rotation from camera to rig
+        RotationDesignVariablePtr q_r_c;
+        /// Translation from camera to rig
+        TranslationDesignVariablePtr t_r_c;
+        /// Geometry initialized properly
+        bool geometryInitialized;
+        /// Extrinsics initialized properly
+        bool extrinsicsInitialized;
+      };
+      /// Self type
+      typedef RigCalibrator Self;
+      /// Options for the rig calibrator
+      struct Options {
+        /// Default constructor
+        Options() :
+            numCameras(2),
+            referenceCamera(0) {}
+        /// Options shared by all the cameras
+        CameraCalibrator::Options camera;
+        /// Number of cameras in the rig
+        size_t numCameras;
+        /// Camera defining the rig frame
+        size_t referenceCamera;
+      };
+      /** @}
+        */
+
+      /** \name Constructors/destructor
+        @{
+        */
+      /// Constructor with estimator and options
+      RigCalibrator(const IncrementalEstimatorPtr& estimator, const Options&
+        options = Options());
+      /// Constructs calibrator with configuration in property tree
+      RigCalibrator(const sm::PropertyTree& config, size_t numCameras);
+      /// Copy constructor
+      RigCalibrator(const Self& other) = delete;
+      /// Copy assignment operator
+      RigCalibrator& operator = (const Self& other) = delete;
+      /// Move constructor
+      RigCalibrator(Self&& other) = delete;
+      /// Move assignment operator
+      RigCalibrator& operator = (Self&& other) = delete;
+      /// Destructor
+      virtual ~RigCalibrator();
+      /** @}
+        */
+
+      /** \name Accessors
+        @{
+        */
+      /// Returns the current options
+      const Options& getOptions() const;
+      /// Returns the number of cameras
+      size_t getNumCameras() const;
+      /// Returns the incremental estimator
+      const IncrementalEstimatorPtr getEstimator() const;
+      /// Returns the incremental estimator
+      IncrementalEstimatorPtr getEstimator();
+      /// Returns the calibration target
+      const CalibrationTargetPtr& getCalibrationTarget() const;
+      /// Checks if all the cameras are initialized
+      bool isInitialized() const;
+      /// Returns a camera
+      const Camera& getCamera(size_t camera) const;
+      /// Returns the current projection parameters of a camera
+      Eigen::VectorXd getProjection(size_t camera) const;
+      /// Returns the current projection standard deviation of a camera
+      Eigen::VectorXd getProjectionStandardDeviation(size_t camera) const;
+      /// Returns the current distortion parameters of a camera
+      Eigen::VectorXd getDistortion(size_t camera) const;
+      /// Returns the current distortion standard deviation of a camera
+      Eigen::VectorXd getDistortionStandardDeviation(size_t camera) const;
+      /// Returns the current transformation from a camera to the rig
+      Eigen::Matrix4d getExtrinsics(size_t camera) const;
+      /// Returns the current extrinsics standard deviation of a camera
+      Eigen::VectorXd getExtrinsicsStandardDeviation(size_t camera) const;
+      /// Returns the number of frames in the current batch
+      size_t getBatchNumFrames() const;
+      /// Returns the timestamps of the frames accepted by the estimator
+      const std::vector<sm::timing::NsecTime>& getEstimatorTimestamps() const;
+      /// Returns the transformation from rig to target for a frame
+      Eigen::Matrix4d getTransformation(size_t idx) const;
+      /// Returns the statistics of the reprojection errors of all the cameras
+      ReprojectionErrorStatistics getStatistics(bool keepErrors = false);
+      /** @}
+        */
+
+      /** \name Methods
+        @{
+        */
+      /** Adds the synchronized images of the cameras, an empty image for a
+          camera without image, and returns the number of targets found
+        */
+      size_t addImages(const std::vector<cv::Mat>& images,
+        sm::timing::NsecTime timestamp);
+      /// Process the current batch
+      void processBatch();
+      /// Write camera parameters and extrinsics to property tree
+      void write(sm::PropertyTree& config) const;
+      /** @}
+        */
+
+    protected:
+      /** \name Protected methods
+        @{
+        */
+      /// Init the vision framework
+      void initVisionFramework();
+      /// Init batch
+      void initBatch();
+      /// Detects the target in the images of the cameras in parallel
+      void detect(const std::vector<cv::Mat>& images,
+        sm::timing::NsecTime timestamp,
+        std::vector<ObservationPtr>& observations);
+      /// Initializes extrinsics from a frame, returns the anchor camera
+      size_t initExtrinsics(const std::vector<ObservationPtr>& observations);
+      /// Initializes the extrinsics from a frame or adds it to the batch
+      void addFrame(const std::vector<ObservationPtr>& observations,
+        sm::timing::NsecTime timestamp);
+      /// Add the observations of a frame into the batch
+      void addObservations(const std::vector<ObservationPtr>& observations,
+        size_t anchor, sm::timing::NsecTime timestamp);
+      /// Returns the offset of a camera in the calibration covariance
+      size_t getCalibrationOffset(size_t camera) const;
+      /** @}
+        */
+
+      /** \name Protected members
+        @{
+        */
+      /// Options
+      Options _options;
+      /// Incremental estimator
+      IncrementalEstimatorPtr _estimator;
+      /// Estimator batch
+      BatchPtr _batch;
+      /// Calibration target
+      CalibrationTargetPtr _calibrationTarget;
+      /// Cameras
+      std::vector<Camera> _cameras;
+      /// Landmark design variables
+      std::vector<LandmarkDesignVariablePtr> _landmarkDesignVariables;
+      /// Number of frames in the batch
+      size_t _batchNumFrames;
+      /// Timestamps of the frames in the current batch
+      std::vector<sm::timing::NsecTime> _batchTimestamps;
+      /// Timestamps of the frames accepted by the estimator
+      std::vector<sm::timing::NsecTime> _estimatorTimestamps;
+      /** @}
+        */
+
+    };
+
+  }
+}
+
+#endif // ASLAM_CALIBRATION_CAMERA_RIG_CALIBRATOR_H
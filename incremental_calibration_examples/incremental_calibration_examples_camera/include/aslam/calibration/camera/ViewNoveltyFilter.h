@@ -0,0 +1,166 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file ViewNoveltyFilter.h
+    \brief This file defines the ViewNoveltyFilter class which screens target
+           views for pose diversity and image coverage.
+  */
+
+#ifndef ASLAM_CALIBRATION_CAMERA_VIEW_NOVELTY_FILTER_H
+#define ASLAM_CALIBRATION_CAMERA_VIEW_NOVELTY_FILTER_H
+
+#include <cstddef>
+
+#include <Eigen/Core>
+
+#include <aslam/calibration/statistics/Histogram.h>
+
+namespace aslam {
+  namespace cameras {
+
+    class GridCalibrationTargetObservation;
+
+  }
+  namespace calibration {
+
+    /** The class ViewNoveltyFilter keeps occupancy histograms of the target
+        poses and of the image-plane corner coverage of the accepted views.
+        A view is accepted if its pose falls in an empty pose cell or if its
+        corners cover enough empty image cells. The target pose is binned by
+        the two tilt angles of the target normal in the camera frame and by
+        the target distance.
+        \brief Pose diversity and coverage filter for target views
+      */
+    class ViewNoveltyFilter {
+    public:
+      /// \cond
+      // Required by Eigen for fixed-size matrices members
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+      /// \endcond
+
+      /** \name Types definitions
+        @{
+        */
+      /// Grid observation
+      typedef aslam::cameras::GridCalibrationTargetObservation Observation;
+      /// Image coverage histogram type
+      typedef Histogram<double, 2> CoverageHistogram;
+      /// Pose histogram type, sparse as few poses are visited
+      typedef Histogram<double, 3>::Sparse PoseHistogram;
+      /// Self type
+      typedef ViewNoveltyFilter Self;
+      /// Options for the filter
+      struct Options {
+        /// Default constructor
+        Options() :
+            imageCellSize(32.0),
+            angleResolution(0.17),
+            distanceResolution(0.1),
+            maxDistance(5.0),
+            minNewImageCells(3) {}
+        /// Size of an image cell in pixels
+        double imageCellSize;
+        /// Resolution of the target tilt angles in radians
+        double angleResolution;
+        /// Resolution of the target distance in meters
+        double distanceResolution;
+        /// Distance of the last distance cell in meters
+        double maxDistance;
+        /// Number of empty image cells a view must cover to be accepted
+        size_t minNewImageCells;
+      };
+      /** @}
+        */
+
+      /** \name Constructors/destructor
+        @{
+        */
+      /// Constructs filter for an image size
+      ViewNoveltyFilter(size_t width, size_t height, const Options& options =
+        Options());
+      /// Copy constructor
+      ViewNoveltyFilter(const Self& other) = delete;
+      /// Copy assignment operator
+      ViewNoveltyFilter& operator = (const Self& other) = delete;
+      /// Move constructor
+      ViewNoveltyFilter(Self&& other) = delete;
+      /// Move assignment operator
+      ViewNoveltyFilter& operator = (Self&& other) = delete;
+      /// Destructor
+      virtual ~ViewNoveltyFilter();
+      /** @}
+        */
+
+      /** \name Accessors
+        @{
+        */
+      /// Returns the options
+      const Options& getOptions() const;
+      /// Returns the number of accepted views
+      size_t getNumAccepted() const;
+      /// Returns the number of skipped views
+      size_t getNumSkipped() const;
+      /// Returns the image coverage histogram
+      const CoverageHistogram& getCoverage() const;
+      /// Returns the pose histogram
+      const PoseHistogram& getPoses() const;
+      /** @}
+        */
+
+      /** \name Methods
+        @{
+        */
+      /// Screens a view with its pose estimate, returns true if it is novel
+      bool addObservation(const Observation& observation, size_t numCorners);
+      /// Resets the histograms and the counts
+      void reset();
+      /** @}
+        */
+
+    protected:
+      /** \name Protected methods
+        @{
+        */
+      /// Returns the pose histogram coordinate of a view
+      PoseHistogram::Coordinate getPoseCoordinate(const Observation&
+        observation) const;
+      /** @}
+        */
+
+      /** \name Protected members
+        @{
+        */
+      /// Options
+      Options _options;
+      /// Image coverage of the accepted views
+      CoverageHistogram _coverage;
+      /// Poses of the accepted views
+      PoseHistogram _poses;
+      /// Number of accepted views
+      size_t _numAccepted;
+      /// Number of skipped views
+      size_t _numSkipped;
+      /** @}
+        */
+
+    };
+
+  }
+}
+
+#endif // ASLAM_CALIBRATION_CAMERA_VIEW_NOVELTY_FILTER_H
@@ -0,0 +1,171 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file ViewReprojectionError.h
+    \brief This file defines the ViewReprojectionError class, which implements
+           the reprojection error of all the target points seen in one view.
+  */
+
+#ifndef ASLAM_CALIBRATION_CAMERA_VIEW_REPROJECTION_ERROR_H
+#define ASLAM_CALIBRATION_CAMERA_VIEW_REPROJECTION_ERROR_H
+
+#include <cstddef>
+
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <boost/shared_ptr.hpp>
+
+#include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/TransformationExpression.hpp>
+#include <aslam/backend/HomogeneousExpression.hpp>
+
+namespace aslam {
+
+  class CameraGeometryDesignVariableContainer;
+
+  namespace cameras {
+
+    class CameraGeometryBase;
+
+  }
+  namespace backend {
+
+    class MEstimator;
+
+  }
+  namespace calibration {
+
+    /** The class ViewReprojectionError implements the reprojection error of
+        all the target points observed in one image. The target to camera
+        transformation is evaluated once per view and shared by all the
+        points. Each point keeps its own robust weight, which is applied to
+        its error and Jacobian block together with the isotropic information,
+        so that the cost and the normal equations are the ones of the
+        equivalent per-point reprojection errors. The intrinsics Jacobians
+        are the analytic ones of the design variable container, as for
+        aslam::ReprojectionError, stacked over the points.
+        \brief Reprojection error of a target view
+      */
+    class ViewReprojectionError :
+      public aslam::backend::ErrorTermDs {
+    public:
+      /** \name Types definitions
+        @{
+        */
+      /// Camera geometry shared pointer type
+      typedef boost::shared_ptr<aslam::cameras::CameraGeometryBase>
+        CameraGeometryPtr;
+      /// M-estimator shared pointer type
+      typedef boost::shared_ptr<aslam::backend::MEstimator> MEstimatorPtr;
+      /** @}
+        */
+
+      /** \name Constructors/destructor
+        @{
+        */
+      /**
+       * Constructs the error term from the observed image points and the
+       * design variables of the view
+       * \brief Constructs the error term
+       *
+       * @param y observed image points
+       * @param invR inverse covariance of each image point (isotropic)
+       * @param T_c_t transformation from target to camera
+       * @param points target points expressed in target coordinates
+       * @param geometry camera geometry
+       * @param camera design variable container of the camera intrinsics
+       * @param pointsMEstimator robust weighting of each point, may be null
+       */
+      ViewReprojectionError(const Eigen::Matrix2Xd& y, double invR,
+        const aslam::backend::TransformationExpression& T_c_t,
+        const std::vector<aslam::backend::HomogeneousExpression>& points,
+        const CameraGeometryPtr& geometry,
+        CameraGeometryDesignVariableContainer* camera,
+        const MEstimatorPtr& pointsMEstimator = MEstimatorPtr());
+      /// Copy constructor
+      ViewReprojectionError(const ViewReprojectionError& other);
+      /// Assignment operator
+      ViewReprojectionError& operator = (const ViewReprojectionError& other);
+      /// Destructor
+      virtual ~ViewReprojectionError();
+      /** @}
+        */
+
+      /** \name Accessors
+        @{
+        */
+      /// Returns the number of points in the view
+      size_t getNumPoints() const;
+      /// Returns the unweighted error of a point at the last evaluation
+      Eigen::Vector2d getPointError(size_t i) const;
+      /// Returns the squared Mahalanobis distance of a point
+      double getPointSquaredError(size_t i) const;
+      /** @}
+        */
+
+    protected:
+      /** \name Protected methods
+        @{
+        */
+      /// Evaluate the error term and return the weighted squared error
+      virtual double evaluateErrorImplementation();
+      /// Evaluate the Jacobians
+      virtual void evaluateJacobiansImplementation(
+        aslam::backend::JacobianContainer& _jacobians);
+      /// Projects the points with the current transformation and intrinsics
+      void project(const Eigen::Matrix4d& T_c_t, Eigen::Matrix2Xd& y,
+        std::vector<Eigen::MatrixXd>* J = NULL) const;
+      /// Computes the robust weights from the current errors
+      void updateWeights();
+      /// Returns the scale of the error and Jacobian block of a point
+      double getPointScale(size_t i) const;
+      /** @}
+        */
+
+      /** \name Protected members
+        @{
+        */
+      /// Observed image points
+      Eigen::Matrix2Xd _y;
+      /// Inverse covariance of each image point (isotropic)
+      double _invR;
+      /// Transformation from target to camera
+      aslam::backend::TransformationExpression _T_c_t;
+      /// Target points
+      std::vector<aslam::backend::HomogeneousExpression> _points;
+      /// Camera geometry
+      CameraGeometryPtr _geometry;
+      /// Design variable container of the camera intrinsics
+      CameraGeometryDesignVariableContainer* _camera;
+      /// Robust weighting of each point
+      MEstimatorPtr _pointsMEstimator;
+      /// Unweighted errors at the last evaluation
+      Eigen::Matrix2Xd _errors;
+      /// Robust weights at the last evaluation
+      Eigen::VectorXd _weights;
+      /** @}
+        */
+
+    };
+
+  }
+}
+
+#endif // ASLAM_CALIBRATION_CAMERA_VIEW_REPROJECTION_ERROR_H
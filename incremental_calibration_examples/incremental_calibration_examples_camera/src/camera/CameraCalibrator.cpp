@@ -26,7 +26,8 @@
 #include <sstream>
 
 #include <boost/make_shared.hpp>
-#include <boost/math/distributions/chi_squared.hpp>
+#include <boost/thread.hpp>
+#include <boost/exception_ptr.hpp>
 
 #include <sm/PropertyTree.hpp>
 
@@ -64,8 +65,14 @@
 #include <aslam/calibration/exceptions/InvalidOperationException.h>
 #include <aslam/calibration/exceptions/OutOfBoundException.h>
 #include <aslam/calibration/base/Timestamp.h>
-#include <aslam/calibration/statistics/EstimatorML.h>
-#include <aslam/calibration/statistics/NormalDistribution.h>
+#include <aslam/calibration/statistics/ChiSquareDistribution.h>
+
+#include "aslam/calibration/camera/ViewReprojectionError.h"
+#include "aslam/calibration/camera/ReprojectionErrorStatistics.h"
+#include "aslam/calibration/camera/ViewNoveltyFilter.h"
+#include "aslam/calibration/camera/PyramidTargetExtractor.h"
+#include "aslam/calibration/camera/DetectionCache.h"
+#include "aslam/calibration/camera/ImageSequenceReader.h"
 
 namespace aslam {
   namespace calibration {
@@ -79,57 +86,14 @@ namespace aslam {
         _options(options),
         _estimator(estimator),
         _geometryInitialized(false),
-        _batchNumImages(0),
-        _q(0.0) {
+        _batchNumImages(0) {
       initVisionFramework();
     }
 
     CameraCalibrator::CameraCalibrator(const sm::PropertyTree& config) :
+        _options(readOptions(config)),
         _geometryInitialized(false),
-        _batchNumImages(0),
-        _q(0.0) {
-      // read the options from the property tree
-      _options.rows = config.getInt("rows", _options.rows);
-      _options.cols = config.getInt("cols", _options.cols);
-      _options.rowSpacingMeters = config.getDouble("rowSpacingMeters",
-        _options.rowSpacingMeters);
-      _options.colSpacingMeters = config.getDouble("colSpacingMeters",
-        _options.colSpacingMeters);
-      _options.useAdaptiveThreshold = config.getBool("useAdaptiveThreshold",
-        _options.useAdaptiveThreshold);
-      _options.normalizeImage = config.getBool("normalizeImage",
-        _options.normalizeImage);
-      _options.filterQuads = config.getBool("filterQuads",
-        _options.filterQuads);
-      _options.doSubpixelRefinement = config.getBool("doSubpixelRefinement",
-        _options.doSubpixelRefinement);
-      _options.showExtractionVideo = config.getBool("showExtractionVideo",
-        _options.showExtractionVideo);
-      _options.plotCornerReprojection =
-        config.getBool("plotCornerReprojection");
-      _options.imageStepping = config.getBool("imageStepping");
-      _options.filterCornerOutliers = config.getBool("filterCornerOutliers");
-      _options.filterCornerSigmaThreshold =
-        config.getDouble("filterCornerSigmaThreshold");
-      _options.filterCornerMinReprojError =
-        config.getDouble("filterCornerMinReprojError");
-      _options.cameraProjectionType = config.getString("cameraProjectionType",
-        _options.cameraProjectionType);
-      _options.estimateLandmarks = config.getBool("estimateLandmarks",
-        _options.estimateLandmarks);
-      _options.landmarksGroupId = config.getInt("landmarksGroupId",
-        _options.landmarksGroupId);
-      _options.calibrationGroupId = config.getInt("calibrationGroupId",
-        _options.calibrationGroupId);
-      _options.transformationsGroupId = config.getInt("transformationsGroupId",
-        _options.transformationsGroupId);
-      _options.batchNumImages = config.getInt("batchNumImages",
-        _options.batchNumImages);
-      _options.useMEstimator = config.getBool("useMEstimator",
-        _options.useMEstimator);
-      _options.sigma2 = config.getDouble("sigma2", _options.sigma2);
-      _options.verbose = config.getBool("verbose", _options.verbose);
-
+        _batchNumImages(0) {
       // init vision framework
       initVisionFramework();
 
@@ -162,6 +126,11 @@ namespace aslam {
       return _estimator;
     }
 
+    const CameraCalibrator::CalibrationTargetPtr&
+        CameraCalibrator::getCalibrationTarget() const {
+      return _calibrationTarget;
+    }
+
     size_t CameraCalibrator::getBatchNumImages() const {
       return _batchNumImages;
     }
@@ -208,12 +177,12 @@ namespace aslam {
         return Eigen::VectorXd::Zero(0);
     }
 
-    const std::vector<CameraCalibrator::ObservationPtr>&
+    const std::vector<ObservationRecord>&
         CameraCalibrator::getBatchObservations() const {
       return _batchObservations;
     }
 
-    const std::vector<CameraCalibrator::ObservationPtr>&
+    const std::deque<ObservationRecord>&
         CameraCalibrator::getEstimatorObservations() const {
       return _estimatorObservations;
     }
@@ -250,28 +219,14 @@ namespace aslam {
     void CameraCalibrator::getStatistics(Eigen::VectorXd&
         mean, Eigen::VectorXd& variance, Eigen::VectorXd& standardDeviation,
         double& maxXError, double& maxYError, size_t& numOutliers) {
-      std::vector<Eigen::Vector2d> errors;
-      std::vector<double> errorsMd2;
-      getErrors(errors, errorsMd2);
-      EstimatorML<NormalDistribution<2> > statistics;
-      statistics.addPoints(errors);
+      const ReprojectionErrorStatistics statistics = computeStatistics(false);
       if (statistics.getValid()) {
-        mean = statistics.getDistribution().getMean();
-        variance = statistics.getDistribution().getCovariance().diagonal();
+        mean = statistics.getMean();
+        variance = statistics.getCovariance().diagonal();
         standardDeviation = variance.array().sqrt();
-        maxXError = 0.0;
-        maxYError = 0.0;
-        for (auto it = errors.cbegin(); it != errors.cend(); ++it) {
-          if (std::fabs((*it)(0)) > maxXError)
-            maxXError = std::fabs((*it)(0));
-          if (std::fabs((*it)(1)) > maxYError)
-            maxYError = std::fabs((*it)(1));
-        }
-        if (_q == 0.0)
-          _q = boost::math::quantile(boost::math::chi_squared_distribution<>(2),
-            0.975);
-        numOutliers = std::count_if(errorsMd2.cbegin(), errorsMd2.cend(),
-          [&](decltype(*errorsMd2.cbegin()) x){return x > _q;});
+        maxXError = statistics.getMaxXError();
+        maxYError = statistics.getMaxYError();
+        numOutliers = statistics.getNumOutliers();
       }
       else {
         mean.resize(0);
@@ -285,18 +240,18 @@ namespace aslam {
 
     void CameraCalibrator::getErrors(std::vector<Eigen::Vector2d>& errors,
         std::vector<double>& errorsMd2) {
-      errors.clear();
-      errorsMd2.clear();
-      auto problem = const_cast<IncrementalOptimizationProblem*>(
-        _estimator->getProblem());
-      errors.reserve(problem->numErrorTerms());
-      errorsMd2.reserve(problem->numErrorTerms());
-      for (size_t i = 0; i != problem->numErrorTerms(); ++i) {
-        auto e_re = problem->errorTerm(i);
-        errorsMd2.push_back(e_re->evaluateError());
-        errors.push_back(
-          dynamic_cast<aslam::ReprojectionError*>(e_re)->error());
-      }
+      const ReprojectionErrorStatistics statistics = computeStatistics(true);
+      errors = statistics.getErrors();
+      errorsMd2 = statistics.getMahalanobisDistances();
+    }
+
+    const CameraCalibrator::ViewNoveltyFilterPtr&
+        CameraCalibrator::getNoveltyFilter() const {
+      return _noveltyFilter;
+    }
+
+    size_t CameraCalibrator::getNumSkippedViews() const {
+      return _noveltyFilter ? _noveltyFilter->getNumSkipped() : 0;
     }
 
     void CameraCalibrator::getLastCheckerboardImage(cv::Mat& image) const {
@@ -308,41 +263,90 @@ namespace aslam {
 /* Methods                                                                    */
 /******************************************************************************/
 
+    CameraCalibrator::Options CameraCalibrator::readOptions(const
+        sm::PropertyTree& config) {
+      Options options;
+      options.rows = config.getInt("rows", options.rows);
+      options.cols = config.getInt("cols", options.cols);
+      options.rowSpacingMeters = config.getDouble("rowSpacingMeters",
+        options.rowSpacingMeters);
+      options.colSpacingMeters = config.getDouble("colSpacingMeters",
+        options.colSpacingMeters);
+      options.useAdaptiveThreshold = config.getBool("useAdaptiveThreshold",
+        options.useAdaptiveThreshold);
+      options.normalizeImage = config.getBool("normalizeImage",
+        options.normalizeImage);
+      options.filterQuads = config.getBool("filterQuads",
+        options.filterQuads);
+      options.doSubpixelRefinement = config.getBool("doSubpixelRefinement",
+        options.doSubpixelRefinement);
+      options.showExtractionVideo = config.getBool("showExtractionVideo",
+        options.showExtractionVideo);
+      options.plotCornerReprojection =
+        config.getBool("plotCornerReprojection");
+      options.imageStepping = config.getBool("imageStepping");
+      options.filterCornerOutliers = config.getBool("filterCornerOutliers");
+      options.filterCornerSigmaThreshold =
+        config.getDouble("filterCornerSigmaThreshold");
+      options.filterCornerMinReprojError =
+        config.getDouble("filterCornerMinReprojError");
+      options.cameraProjectionType = config.getString("cameraProjectionType",
+        options.cameraProjectionType);
+      options.estimateLandmarks = config.getBool("estimateLandmarks",
+        options.estimateLandmarks);
+      options.landmarksGroupId = config.getInt("landmarksGroupId",
+        options.landmarksGroupId);
+      options.calibrationGroupId = config.getInt("calibrationGroupId",
+        options.calibrationGroupId);
+      options.transformationsGroupId = config.getInt("transformationsGroupId",
+        options.transformationsGroupId);
+      options.batchNumImages = config.getInt("batchNumImages",
+        options.batchNumImages);
+      options.useMEstimator = config.getBool("useMEstimator",
+        options.useMEstimator);
+      options.sigma2 = config.getDouble("sigma2", options.sigma2);
+      options.useViewErrorTerms = config.getBool("useViewErrorTerms",
+        options.useViewErrorTerms);
+      options.pyramidLevels = config.getInt("pyramidLevels",
+        options.pyramidLevels);
+      options.pyramidRefinementWindow = config.getInt(
+        "pyramidRefinementWindow", options.pyramidRefinementWindow);
+      options.useNoveltyFilter = config.getBool("useNoveltyFilter",
+        options.useNoveltyFilter);
+      options.noveltyImageCellSize = config.getDouble("noveltyImageCellSize",
+        options.noveltyImageCellSize);
+      options.noveltyAngleResolution = config.getDouble(
+        "noveltyAngleResolution", options.noveltyAngleResolution);
+      options.noveltyDistanceResolution = config.getDouble(
+        "noveltyDistanceResolution", options.noveltyDistanceResolution);
+      options.noveltyMaxDistance = config.getDouble("noveltyMaxDistance",
+        options.noveltyMaxDistance);
+      options.noveltyMinNewImageCells = config.getInt(
+        "noveltyMinNewImageCells", options.noveltyMinNewImageCells);
+      options.numDetectionThreads = config.getInt("numDetectionThreads",
+        options.numDetectionThreads);
+      options.verbose = config.getBool("verbose", options.verbose);
+      return options;
+    }
+
     void CameraCalibrator::initVisionFramework() {
       // create calibration target
-      CalibrationTarget::CheckerboardOptions targetOptions;
-      targetOptions.useAdaptiveThreshold = _options.useAdaptiveThreshold;
-      targetOptions.normalizeImage = _options.normalizeImage;
-      targetOptions.filterQuads = _options.filterQuads;
-      targetOptions.doSubpixelRefinement = _options.doSubpixelRefinement;
-      targetOptions.showExtractionVideo = _options.showExtractionVideo;
-      _calibrationTarget = boost::make_shared<CalibrationTarget>(_options.rows,
-        _options.cols, _options.rowSpacingMeters, _options.colSpacingMeters,
-        targetOptions);
+      _calibrationTarget = createCalibrationTarget(_options);
 
       // create camera geometry
-      if (_options.cameraProjectionType == "omni")
-        _geometry =
-          boost::make_shared<aslam::cameras::DistortedOmniCameraGeometry>();
-      else if (_options.cameraProjectionType == "pinhole")
-        _geometry =
-          boost::make_shared<aslam::cameras::DistortedPinholeCameraGeometry>();
-      else
-        throw BadArgumentException<std::string>(_options.cameraProjectionType,
-          "unkown camera projection type", __FILE__, __LINE__,
-          __PRETTY_FUNCTION__);
+      _geometry = createGeometry(_options);
 
       // create detector
-      Detector::GridDetectorOptions detectorOptions;
-      detectorOptions.plotCornerReprojection = _options.plotCornerReprojection;
-      detectorOptions.imageStepping = _options.imageStepping;
-      detectorOptions.filterCornerOutliers = _options.filterCornerOutliers;
-      detectorOptions.filterCornerSigmaThreshold =
-        _options.filterCornerSigmaThreshold;
-      detectorOptions.filterCornerMinReprojError =
-        _options.filterCornerMinReprojError;
-      _detector = boost::make_shared<Detector>(_geometry, _calibrationTarget,
-        detectorOptions);
+      _detector = createDetector(_options, _geometry, _calibrationTarget);
+
+      // create coarse-to-fine extractor
+      if (_options.pyramidLevels) {
+        PyramidTargetExtractor::Options extractorOptions;
+        extractorOptions.numLevels = _options.pyramidLevels;
+        extractorOptions.refinementWindow = _options.pyramidRefinementWindow;
+        _pyramidExtractor = boost::make_shared<PyramidTargetExtractor>(
+          _calibrationTarget, extractorOptions);
+      }
 
       // create design variables for landmarks
       _landmarkDesignVariables.reserve(_calibrationTarget->size());
@@ -358,6 +362,69 @@ namespace aslam {
         CameraDesignVariableContainer>(_geometry, true, true, false);
     }
 
+    CameraCalibrator::CameraGeometryPtr CameraCalibrator::createGeometry(
+        const Options& options) {
+      if (options.cameraProjectionType == "omni")
+        return
+          boost::make_shared<aslam::cameras::DistortedOmniCameraGeometry>();
+      else if (options.cameraProjectionType == "pinhole")
+        return
+          boost::make_shared<aslam::cameras::DistortedPinholeCameraGeometry>();
+      else
+        throw BadArgumentException<std::string>(options.cameraProjectionType,
+          "unkown camera projection type", __FILE__, __LINE__,
+          __PRETTY_FUNCTION__);
+    }
+
+    CameraCalibrator::CalibrationTargetPtr
+        CameraCalibrator::createCalibrationTarget(const Options& options) {
+      CalibrationTarget::CheckerboardOptions targetOptions;
+      targetOptions.useAdaptiveThreshold = options.useAdaptiveThreshold;
+      targetOptions.normalizeImage = options.normalizeImage;
+      targetOptions.filterQuads = options.filterQuads;
+      targetOptions.doSubpixelRefinement = options.doSubpixelRefinement;
+      targetOptions.showExtractionVideo = options.showExtractionVideo;
+      return boost::make_shared<CalibrationTarget>(options.rows,
+        options.cols, options.rowSpacingMeters, options.colSpacingMeters,
+        targetOptions);
+    }
+
+    CameraCalibrator::DetectorPtr CameraCalibrator::createDetector(const
+        Options& options, const CameraGeometryPtr& geometry, const
+        CalibrationTargetPtr& calibrationTarget) {
+      Detector::GridDetectorOptions detectorOptions;
+      detectorOptions.plotCornerReprojection = options.plotCornerReprojection;
+      detectorOptions.imageStepping = options.imageStepping;
+      detectorOptions.filterCornerOutliers = options.filterCornerOutliers;
+      detectorOptions.filterCornerSigmaThreshold =
+        options.filterCornerSigmaThreshold;
+      detectorOptions.filterCornerMinReprojError =
+        options.filterCornerMinReprojError;
+      return boost::make_shared<Detector>(geometry, calibrationTarget,
+        detectorOptions);
+    }
+
+    uint64_t CameraCalibrator::hashDetectionOptions(const Options& options) {
+      const uint64_t optionsHash = DetectionCache::hashOptions(options);
+      if (!options.pyramidLevels)
+        return optionsHash;
+      // coarse-to-fine detections differ from the full resolution ones
+      std::stringstream stream;
+      stream << options.pyramidLevels << " " << options.pyramidRefinementWindow;
+      const std::string key = stream.str();
+      return ImageSequenceReader::hash(key.data(), key.size(), optionsHash);
+    }
+
+    size_t CameraCalibrator::getNumDetectionThreads() const {
+      // interactive display from the detector must stay on this thread
+      if (_options.showExtractionVideo || _options.plotCornerReprojection ||
+          _options.imageStepping)
+        return 1;
+      if (_options.numDetectionThreads)
+        return _options.numDetectionThreads;
+      return std::max(boost::thread::hardware_concurrency(), 1u);
+    }
+
     bool CameraCalibrator::initGeometry(const cv::Mat& image) {
       if (_geometryInitialized)
         return true;
@@ -369,6 +436,53 @@ namespace aslam {
         return false;
     }
 
+    bool CameraCalibrator::initGeometry(const Observation& observation) {
+      if (_geometryInitialized)
+        return true;
+      if (_geometry->initializeIntrinsics(std::vector<Observation>(1,
+          observation))) {
+        _geometryInitialized = true;
+        return true;
+      }
+      else
+        return false;
+    }
+
+    ReprojectionErrorStatistics CameraCalibrator::computeStatistics(bool
+        keepErrors) {
+      return computeStatistics(*_estimator,
+        ChiSquareDistribution::getQuantile(2, 0.975), keepErrors);
+    }
+
+    ReprojectionErrorStatistics CameraCalibrator::computeStatistics(const
+        IncrementalEstimator& estimator, double outlierThreshold, bool
+        keepErrors) {
+      // errorTerm(i) scans the batches, so the terms are gathered beforehand
+      std::vector<aslam::backend::ErrorTerm*> errorTerms;
+      const auto& batches = estimator.getProblem()->getOptimizationProblems();
+      for (auto it = batches.cbegin(); it != batches.cend(); ++it) {
+        const auto& batchErrorTerms = (*it)->getErrorTerms();
+        for (auto itE = batchErrorTerms.cbegin();
+            itE != batchErrorTerms.cend(); ++itE)
+          errorTerms.push_back(itE->get());
+      }
+      return ReprojectionErrorStatistics::reduce(errorTerms.size(),
+        [&](size_t i, ReprojectionErrorStatistics& statistics) {
+          auto e_view = dynamic_cast<ViewReprojectionError*>(errorTerms[i]);
+          if (e_view) {
+            e_view->evaluateError();
+            for (size_t j = 0; j < e_view->getNumPoints(); ++j)
+              statistics.addError(e_view->getPointError(j),
+                e_view->getPointSquaredError(j));
+          }
+          else {
+            const double md2 = errorTerms[i]->evaluateError();
+            statistics.addError(dynamic_cast<aslam::ReprojectionError*>(
+              errorTerms[i])->error(), md2);
+          }
+        }, outlierThreshold, keepErrors);
+    }
+
     void CameraCalibrator::initBatch() {
       // create batch / overwrite older if already existing
       _batch = boost::make_shared<OptimizationProblem>();
@@ -420,25 +534,94 @@ namespace aslam {
       auto T_c_t_e = T_t_c_e.inverse();
 
       // add the reprojection error terms
-      for (auto it = _landmarkDesignVariables.cbegin();
-          it != _landmarkDesignVariables.cend(); ++it) {
-        auto targetPoint = (*it)->toExpression();
+      addReprojectionErrors(*_batch, _options, observation, T_c_t_e,
+        _landmarkDesignVariables, _geometry,
+        _cameraDesignVariableContainer.get());
+
+      _batchNumImages++;
+    }
+
+    void CameraCalibrator::addReprojectionErrors(OptimizationProblem& batch,
+        const Options& options, const Observation& observation,
+        const aslam::backend::TransformationExpression& T_c_t_e,
+        const std::vector<LandmarkDesignVariablePtr>& landmarks,
+        const CameraGeometryPtr& geometry,
+        CameraDesignVariableContainer* camera) {
+      // add a single reprojection error term for the whole view
+      if (options.useViewErrorTerms) {
+        std::vector<aslam::backend::HomogeneousExpression> targetPoints;
+        targetPoints.reserve(landmarks.size());
+        Eigen::Matrix2Xd obsPoints(2, landmarks.size());
+        for (size_t i = 0; i < landmarks.size(); ++i) {
+          Eigen::Vector2d obsPoint;
+          if (observation.imagePoint(i, obsPoint)) {
+            obsPoints.col(targetPoints.size()) = obsPoint;
+            targetPoints.push_back(landmarks[i]->toExpression());
+          }
+        }
+        if (targetPoints.empty())
+          return;
+        obsPoints.conservativeResize(2, targetPoints.size());
+        batch.addErrorTerm(boost::make_shared<ViewReprojectionError>(
+          obsPoints, options.sigma2, T_c_t_e, targetPoints, geometry, camera,
+          options.useMEstimator ?
+          boost::make_shared<aslam::backend::BlakeZissermanMEstimator>(2) :
+          ViewReprojectionError::MEstimatorPtr()));
+        return;
+      }
+
+      // add one reprojection error term per corner
+      for (size_t i = 0; i < landmarks.size(); ++i) {
         Eigen::Vector2d obsPoint;
-        const bool success = observation.imagePoint(std::distance(
-          _landmarkDesignVariables.cbegin(), it), obsPoint);
-        if (success) {
-          auto e_re = boost::make_shared<aslam::ReprojectionError>(obsPoint,
-            _options.sigma2 * Eigen::Matrix2d::Identity(),
-            T_c_t_e * targetPoint, _cameraDesignVariableContainer.get());
-          if (_options.useMEstimator)
-            e_re->setMEstimatorPolicy(
-              boost::make_shared<aslam::backend::BlakeZissermanMEstimator>(
-              e_re->dimension()));
-          _batch->addErrorTerm(e_re);
+        if (!observation.imagePoint(i, obsPoint))
+          continue;
+        auto e_re = boost::make_shared<aslam::ReprojectionError>(obsPoint,
+          options.sigma2 * Eigen::Matrix2d::Identity(),
+          T_c_t_e * landmarks[i]->toExpression(), camera);
+        if (options.useMEstimator)
+          e_re->setMEstimatorPolicy(
+            boost::make_shared<aslam::backend::BlakeZissermanMEstimator>(
+            e_re->dimension()));
+        batch.addErrorTerm(e_re);
+      }
+    }
+
+    bool CameraCalibrator::commitObservation(const ObservationPtr&
+        observation, sm::timing::NsecTime timestamp) {
+      _lastObservation = observation;
+
+      // skip views that bring neither a new pose nor new image coverage
+      if (_options.useNoveltyFilter) {
+        if (!_noveltyFilter) {
+          ViewNoveltyFilter::Options noveltyOptions;
+          noveltyOptions.imageCellSize = _options.noveltyImageCellSize;
+          noveltyOptions.angleResolution = _options.noveltyAngleResolution;
+          noveltyOptions.distanceResolution =
+            _options.noveltyDistanceResolution;
+          noveltyOptions.maxDistance = _options.noveltyMaxDistance;
+          noveltyOptions.minNewImageCells = _options.noveltyMinNewImageCells;
+          _noveltyFilter = ViewNoveltyFilterPtr(new ViewNoveltyFilter(
+            _geometry->width(), _geometry->height(), noveltyOptions));
+        }
+        if (!_noveltyFilter->addObservation(*observation,
+            _calibrationTarget->size())) {
+          if (_options.verbose)
+            std::cout << __PRETTY_FUNCTION__ << ": view skipped at time "
+              << observation->time().toSec() << " ("
+              << _noveltyFilter->getNumSkipped() << " skipped)" << std::endl;
+          return false;
         }
       }
 
-      _batchNumImages++;
+      // add observation to the batch
+      addObservation(*observation);
+      _batchObservations.push_back(ObservationRecord(*observation,
+        _calibrationTarget->size(), timestamp));
+
+      // add batch if needed
+      if (_batchNumImages == _options.batchNumImages)
+        processBatch();
+      return true;
     }
 
     bool CameraCalibrator::addImage(const cv::Mat& image, sm::timing::NsecTime
@@ -449,7 +632,10 @@ namespace aslam {
 
       // find the target in the input image
       auto observation = boost::make_shared<Observation>();
-      const bool status = _detector->findTarget(image, aslam::Time(
+      const bool status = _pyramidExtractor ?
+        _pyramidExtractor->extract(*_detector, image, timestamp,
+        *observation) && completeObservation(image, timestamp, *observation) :
+        _detector->findTarget(image, aslam::Time(
         sm::timing::nsecToSec(timestamp)), *observation);
       if (!status) {
         if (_options.verbose)
@@ -463,24 +649,139 @@ namespace aslam {
             << sm::timing::nsecToSec(timestamp) << std::endl;
       }
 
-      // add observation to the batch
-      addObservation(*observation);
-      _batchObservations.push_back(observation);
-      _lastObservation = observation;
+      return commitObservation(observation, timestamp);
+    }
 
-      // add batch if needed
-      if (_batchNumImages == _options.batchNumImages)
-        processBatch();
+    bool CameraCalibrator::completeObservation(const cv::Mat& image,
+        sm::timing::NsecTime timestamp, Observation& observation) {
+      // the corner outlier filter depends on the current geometry, rerun the
+      // full detection to match the serial path exactly, except for the
+      // coarse-to-fine extraction which must not touch full resolution
+      if (_options.filterCornerOutliers && !_pyramidExtractor) {
+        observation = Observation();
+        return _detector->findTarget(image, aslam::Time(
+          sm::timing::nsecToSec(timestamp)), observation);
+      }
+      return estimateTransformation(observation);
+    }
 
+    bool CameraCalibrator::estimateTransformation(Observation& observation)
+        const {
+      sm::kinematics::Transformation T_t_c;
+      if (!_geometry->estimateTransformation(observation, T_t_c))
+        return false;
+      observation.set_T_t_c(T_t_c);
       return true;
     }
 
+    bool CameraCalibrator::addDetection(const ObservationPtr& observation,
+        sm::timing::NsecTime timestamp) {
+      if (!_geometryInitialized)
+        throw InvalidOperationException("geometry not initialized", __FILE__,
+          __LINE__, __PRETTY_FUNCTION__);
+      if (!estimateTransformation(*observation))
+        return false;
+      return commitObservation(observation, timestamp);
+    }
+
+    size_t CameraCalibrator::addImages(const std::vector<cv::Mat>& images,
+        const std::vector<sm::timing::NsecTime>& timestamps,
+        std::vector<ObservationPtr>* observations,
+        std::vector<ObservationPtr>* targets) {
+      if (!_geometryInitialized)
+        throw InvalidOperationException("geometry not initialized", __FILE__,
+          __LINE__, __PRETTY_FUNCTION__);
+      if (images.size() != timestamps.size())
+        throw BadArgumentException<size_t>(timestamps.size(),
+          "the number of timestamps must match the number of images",
+          __FILE__, __LINE__, __PRETTY_FUNCTION__);
+      if (observations)
+        observations->assign(images.size(), ObservationPtr());
+      if (targets)
+        targets->assign(images.size(), ObservationPtr());
+      if (images.empty())
+        return 0;
+
+      // observations are committed in timestamp order
+      std::vector<size_t> order(images.size());
+      for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+      std::stable_sort(order.begin(), order.end(), [&](size_t lhs,
+        size_t rhs){return timestamps[lhs] < timestamps[rhs];});
+
+      // extract the corners on the workers, this step is independent of the
+      // geometry which keeps changing while batches are processed
+      const size_t numThreads = std::min(getNumDetectionThreads(),
+        images.size());
+      while (_workerDetectors.size() < numThreads)
+        _workerDetectors.push_back(createDetector(_options, _geometry,
+          createCalibrationTarget(_options)));
+      std::vector<ObservationPtr> extractions(images.size());
+      std::vector<char> extracted(images.size(), 0);
+      std::vector<boost::exception_ptr> errors(numThreads);
+      auto extract = [&](size_t worker) {
+        try {
+          for (size_t i = worker; i < order.size(); i += numThreads) {
+            const size_t idx = order[i];
+            extractions[idx] = boost::make_shared<Observation>();
+            extracted[idx] = _pyramidExtractor ?
+              _pyramidExtractor->extract(*_workerDetectors[worker],
+              images[idx], timestamps[idx], *extractions[idx]) :
+              _workerDetectors[worker]->findTargetNoTransformation(
+              images[idx], aslam::Time(sm::timing::nsecToSec(
+              timestamps[idx])), *extractions[idx]);
+          }
+        }
+        catch (...) {
+          errors[worker] = boost::current_exception();
+        }
+      };
+      if (numThreads > 1) {
+        boost::thread_group workers;
+        for (size_t i = 0; i < numThreads; ++i)
+          workers.create_thread([&extract, i](){extract(i);});
+        workers.join_all();
+      }
+      else
+        extract(0);
+      for (auto it = errors.cbegin(); it != errors.cend(); ++it)
+        if (*it)
+          boost::rethrow_exception(*it);
+
+      // complete and commit the observations with the current geometry
+      size_t numFound = 0;
+      for (auto it = order.cbegin(); it != order.cend(); ++it) {
+        const sm::timing::NsecTime timestamp = timestamps[*it];
+        // the completion depends on the geometry and may modify the target
+        if (targets && extracted[*it])
+          (*targets)[*it] = boost::make_shared<Observation>(
+            *extractions[*it]);
+        const bool status = extracted[*it] && completeObservation(images[*it],
+          timestamp, *extractions[*it]);
+        if (!status) {
+          if (_options.verbose)
+            std::cerr << __PRETTY_FUNCTION__ << ": target not found at time "
+              << sm::timing::nsecToSec(timestamp) << std::endl;
+          continue;
+        }
+        if (_options.verbose)
+          std::cout << __PRETTY_FUNCTION__ << ": target found at time "
+            << sm::timing::nsecToSec(timestamp) << std::endl;
+        if (!commitObservation(extractions[*it], timestamp))
+          continue;
+        if (observations)
+          (*observations)[*it] = extractions[*it];
+        numFound++;
+      }
+      return numFound;
+    }
+
     void CameraCalibrator::processBatch() {
       if (!_batch)
         return;
       auto ret = _estimator->addBatch(_batch);
       if (ret.batchAccepted) {
-        _estimatorObservations.insert(_estimatorObservations.begin(),
+        _estimatorObservations.insert(_estimatorObservations.end(),
           _batchObservations.begin(), _batchObservations.end());
       }
       if (_options.verbose) {
@@ -516,18 +817,22 @@ namespace aslam {
         std::cout << "number of outliers: " << numOutliers << std::endl;
         std::cout << "number of images used: " << _estimatorObservations.size()
           << std::endl;
+        if (_noveltyFilter)
+          std::cout << "number of views skipped: "
+            << _noveltyFilter->getNumSkipped() << std::endl;
          std::cout << std::endl;
       }
       initBatch();
       _batchNumImages = 0;
     }
 
-    void CameraCalibrator::write(sm::PropertyTree& config) const {
-      auto projection = getProjection();
-      Eigen::VectorXd projectionStd = getProjectionStandardDeviation();
-      auto distortion = getDistortion();
-      Eigen::VectorXd distortionStd = getDistortionStandardDeviation();
-      if (_options.cameraProjectionType == "omni") {
+    void CameraCalibrator::writeIntrinsics(sm::PropertyTree& config, const
+        Options& options, const CameraGeometryPtr& geometry, const
+        Eigen::VectorXd& projectionStd, const Eigen::VectorXd& distortionStd) {
+      Eigen::MatrixXd projection, distortion;
+      geometry->getParameters(projection, true, false, false);
+      geometry->getParameters(distortion, false, true, false);
+      if (options.cameraProjectionType == "omni") {
         config.setDouble("projection/xi", projection(0));
         config.setDouble("projection/sigma_xi", projectionStd(0));
         config.setDouble("projection/fu", projection(1));
@@ -540,10 +845,10 @@ namespace aslam {
         config.setDouble("projection/sigma_cv", projectionStd(4));
         config.setInt("projection/ru",
           dynamic_cast<aslam::cameras::DistortedOmniCameraGeometry*>(
-          _geometry.get())->projection().ru());
+          geometry.get())->projection().ru());
         config.setInt("projection/rv",
           dynamic_cast<aslam::cameras::DistortedOmniCameraGeometry*>(
-          _geometry.get())->projection().rv());
+          geometry.get())->projection().rv());
       }
       else {
         config.setDouble("projection/fu", projection(0));
@@ -556,12 +861,12 @@ namespace aslam {
         config.setDouble("projection/sigma_cv", projectionStd(3));
         config.setInt("projection/ru",
           dynamic_cast<aslam::cameras::DistortedPinholeCameraGeometry*>
-          (_geometry.get())->projection().ru());
+          (geometry.get())->projection().ru());
         config.setInt("projection/rv",
           dynamic_cast<aslam::cameras::DistortedPinholeCameraGeometry*>(
-          _geometry.get())->projection().rv());
+          geometry.get())->projection().rv());
       }
-      config.setString("projection/type", _options.cameraProjectionType);
+      config.setString("projection/type", options.cameraProjectionType);
       config.setDouble("projection/distortion/k1", distortion(0));
       config.setDouble("projection/distortion/sigma_k1", distortionStd(0));
       config.setDouble("projection/distortion/k2", distortion(1));
@@ -572,6 +877,11 @@ namespace aslam {
       config.setDouble("projection/distortion/sigma_p2", distortionStd(3));
       config.setDouble("shutter/line-delay", 0.0);
       config.setString("mask/mask-file", "");
+    }
+
+    void CameraCalibrator::write(sm::PropertyTree& config) const {
+      writeIntrinsics(config, _options, _geometry,
+        getProjectionStandardDeviation(), getDistortionStandardDeviation());
       Eigen::MatrixXd nobsBasis = getNobsBasis();
       for (std::ptrdiff_t c = 0; c < nobsBasis.cols(); ++c) {
         for (std::ptrdiff_t r = 0; r < nobsBasis.rows(); ++r) {
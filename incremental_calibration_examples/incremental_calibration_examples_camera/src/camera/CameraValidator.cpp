@@ -28,7 +28,6 @@
 #include <opencv2/imgproc/imgproc.hpp> 
 
 #include <boost/make_shared.hpp>
-#include <boost/math/distributions/chi_squared.hpp>
 
 #include <sm/PropertyTree.hpp>
 
@@ -45,6 +44,7 @@
 
 #include <aslam/calibration/exceptions/BadArgumentException.h>
 #include <aslam/calibration/base/Timestamp.h>
+#include <aslam/calibration/statistics/ChiSquareDistribution.h>
 
 namespace aslam {
   namespace calibration {
@@ -56,15 +56,13 @@ namespace aslam {
     CameraValidator::CameraValidator(const sm::PropertyTree& intrinsics,
         const Options& options) :
         _options(options),
-        _maxXError(0.0),
-        _maxYError(0.0) {
+        _statistics(ChiSquareDistribution::getQuantile(2, 0.975), true) {
       initVisionFramework(intrinsics);
     }
 
     CameraValidator::CameraValidator(const sm::PropertyTree& intrinsics, const
         sm::PropertyTree& config) :
-        _maxXError(0.0),
-        _maxYError(0.0) {
+        _statistics(ChiSquareDistribution::getQuantile(2, 0.975), true) {
       // read the options from the property tree
       _options.rows = config.getInt("rows", _options.rows);
       _options.cols = config.getInt("cols", _options.cols);
@@ -114,46 +112,55 @@ namespace aslam {
       return _options;
     }
 
-    const std::vector<CameraValidator::ObservationPtr>&
-        CameraValidator::getObservations() const {
+    const CameraValidator::CalibrationTargetPtr&
+        CameraValidator::getCalibrationTarget() const {
+      return _calibrationTarget;
+    }
+
+    const std::deque<ObservationRecord>& CameraValidator::getObservations()
+        const {
       return _observations;
     }
 
+    const CameraValidator::ObservationPtr&
+        CameraValidator::getLastObservation() const {
+      return _lastObservation;
+    }
+
     Eigen::VectorXd CameraValidator::getReprojectionErrorMean() const {
-      if (_reprojectionErrorsStatistics.getValid())
-        return _reprojectionErrorsStatistics.getDistribution().getMean();
+      if (_statistics.getValid())
+        return _statistics.getMean();
       else
         return Eigen::VectorXd::Zero(0);
     }
 
     Eigen::VectorXd CameraValidator::getReprojectionErrorVariance() const {
-      if (_reprojectionErrorsStatistics.getValid())
-        return _reprojectionErrorsStatistics.getDistribution().getCovariance().
-          diagonal();
+      if (_statistics.getValid())
+        return _statistics.getCovariance().diagonal();
       else
         return Eigen::VectorXd::Zero(0);
     }
 
     Eigen::VectorXd CameraValidator::getReprojectionErrorStandardDeviation()
         const {
-      if (_reprojectionErrorsStatistics.getValid())
+      if (_statistics.getValid())
         return getReprojectionErrorVariance().array().sqrt();
       else
         return Eigen::VectorXd::Zero(0);
     }
 
     double CameraValidator::getReprojectionErrorMaxXError() const {
-      return _maxXError;
+      return _statistics.getMaxXError();
     }
 
     double CameraValidator::getReprojectionErrorMaxYError() const {
-      return _maxYError;
+      return _statistics.getMaxYError();
     }
 
     void CameraValidator::getLastImage(cv::Mat& image) const {
-      if (_observations.empty())
+      if (!_lastObservation || _lastObservation->image().empty())
         return;
-      auto observation = _observations.back();
+      auto observation = _lastObservation;
       cv::Mat imageCopy(observation->image().rows,
         observation->image().cols, CV_8UC3);
       cv::cvtColor(observation->image(), imageCopy, CV_GRAY2RGB);
@@ -161,13 +168,11 @@ namespace aslam {
       auto T_c_t = T_t_c.inverse();
       cv::Scalar green(0, 255, 0);
       cv::Scalar red(0, 0, 255);
-      EstimatorML<NormalDistribution<2> > reprojectionErrorsStatistics;
-      double maxXError = 0.0;
-      double maxYError = 0.0;
+      ReprojectionErrorStatistics statistics(
+        _statistics.getOutlierThreshold());
       double errorNormSum = 0.0;
       double maxErrorNorm = 0.0;
       const int radius = 5;
-      size_t numOutliers = 0;
       for (size_t i = 0; i < _calibrationTarget->size(); ++i) {
         auto targetPoint = sm::kinematics::toHomogeneous(
           _calibrationTarget->point(i));
@@ -202,20 +207,10 @@ namespace aslam {
           red, 1, CV_AA);
         const Eigen::Vector2d error = predictedPoint - observedPoint;
         const double errorNorm = error.norm();
-        reprojectionErrorsStatistics.addPoint(error);
-        if (std::fabs(error(0)) > maxXError)
-          maxXError = std::fabs(error(0));
-        if (std::fabs(error(1)) > maxYError)
-          maxYError = std::fabs(error(1));
+        statistics.addError(error, error.squaredNorm() / _options.sigma2);
         errorNormSum += errorNorm;
         if (errorNorm > maxErrorNorm)
           maxErrorNorm = errorNorm;
-        const double q = boost::math::quantile(
-          boost::math::chi_squared_distribution<>(2), 0.975);
-        const double md2 = (error.transpose() *
-          (1.0 / _options.sigma2) * Eigen::Matrix2d::Identity() * error)(0, 0);
-        if (md2 > q)
-          numOutliers++;
       }
       std::stringstream stream;
       stream << "Reprojection error norm: avg = " << errorNormSum /
@@ -224,30 +219,32 @@ namespace aslam {
         cv::FONT_HERSHEY_COMPLEX, 0.5, cv::Scalar(255, 255, 255), 1, CV_AA);
       stream.str(std::string());
       stream << "Reprojection error: mean = ["
-        << reprojectionErrorsStatistics.getDistribution().getMean().transpose()
-        << "]   std = [" << reprojectionErrorsStatistics.
-        getDistribution().getCovariance().diagonal().array().sqrt().transpose()
-        << "]   max = [" << maxXError << " " << maxYError
-        << "]   outliers = " << numOutliers;
+        << statistics.getMean().transpose()
+        << "]   std = [" << statistics.getCovariance().diagonal().array().
+        sqrt().transpose() << "]   max = [" << statistics.getMaxXError()
+        << " " << statistics.getMaxYError()
+        << "]   outliers = " << statistics.getNumOutliers();
       cv::putText(imageCopy, stream.str(), cv::Point(10, imageCopy.rows - 10),
         cv::FONT_HERSHEY_COMPLEX, 0.5, cv::Scalar(255, 255, 255), 1, CV_AA);
       image = imageCopy;
     }
 
     const std::vector<Eigen::Vector2d>& CameraValidator::getErrors() const {
-      return _errors;
+      return _statistics.getErrors();
     }
 
     const std::vector<double>& CameraValidator::getMahalanobisDistances()
         const {
-      return _errorsMd2;
+      return _statistics.getMahalanobisDistances();
     }
 
     size_t CameraValidator::getNumOutliers(double p) const {
-      const double q = boost::math::quantile(
-        boost::math::chi_squared_distribution<>(2), p);
-      return std::count_if(_errorsMd2.cbegin(), _errorsMd2.cend(), [&](decltype(
-        *_errorsMd2.cbegin()) x){return x > q;});
+      const double q = ChiSquareDistribution::getQuantile(2, p);
+      if (q == _statistics.getOutlierThreshold())
+        return _statistics.getNumOutliers();
+      const auto& errorsMd2 = _statistics.getMahalanobisDistances();
+      return std::count_if(errorsMd2.cbegin(), errorsMd2.cend(), [&](decltype(
+        *errorsMd2.cbegin()) x){return x > q;});
     }
 
 /******************************************************************************/
@@ -313,40 +310,52 @@ namespace aslam {
             << sm::timing::nsecToSec(timestamp) << std::endl;
       }
 
+      addErrors(observation, timestamp);
+
+      return true;
+    }
+
+    bool CameraValidator::addDetection(const ObservationPtr& observation,
+        sm::timing::NsecTime timestamp) {
+      sm::kinematics::Transformation T_t_c;
+      if (!_geometry->estimateTransformation(*observation, T_t_c))
+        return false;
+      observation->set_T_t_c(T_t_c);
+      addErrors(observation, timestamp);
+      return true;
+    }
+
+    void CameraValidator::addErrors(const ObservationPtr& observation,
+        sm::timing::NsecTime timestamp) {
       // transformation from camera to target
       auto T_t_c = observation->T_t_c();
 
       // transformation from target to camera
       auto T_c_t = T_t_c.inverse();
 
-      // iterate over checkerboard corners
-      for (size_t i = 0; i < _calibrationTarget->size(); ++i) {
-        auto targetPoint = sm::kinematics::toHomogeneous(
-          _calibrationTarget->point(i));
-        Eigen::Vector2d observedPoint;
-        bool success = observation->imagePoint(i, observedPoint);
-        if (!success)
-          continue;
-        Eigen::VectorXd predictedPoint;
-        success = _geometry->vsHomogeneousToKeypoint(T_c_t * targetPoint,
-          predictedPoint);
-        if (!success)
-          continue;
-        const Eigen::Vector2d error = predictedPoint - observedPoint;
-        _reprojectionErrorsStatistics.addPoint(error);
-        if (std::fabs(error(0)) > _maxXError)
-          _maxXError = std::fabs(error(0));
-        if (std::fabs(error(1)) > _maxYError)
-          _maxYError = std::fabs(error(1));
-        _errors.push_back(error);
-        _errorsMd2.push_back((error.transpose() *
-          (1.0 / _options.sigma2) * Eigen::Matrix2d::Identity() * error)(0, 0));
-      }
+      // reduce the checkerboard corners and append them to the statistics
+      _statistics.merge(ReprojectionErrorStatistics::reduce(
+        _calibrationTarget->size(),
+        [&](size_t i, ReprojectionErrorStatistics& statistics) {
+          auto targetPoint = sm::kinematics::toHomogeneous(
+            _calibrationTarget->point(i));
+          Eigen::Vector2d observedPoint;
+          bool success = observation->imagePoint(i, observedPoint);
+          if (!success)
+            return;
+          Eigen::VectorXd predictedPoint;
+          success = _geometry->vsHomogeneousToKeypoint(T_c_t * targetPoint,
+            predictedPoint);
+          if (!success)
+            return;
+          const Eigen::Vector2d error = predictedPoint - observedPoint;
+          statistics.addError(error, error.squaredNorm() / _options.sigma2);
+        }, _statistics.getOutlierThreshold(), true));
 
       // store observation for later use if needed
-      _observations.push_back(observation);
-
-      return true;
+      _observations.push_back(ObservationRecord(*observation,
+        _calibrationTarget->size(), timestamp));
+      _lastObservation = observation;
     }
 
   }
@@ -0,0 +1,187 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "aslam/calibration/camera/DetectionCache.h"
+
+#include <cstring>
+
+#include <boost/filesystem.hpp>
+
+#include <aslam/cameras/GridCalibrationTargetBase.hpp>
+#include <aslam/cameras/GridCalibrationTargetObservation.hpp>
+
+#include <aslam/calibration/exceptions/BadArgumentException.h>
+
+namespace aslam {
+  namespace calibration {
+
+    namespace {
+
+      /// Magic string of a cache file
+      const char cacheMagic[8] = {'A', 'S', 'L', 'A', 'M', 'D', 'E', 'T'};
+      /// Version of the cache file format
+      const uint32_t cacheVersion = 1;
+
+    }
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+    DetectionCache::DetectionCache(const std::string& filename, const
+        CalibrationTargetPtr& target, uint64_t configHash) :
+        _filename(filename),
+        _target(target),
+        _configHash(configHash),
+        _numHits(0),
+        _numMisses(0) {
+      if (!_target)
+        throw BadArgumentException<std::string>(filename,
+          "detection cache needs a calibration target", __FILE__, __LINE__,
+          __PRETTY_FUNCTION__);
+      if (load())
+        _stream.open(_filename, std::ios::binary | std::ios::app);
+      else {
+        _entries.clear();
+        _stream.open(_filename, std::ios::binary | std::ios::trunc);
+        const uint32_t numCorners = _target->size();
+        _stream.write(cacheMagic, sizeof(cacheMagic));
+        _stream.write(reinterpret_cast<const char*>(&cacheVersion),
+          sizeof(cacheVersion));
+        _stream.write(reinterpret_cast<const char*>(&_configHash),
+          sizeof(_configHash));
+        _stream.write(reinterpret_cast<const char*>(&numCorners),
+          sizeof(numCorners));
+      }
+      if (!_stream)
+        throw BadArgumentException<std::string>(filename,
+          "cannot open detection cache", __FILE__, __LINE__,
+          __PRETTY_FUNCTION__);
+    }
+
+    DetectionCache::~DetectionCache() {
+    }
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+    size_t DetectionCache::getNumEntries() const {
+      return _entries.size();
+    }
+
+    size_t DetectionCache::getNumHits() const {
+      return _numHits;
+    }
+
+    size_t DetectionCache::getNumMisses() const {
+      return _numMisses;
+    }
+
+    bool DetectionCache::contains(uint64_t imageHash) const {
+      return _entries.count(imageHash);
+    }
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    bool DetectionCache::load() {
+      std::ifstream stream(_filename, std::ios::binary);
+      if (!stream)
+        return false;
+      char magic[sizeof(cacheMagic)];
+      uint32_t version, numCorners;
+      uint64_t configHash;
+      stream.read(magic, sizeof(magic));
+      stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+      stream.read(reinterpret_cast<char*>(&configHash), sizeof(configHash));
+      stream.read(reinterpret_cast<char*>(&numCorners), sizeof(numCorners));
+      if (!stream || std::memcmp(magic, cacheMagic, sizeof(cacheMagic)) ||
+          version != cacheVersion || configHash != _configHash ||
+          numCorners != _target->size())
+        return false;
+
+      // a record interrupted by a crash at the end of the file is dropped
+      std::streamoff size = stream.tellg();
+      while (true) {
+        uint64_t imageHash;
+        unsigned char found;
+        stream.read(reinterpret_cast<char*>(&imageHash), sizeof(imageHash));
+        stream.read(reinterpret_cast<char*>(&found), sizeof(found));
+        if (!stream)
+          break;
+        Entry entry;
+        entry.found = found;
+        if (entry.found) {
+          entry.record.valid.resize(numCorners);
+          entry.record.points.resize(2, numCorners);
+          stream.read(reinterpret_cast<char*>(entry.record.valid.data()),
+            numCorners);
+          stream.read(reinterpret_cast<char*>(entry.record.points.data()),
+            entry.record.points.size() * sizeof(double));
+          if (!stream)
+            break;
+        }
+        _entries[imageHash] = entry;
+        size = stream.tellg();
+      }
+      stream.close();
+      if (static_cast<uintmax_t>(size) != boost::filesystem::file_size(
+          _filename))
+        boost::filesystem::resize_file(_filename, size);
+      return true;
+    }
+
+    bool DetectionCache::lookup(uint64_t imageHash, sm::timing::NsecTime
+        timestamp, ObservationPtr& observation) {
+      auto it = _entries.find(imageHash);
+      if (it == _entries.end()) {
+        _numMisses++;
+        return false;
+      }
+      _numHits++;
+      if (!it->second.found) {
+        observation.reset();
+        return true;
+      }
+      ObservationRecord record = it->second.record;
+      record.timestamp = timestamp;
+      observation = record.toObservation(_target);
+      return true;
+    }
+
+    void DetectionCache::insert(uint64_t imageHash, const ObservationPtr&
+        observation) {
+      const unsigned char found = static_cast<bool>(observation);
+      _stream.write(reinterpret_cast<const char*>(&imageHash),
+        sizeof(imageHash));
+      _stream.write(reinterpret_cast<const char*>(&found), sizeof(found));
+      if (found) {
+        // the timestamp is not stored, it is given back at lookup
+        const ObservationRecord record(*observation, _target->size(), 0);
+        _stream.write(reinterpret_cast<const char*>(record.valid.data()),
+          record.valid.size());
+        _stream.write(reinterpret_cast<const char*>(record.points.data()),
+          record.points.size() * sizeof(double));
+      }
+      _stream.flush();
+    }
+
+  }
+}
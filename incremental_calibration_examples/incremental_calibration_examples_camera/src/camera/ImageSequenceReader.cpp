@@ -0,0 +1,387 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "aslam/calibration/camera/ImageSequenceReader.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+#include <boost/make_shared.hpp>
+
+#include <rosbag/bag.h>
+#include <rosbag/view.h>
+#include <rosbag/message_instance.h>
+
+#include <sensor_msgs/Image.h>
+#include <sensor_msgs/image_encodings.h>
+
+#include <cv_bridge/cv_bridge.h>
+
+#include <opencv2/highgui/highgui.hpp>
+
+#include <sm/PropertyTree.hpp>
+
+#include <aslam/calibration/exceptions/BadArgumentException.h>
+#include <aslam/calibration/exceptions/InvalidOperationException.h>
+
+namespace aslam {
+  namespace calibration {
+
+    namespace {
+
+      /// Magic string of a raw sequence
+      const char rawMagic[8] = {'A', 'S', 'L', 'A', 'M', 'R', 'A', 'W'};
+      /// Version of the raw sequence format
+      const uint32_t rawVersion = 1;
+      /// Size of the raw sequence header in bytes
+      const size_t rawHeaderSize = sizeof(rawMagic) + 3 * sizeof(uint32_t);
+
+      /// Checks whether a file name is a supported image file
+      bool isImageFile(const boost::filesystem::path& path) {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+          ::tolower);
+        return extension == ".png" || extension == ".jpg" ||
+          extension == ".jpeg" || extension == ".bmp" || extension == ".pgm" ||
+          extension == ".tif" || extension == ".tiff";
+      }
+
+      /// Parses the timestamp of a file named after it
+      bool parseTimestamp(const std::string& file, int64_t& timestamp) {
+        const std::string stem = boost::filesystem::path(file).stem().string();
+        if (stem.empty() || !std::all_of(stem.begin(), stem.end(), ::isdigit))
+          return false;
+        timestamp = std::stoll(stem);
+        return true;
+      }
+
+      /// Orders files by timestamp, non-numeric names following by name
+      bool compareFiles(const std::string& first, const std::string& second) {
+        int64_t firstTimestamp = 0, secondTimestamp = 0;
+        const bool firstNumeric = parseTimestamp(first, firstTimestamp);
+        const bool secondNumeric = parseTimestamp(second, secondTimestamp);
+        if (firstNumeric != secondNumeric)
+          return firstNumeric;
+        if (firstTimestamp != secondTimestamp)
+          return firstTimestamp < secondTimestamp;
+        return first < second;
+      }
+
+    }
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+    ImageSequenceReader::ImageSequenceReader(const std::string& path, const
+        Options& options) :
+        _path(path),
+        _options(options),
+        _width(0),
+        _height(0),
+        _numImages(0),
+        _numImagesRead(0),
+        _done(false),
+        _stop(false) {
+      open();
+    }
+
+    ImageSequenceReader::ImageSequenceReader(const std::string& path, const
+        sm::PropertyTree& config) :
+        _path(path),
+        _width(0),
+        _height(0),
+        _numImages(0),
+        _numImagesRead(0),
+        _done(false),
+        _stop(false) {
+      _options.rosTopic = config.getString("rosTopic", _options.rosTopic);
+      _options.queueSize = config.getInt("queueSize", _options.queueSize);
+      _options.framePeriod = config.getInt("framePeriod",
+        _options.framePeriod);
+      open();
+    }
+
+    ImageSequenceReader::~ImageSequenceReader() {
+      {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _stop = true;
+      }
+      _condition.notify_all();
+      if (_thread.joinable())
+        _thread.join();
+    }
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+    const ImageSequenceReader::Options& ImageSequenceReader::getOptions()
+        const {
+      return _options;
+    }
+
+    ImageSequenceReader::SequenceType ImageSequenceReader::getSequenceType()
+        const {
+      return _sequenceType;
+    }
+
+    size_t ImageSequenceReader::getNumImages() const {
+      return _numImages;
+    }
+
+    size_t ImageSequenceReader::getNumImagesRead() const {
+      return _numImagesRead;
+    }
+
+    void ImageSequenceReader::setDecodePredicate(const DecodePredicate&
+        predicate) {
+      if (_thread.joinable())
+        throw InvalidOperationException("the sequence is already being read",
+          __FILE__, __LINE__, __PRETTY_FUNCTION__);
+      _decodePredicate = predicate;
+    }
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    void ImageSequenceReader::open() {
+      if (_options.queueSize == 0)
+        throw BadArgumentException<size_t>(_options.queueSize,
+          "queue size must be strictly positive", __FILE__, __LINE__,
+          __PRETTY_FUNCTION__);
+      const boost::filesystem::path path(_path);
+      if (!boost::filesystem::exists(path))
+        throw BadArgumentException<std::string>(_path,
+          "image sequence does not exist", __FILE__, __LINE__,
+          __PRETTY_FUNCTION__);
+      if (boost::filesystem::is_directory(path)) {
+        _sequenceType = SequenceType::directory;
+        for (auto it = boost::filesystem::directory_iterator(path);
+            it != boost::filesystem::directory_iterator(); ++it)
+          if (boost::filesystem::is_regular_file(it->status()) &&
+              isImageFile(it->path()))
+            _files.push_back(it->path().string());
+        std::sort(_files.begin(), _files.end(), compareFiles);
+        _numImages = _files.size();
+      }
+      else if (path.extension() == ".bag") {
+        _sequenceType = SequenceType::bag;
+        _bag = boost::make_shared<rosbag::Bag>(_path);
+        std::vector<std::string> topics;
+        topics.push_back(_options.rosTopic);
+        _view = boost::make_shared<rosbag::View>(*_bag,
+          rosbag::TopicQuery(topics));
+        _numImages = _view->size();
+      }
+      else {
+        _sequenceType = SequenceType::raw;
+        std::ifstream stream(_path, std::ios::binary);
+        char magic[sizeof(rawMagic)];
+        uint32_t version, width, height;
+        stream.read(magic, sizeof(magic));
+        stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+        stream.read(reinterpret_cast<char*>(&width), sizeof(width));
+        stream.read(reinterpret_cast<char*>(&height), sizeof(height));
+        if (!stream || std::memcmp(magic, rawMagic, sizeof(rawMagic)) ||
+            version != rawVersion)
+          throw BadArgumentException<std::string>(_path,
+            "not a raw image sequence", __FILE__, __LINE__,
+            __PRETTY_FUNCTION__);
+        _width = width;
+        _height = height;
+        const size_t frameSize = sizeof(int64_t) + _width * _height;
+        _numImages = (boost::filesystem::file_size(path) - rawHeaderSize) /
+          frameSize;
+      }
+    }
+
+    void ImageSequenceReader::decode() {
+      try {
+        switch (_sequenceType) {
+          case SequenceType::bag:
+            decodeBag();
+            break;
+          case SequenceType::directory:
+            decodeDirectory();
+            break;
+          case SequenceType::raw:
+            decodeRaw();
+            break;
+        }
+      }
+      catch (...) {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _error = boost::current_exception();
+      }
+      {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _done = true;
+      }
+      _condition.notify_all();
+    }
+
+    void ImageSequenceReader::decodeBag() {
+      for (auto it = _view->begin(); it != _view->end(); ++it) {
+        sensor_msgs::ImageConstPtr image(
+          it->instantiate<sensor_msgs::Image>());
+        if (!image)
+          continue;
+        Frame frame;
+        frame.timestamp = image->header.stamp.toNSec();
+        frame.hash = hash(image->data.data(), image->data.size(),
+          hash(image->encoding.data(), image->encoding.size()));
+        if (decodeFrame(frame.hash))
+          frame.image = cv_bridge::toCvCopy(image,
+            sensor_msgs::image_encodings::MONO8)->image;
+        if (!push(frame))
+          return;
+      }
+    }
+
+    void ImageSequenceReader::decodeDirectory() {
+      for (size_t i = 0; i < _files.size(); ++i) {
+        std::ifstream file(_files[i], std::ios::binary);
+        const std::vector<unsigned char> buffer(
+          (std::istreambuf_iterator<char>(file)),
+          std::istreambuf_iterator<char>());
+        Frame frame;
+        frame.hash = hash(buffer.data(), buffer.size());
+        int64_t timestamp;
+        frame.timestamp = parseTimestamp(_files[i], timestamp) ? timestamp :
+          i * _options.framePeriod;
+        if (decodeFrame(frame.hash)) {
+          frame.image = cv::imdecode(buffer, CV_LOAD_IMAGE_GRAYSCALE);
+          if (frame.image.empty())
+            throw BadArgumentException<std::string>(_files[i],
+              "cannot decode image", __FILE__, __LINE__, __PRETTY_FUNCTION__);
+        }
+        if (!push(frame))
+          return;
+      }
+    }
+
+    void ImageSequenceReader::decodeRaw() {
+      std::ifstream stream(_path, std::ios::binary);
+      stream.seekg(rawHeaderSize);
+      for (size_t i = 0; i < _numImages; ++i) {
+        int64_t timestamp;
+        cv::Mat image(_height, _width, CV_8UC1);
+        stream.read(reinterpret_cast<char*>(&timestamp), sizeof(timestamp));
+        stream.read(reinterpret_cast<char*>(image.data), _width * _height);
+        if (!stream)
+          throw BadArgumentException<std::string>(_path,
+            "truncated raw image sequence", __FILE__, __LINE__,
+            __PRETTY_FUNCTION__);
+        Frame frame;
+        frame.timestamp = timestamp;
+        frame.hash = hash(image.data, _width * _height);
+        if (decodeFrame(frame.hash))
+          frame.image = image;
+        if (!push(frame))
+          return;
+      }
+    }
+
+    bool ImageSequenceReader::decodeFrame(uint64_t hash) const {
+      return !_decodePredicate || _decodePredicate(hash);
+    }
+
+    bool ImageSequenceReader::push(const Frame& frame) {
+      {
+        boost::unique_lock<boost::mutex> lock(_mutex);
+        while (!_stop && _queue.size() >= _options.queueSize)
+          _condition.wait(lock);
+        if (_stop)
+          return false;
+        _queue.push_back(frame);
+      }
+      _condition.notify_all();
+      return true;
+    }
+
+    bool ImageSequenceReader::read(Frame& frame) {
+      if (!_thread.joinable())
+        _thread = boost::thread(&ImageSequenceReader::decode, this);
+      {
+        boost::unique_lock<boost::mutex> lock(_mutex);
+        while (_queue.empty() && !_done)
+          _condition.wait(lock);
+        if (_queue.empty()) {
+          if (_error)
+            boost::rethrow_exception(_error);
+          return false;
+        }
+        frame = _queue.front();
+        _queue.pop_front();
+      }
+      _condition.notify_all();
+      _numImagesRead++;
+      return true;
+    }
+
+    bool ImageSequenceReader::read(cv::Mat& image, sm::timing::NsecTime&
+        timestamp) {
+      Frame frame;
+      if (!read(frame))
+        return false;
+      image = frame.image;
+      timestamp = frame.timestamp;
+      return true;
+    }
+
+    uint64_t ImageSequenceReader::hash(const void* data, size_t size, uint64_t
+        seed) {
+      const unsigned char* bytes = static_cast<const unsigned char*>(data);
+      uint64_t value = seed;
+      for (size_t i = 0; i < size; ++i) {
+        value ^= bytes[i];
+        value *= 1099511628211ULL;
+      }
+      return value;
+    }
+
+    void ImageSequenceReader::writeRawHeader(std::ostream& stream, size_t
+        width, size_t height) {
+      const uint32_t header[3] = {rawVersion, static_cast<uint32_t>(width),
+        static_cast<uint32_t>(height)};
+      stream.write(rawMagic, sizeof(rawMagic));
+      stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    }
+
+    void ImageSequenceReader::writeRawFrame(std::ostream& stream, const
+        cv::Mat& image, sm::timing::NsecTime timestamp) {
+      if (image.type() != CV_8UC1)
+        throw BadArgumentException<int>(image.type(),
+          "raw sequences only hold 8-bit grayscale images", __FILE__,
+          __LINE__, __PRETTY_FUNCTION__);
+      const int64_t stamp = timestamp;
+      stream.write(reinterpret_cast<const char*>(&stamp), sizeof(stamp));
+      for (int row = 0; row < image.rows; ++row)
+        stream.write(reinterpret_cast<const char*>(image.ptr(row)),
+          image.cols);
+    }
+
+  }
+}
@@ -0,0 +1,92 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "aslam/calibration/camera/ObservationRecord.h"
+
+#include <boost/make_shared.hpp>
+
+#include <sm/kinematics/Transformation.hpp>
+
+#include <aslam/Time.hpp>
+
+#include <aslam/cameras/GridCalibrationTargetBase.hpp>
+#include <aslam/cameras/GridCalibrationTargetObservation.hpp>
+
+#include <aslam/calibration/exceptions/OutOfBoundException.h>
+
+namespace aslam {
+  namespace calibration {
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+    ObservationRecord::ObservationRecord() :
+        timestamp(0),
+        T_t_c(Transformation::Identity()) {
+    }
+
+    ObservationRecord::ObservationRecord(const Observation& observation,
+        size_t numCorners, sm::timing::NsecTime timestamp) :
+        timestamp(timestamp),
+        valid(numCorners, 0),
+        points(Eigen::Matrix2Xd::Zero(2, numCorners)),
+        T_t_c(const_cast<Observation&>(observation).T_t_c().T()) {
+      for (size_t i = 0; i < numCorners; ++i) {
+        Eigen::Vector2d point;
+        if (observation.imagePoint(i, point)) {
+          valid[i] = 1;
+          points.col(i) = point;
+        }
+      }
+    }
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    size_t ObservationRecord::getNumCorners() const {
+      return valid.size();
+    }
+
+    bool ObservationRecord::imagePoint(size_t i, Eigen::Vector2d& point)
+        const {
+      if (i >= valid.size())
+        throw OutOfBoundException<size_t>(i, valid.size(),
+          "index must be stricly smaller than the number of corners",
+          __FILE__, __LINE__, __PRETTY_FUNCTION__);
+      if (!valid[i])
+        return false;
+      point = points.col(i);
+      return true;
+    }
+
+    ObservationRecord::ObservationPtr ObservationRecord::toObservation(
+        const CalibrationTargetPtr& target) const {
+      auto observation = boost::make_shared<Observation>(target);
+      observation->setTime(aslam::Time(sm::timing::nsecToSec(timestamp)));
+      for (size_t i = 0; i < valid.size(); ++i)
+        if (valid[i])
+          observation->updateImagePoint(i, points.col(i));
+      observation->set_T_t_c(sm::kinematics::Transformation(
+        Eigen::Matrix4d(T_t_c)));
+      return observation;
+    }
+
+  }
+}
@@ -0,0 +1,127 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "aslam/calibration/camera/PyramidTargetExtractor.h"
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <aslam/Time.hpp>
+
+#include <aslam/cameras/GridDetector.hpp>
+#include <aslam/cameras/GridCalibrationTargetBase.hpp>
+#include <aslam/cameras/GridCalibrationTargetObservation.hpp>
+
+#include <aslam/calibration/exceptions/NullPointerException.h>
+
+namespace aslam {
+  namespace calibration {
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+    PyramidTargetExtractor::PyramidTargetExtractor(const CalibrationTargetPtr&
+        target, const Options& options) :
+        _target(target),
+        _options(options) {
+      if (!_target)
+        throw NullPointerException("target", __FILE__, __LINE__,
+          __PRETTY_FUNCTION__);
+    }
+
+    PyramidTargetExtractor::~PyramidTargetExtractor() {
+    }
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+    const PyramidTargetExtractor::Options&
+        PyramidTargetExtractor::getOptions() const {
+      return _options;
+    }
+
+    size_t PyramidTargetExtractor::getRefinementWindow() const {
+      // the coarse corners are accurate to about a coarse pixel
+      if (_options.refinementWindow)
+        return _options.refinementWindow;
+      return (1 << _options.numLevels) + 1;
+    }
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    bool PyramidTargetExtractor::extract(Detector& detector, const cv::Mat&
+        image, sm::timing::NsecTime timestamp, Observation& observation)
+        const {
+      const aslam::Time stamp(sm::timing::nsecToSec(timestamp));
+      if (!_options.numLevels)
+        return detector.findTargetNoTransformation(image, stamp, observation);
+
+      // failures are decided at the coarse level
+      cv::Mat coarse = image;
+      for (size_t i = 0; i < _options.numLevels; ++i) {
+        cv::Mat down;
+        cv::pyrDown(coarse, down);
+        coarse = down;
+      }
+      Observation coarseObservation;
+      if (!detector.findTargetNoTransformation(coarse, stamp,
+          coarseObservation))
+        return false;
+
+      // pixel centers of the coarse level map to the full resolution ones
+      const double scale = 1 << _options.numLevels;
+      std::vector<size_t> indices;
+      std::vector<cv::Point2f> corners;
+      indices.reserve(_target->size());
+      corners.reserve(_target->size());
+      for (size_t i = 0; i < _target->size(); ++i) {
+        Eigen::Vector2d point;
+        if (!coarseObservation.imagePoint(i, point))
+          continue;
+        point = (point.array() + 0.5) * scale - 0.5;
+        if (point(0) < 0 || point(1) < 0 || point(0) > image.cols - 1 ||
+            point(1) > image.rows - 1)
+          continue;
+        indices.push_back(i);
+        corners.push_back(cv::Point2f(point(0), point(1)));
+      }
+      if (corners.empty())
+        return false;
+
+      // sub-pixel search in local windows of the full resolution image
+      const int window = getRefinementWindow();
+      cv::cornerSubPix(image, corners, cv::Size(window, window),
+        cv::Size(-1, -1), cv::TermCriteria(cv::TermCriteria::EPS +
+        cv::TermCriteria::MAX_ITER, _options.maxIterations,
+        _options.epsilon));
+      observation = Observation(_target, image);
+      observation.setTime(stamp);
+      for (size_t i = 0; i < indices.size(); ++i)
+        observation.updateImagePoint(indices[i],
+          Eigen::Vector2d(corners[i].x, corners[i].y));
+      return true;
+    }
+
+  }
+}
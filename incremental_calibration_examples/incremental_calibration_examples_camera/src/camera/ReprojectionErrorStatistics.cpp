@@ -0,0 +1,161 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "aslam/calibration/camera/ReprojectionErrorStatistics.h"
+
+#include <cmath>
+
+#include <algorithm>
+
+#include <Eigen/LU>
+
+namespace aslam {
+  namespace calibration {
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+    ReprojectionErrorStatistics::ReprojectionErrorStatistics(double
+        outlierThreshold, bool keepErrors) :
+        _outlierThreshold(outlierThreshold),
+        _keepErrors(keepErrors) {
+      reset();
+    }
+
+    ReprojectionErrorStatistics::~ReprojectionErrorStatistics() {
+    }
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+    size_t ReprojectionErrorStatistics::getNumErrors() const {
+      return _numErrors;
+    }
+
+    bool ReprojectionErrorStatistics::getValid() const {
+      // same condition as a normal distribution accepting the covariance
+      const Eigen::Matrix2d covariance = getCovariance();
+      return _numErrors > 0 && covariance(0, 0) > 0.0 &&
+        covariance.determinant() > 0.0;
+    }
+
+    Eigen::Vector2d ReprojectionErrorStatistics::getMean() const {
+      return _mean;
+    }
+
+    Eigen::Matrix2d ReprojectionErrorStatistics::getCovariance() const {
+      if (_numErrors)
+        return _scatter / _numErrors;
+      else
+        return Eigen::Matrix2d::Zero();
+    }
+
+    double ReprojectionErrorStatistics::getMaxXError() const {
+      return _maxXError;
+    }
+
+    double ReprojectionErrorStatistics::getMaxYError() const {
+      return _maxYError;
+    }
+
+    size_t ReprojectionErrorStatistics::getNumOutliers() const {
+      return _numOutliers;
+    }
+
+    double ReprojectionErrorStatistics::getOutlierThreshold() const {
+      return _outlierThreshold;
+    }
+
+    const std::vector<Eigen::Vector2d>&
+        ReprojectionErrorStatistics::getErrors() const {
+      return _errors;
+    }
+
+    const std::vector<double>&
+        ReprojectionErrorStatistics::getMahalanobisDistances() const {
+      return _errorsMd2;
+    }
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    void ReprojectionErrorStatistics::addError(const Eigen::Vector2d& error,
+        double md2) {
+      _numErrors++;
+      const Eigen::Vector2d delta = error - _mean;
+      _mean += delta / _numErrors;
+      _scatter += delta * (error - _mean).transpose();
+      if (std::fabs(error(0)) > _maxXError)
+        _maxXError = std::fabs(error(0));
+      if (std::fabs(error(1)) > _maxYError)
+        _maxYError = std::fabs(error(1));
+      if (md2 > _outlierThreshold)
+        _numOutliers++;
+      if (_keepErrors) {
+        _errors.push_back(error);
+        _errorsMd2.push_back(md2);
+      }
+    }
+
+    void ReprojectionErrorStatistics::merge(const Self& other) {
+      if (!other._numErrors)
+        return;
+      if (!_numErrors) {
+        const bool keepErrors = _keepErrors;
+        *this = other;
+        _keepErrors = keepErrors;
+        if (!_keepErrors) {
+          _errors.clear();
+          _errorsMd2.clear();
+        }
+        return;
+      }
+      const double n1 = _numErrors;
+      const double n2 = other._numErrors;
+      const double n = n1 + n2;
+      const Eigen::Vector2d delta = other._mean - _mean;
+      _mean += delta * (n2 / n);
+      _scatter += other._scatter + delta * delta.transpose() * (n1 * n2 / n);
+      _numErrors += other._numErrors;
+      _maxXError = std::max(_maxXError, other._maxXError);
+      _maxYError = std::max(_maxYError, other._maxYError);
+      _numOutliers += other._numOutliers;
+      if (_keepErrors) {
+        _errors.insert(_errors.end(), other._errors.begin(),
+          other._errors.end());
+        _errorsMd2.insert(_errorsMd2.end(), other._errorsMd2.begin(),
+          other._errorsMd2.end());
+      }
+    }
+
+    void ReprojectionErrorStatistics::reset() {
+      _numErrors = 0;
+      _mean.setZero();
+      _scatter.setZero();
+      _maxXError = 0.0;
+      _maxYError = 0.0;
+      _numOutliers = 0;
+      _errors.clear();
+      _errorsMd2.clear();
+    }
+
+  }
+}
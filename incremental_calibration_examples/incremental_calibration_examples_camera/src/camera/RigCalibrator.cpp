@@ -0,0 +1,552 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "aslam/calibration/camera/RigCalibrator.h"
+
+#include <iostream>
+#include <sstream>
+
+#include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
+#include <boost/exception_ptr.hpp>
+
+#include <sm/PropertyTree.hpp>
+
+#include <sm/kinematics/homogeneous_coordinates.hpp>
+#include <sm/kinematics/Transformation.hpp>
+
+#include <sm/boost/null_deleter.hpp>
+
+#include <aslam/Time.hpp>
+
+#include <aslam/cameras.hpp>
+
+#include <aslam/cameras/GridCalibrationTargetCheckerboard.hpp>
+#include <aslam/cameras/GridDetector.hpp>
+#include <aslam/cameras/GridCalibrationTargetObservation.hpp>
+
+#include <aslam/backend/HomogeneousPoint.hpp>
+#include <aslam/backend/RotationQuaternion.hpp>
+#include <aslam/backend/EuclideanPoint.hpp>
+#include <aslam/backend/TransformationExpression.hpp>
+#include <aslam/backend/RotationExpression.hpp>
+#include <aslam/backend/EuclideanExpression.hpp>
+#include <aslam/backend/DesignVariable.hpp>
+
+#include <aslam/CameraGeometryDesignVariableContainer.hpp>
+
+#include <aslam/calibration/core/IncrementalEstimator.h>
+#include <aslam/calibration/core/IncrementalOptimizationProblem.h>
+#include <aslam/calibration/core/OptimizationProblem.h>
+#include <aslam/calibration/exceptions/BadArgumentException.h>
+#include <aslam/calibration/exceptions/OutOfBoundException.h>
+#include <aslam/calibration/statistics/ChiSquareDistribution.h>
+
+#include "aslam/calibration/camera/ReprojectionErrorStatistics.h"
+
+namespace aslam {
+  namespace calibration {
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+    RigCalibrator::RigCalibrator(const IncrementalEstimatorPtr& estimator,
+        const Options& options) :
+        _options(options),
+        _estimator(estimator),
+        _batchNumFrames(0) {
+      initVisionFramework();
+    }
+
+    RigCalibrator::RigCalibrator(const sm::PropertyTree& config, size_t
+        numCameras) :
+        _batchNumFrames(0) {
+      // read the options from the property tree
+      _options.camera = CameraCalibrator::readOptions(config);
+      _options.numCameras = numCameras;
+      _options.referenceCamera = config.getInt("rig/referenceCamera",
+        _options.referenceCamera);
+
+      // init vision framework
+      initVisionFramework();
+
+      // create the underlying estimator
+      _estimator = boost::make_shared<IncrementalEstimator>(
+        sm::PropertyTree(config, "estimator"));
+    }
+
+    RigCalibrator::~RigCalibrator() {
+    }
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+    const RigCalibrator::Options& RigCalibrator::getOptions() const {
+      return _options;
+    }
+
+    size_t RigCalibrator::getNumCameras() const {
+      return _cameras.size();
+    }
+
+    const RigCalibrator::IncrementalEstimatorPtr
+        RigCalibrator::getEstimator() const {
+      return _estimator;
+    }
+
+    RigCalibrator::IncrementalEstimatorPtr RigCalibrator::getEstimator() {
+      return _estimator;
+    }
+
+    const RigCalibrator::CalibrationTargetPtr&
+        RigCalibrator::getCalibrationTarget() const {
+      return _calibrationTarget;
+    }
+
+    bool RigCalibrator::isInitialized() const {
+      for (auto it = _cameras.cbegin(); it != _cameras.cend(); ++it)
+        if (!it->geometryInitialized || !it->extrinsicsInitialized)
+          return false;
+      return true;
+    }
+
+    const RigCalibrator::Camera& RigCalibrator::getCamera(size_t camera)
+        const {
+      if (camera >= _cameras.size())
+        throw OutOfBoundException<size_t>(camera, _cameras.size(),
+          "camera must be stricly smaller than the number of cameras",
+          __FILE__, __LINE__, __PRETTY_FUNCTION__);
+      return _cameras[camera];
+    }
+
+    Eigen::VectorXd RigCalibrator::getProjection(size_t camera) const {
+      Eigen::MatrixXd params;
+      getCamera(camera).geometry->getParameters(params, true, false, false);
+      return params;
+    }
+
+    Eigen::VectorXd RigCalibrator::getProjectionStandardDeviation(size_t
+        camera) const {
+      if (!_estimator->getNumBatches())
+        return Eigen::VectorXd::Zero(0);
+      return _estimator->getSigma2Theta().diagonal().segment(
+        getCalibrationOffset(camera),
+        _cameras[camera].geometry->minimalDimensionsProjection()).array().
+        sqrt();
+    }
+
+    Eigen::VectorXd RigCalibrator::getDistortion(size_t camera) const {
+      Eigen::MatrixXd params;
+      getCamera(camera).geometry->getParameters(params, false, true, false);
+      return params;
+    }
+
+    Eigen::VectorXd RigCalibrator::getDistortionStandardDeviation(size_t
+        camera) const {
+      if (!_estimator->getNumBatches())
+        return Eigen::VectorXd::Zero(0);
+      const auto& geometry = _cameras[camera].geometry;
+      return _estimator->getSigma2Theta().diagonal().segment(
+        getCalibrationOffset(camera) + geometry->minimalDimensionsProjection(),
+        geometry->minimalDimensionsDistortion()).array().sqrt();
+    }
+
+    Eigen::Matrix4d RigCalibrator::getExtrinsics(size_t camera) const {
+      const Camera& rigCamera = getCamera(camera);
+      if (!rigCamera.extrinsicsInitialized)
+        return Eigen::Matrix4d::Identity();
+      sm::kinematics::Transformation T_r_c(rigCamera.q_r_c->getQuaternion(),
+        rigCamera.t_r_c->toEuclidean());
+      return T_r_c.T();
+    }
+
+    Eigen::VectorXd RigCalibrator::getExtrinsicsStandardDeviation(size_t
+        camera) const {
+      const Camera& rigCamera = getCamera(camera);
+      if (!_estimator->getNumBatches() || !rigCamera.q_r_c->isActive())
+        return Eigen::VectorXd::Zero(0);
+      return _estimator->getSigma2Theta().diagonal().segment(
+        getCalibrationOffset(camera) +
+        rigCamera.geometry->minimalDimensionsProjection() +
+        rigCamera.geometry->minimalDimensionsDistortion(), 6).array().sqrt();
+    }
+
+    size_t RigCalibrator::getBatchNumFrames() const {
+      return _batchNumFrames;
+    }
+
+    const std::vector<sm::timing::NsecTime>&
+        RigCalibrator::getEstimatorTimestamps() const {
+      return _estimatorTimestamps;
+    }
+
+    Eigen::Matrix4d RigCalibrator::getTransformation(size_t idx) const {
+      if (idx >= _estimatorTimestamps.size())
+        throw OutOfBoundException<size_t>(idx, _estimatorTimestamps.size(),
+          "idx must be stricly smaller than the number of frames",
+          __FILE__, __LINE__, __PRETTY_FUNCTION__);
+      auto dvs = _estimator->getProblem()->getDesignVariablesGroup(
+        _options.camera.transformationsGroupId);
+      auto q_dv = const_cast<aslam::backend::RotationQuaternion*>(
+        dynamic_cast<const aslam::backend::RotationQuaternion*>(
+        dvs.at(idx * 2)));
+      auto t_dv = dynamic_cast<const aslam::backend::EuclideanPoint*>(
+        dvs.at(idx * 2 + 1));
+      sm::kinematics::Transformation T(q_dv->getQuaternion(),
+        t_dv->toEuclidean());
+      return T.T();
+    }
+
+    ReprojectionErrorStatistics RigCalibrator::getStatistics(bool keepErrors) {
+      return CameraCalibrator::computeStatistics(*_estimator,
+        ChiSquareDistribution::getQuantile(2, 0.975), keepErrors);
+    }
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    void RigCalibrator::initVisionFramework() {
+      if (!_options.numCameras)
+        throw BadArgumentException<size_t>(_options.numCameras,
+          "the rig needs at least one camera", __FILE__, __LINE__,
+          __PRETTY_FUNCTION__);
+      if (_options.referenceCamera >= _options.numCameras)
+        throw OutOfBoundException<size_t>(_options.referenceCamera,
+          _options.numCameras,
+          "reference camera must be stricly smaller than the number of cameras",
+          __FILE__, __LINE__, __PRETTY_FUNCTION__);
+
+      // create calibration target
+      _calibrationTarget = CameraCalibrator::createCalibrationTarget(
+        _options.camera);
+
+      // create design variables for landmarks
+      _landmarkDesignVariables.reserve(_calibrationTarget->size());
+      for (size_t i = 0; i < _calibrationTarget->size(); ++i) {
+        auto dv =  boost::make_shared<aslam::backend::HomogeneousPoint>(
+          sm::kinematics::toHomogeneous(_calibrationTarget->point(i)));
+        dv->setActive(_options.camera.estimateLandmarks);
+        _landmarkDesignVariables.push_back(dv);
+      }
+
+      // create the cameras, each detector owns its target since the cameras
+      // are detected concurrently
+      _cameras.resize(_options.numCameras);
+      for (size_t i = 0; i < _cameras.size(); ++i) {
+        Camera& camera = _cameras[i];
+        camera.geometry = CameraCalibrator::createGeometry(_options.camera);
+        camera.detector = CameraCalibrator::createDetector(_options.camera,
+          camera.geometry, CameraCalibrator::createCalibrationTarget(
+          _options.camera));
+        camera.intrinsics = boost::make_shared<
+          CameraCalibrator::CameraDesignVariableContainer>(camera.geometry,
+          true, true, false);
+        camera.geometryInitialized = false;
+        camera.extrinsicsInitialized = false;
+      }
+
+      // the reference camera defines the rig frame
+      Camera& reference = _cameras[_options.referenceCamera];
+      reference.q_r_c = boost::make_shared<aslam::backend::RotationQuaternion>(
+        sm::kinematics::Transformation().q());
+      reference.q_r_c->setActive(false);
+      reference.t_r_c = boost::make_shared<aslam::backend::EuclideanPoint>(
+        Eigen::Vector3d::Zero());
+      reference.t_r_c->setActive(false);
+      reference.extrinsicsInitialized = true;
+    }
+
+    void RigCalibrator::initBatch() {
+      // create batch / overwrite older if already existing
+      _batch = boost::make_shared<OptimizationProblem>();
+
+      // add the landmark design variables
+      for (auto it = _landmarkDesignVariables.cbegin();
+          it != _landmarkDesignVariables.cend(); ++it)
+        _batch->addDesignVariable(*it, _options.camera.landmarksGroupId);
+
+      // add the intrinsics and extrinsics of each camera in turn
+      for (auto it = _cameras.cbegin(); it != _cameras.cend(); ++it) {
+        aslam::backend::DesignVariable::set_t cameraDesignVariables;
+        it->intrinsics->getDesignVariables(cameraDesignVariables);
+        for (auto itDV = cameraDesignVariables.begin();
+            itDV != cameraDesignVariables.end(); ++itDV)
+          _batch->addDesignVariable(
+            boost::shared_ptr<aslam::backend::DesignVariable>(
+            *itDV, sm::null_deleter()), _options.camera.calibrationGroupId);
+        _batch->addDesignVariable(it->q_r_c,
+          _options.camera.calibrationGroupId);
+        _batch->addDesignVariable(it->t_r_c,
+          _options.camera.calibrationGroupId);
+      }
+
+      // clear the currently stored frames
+      _batchTimestamps.clear();
+    }
+
+    size_t RigCalibrator::getCalibrationOffset(size_t camera) const {
+      size_t offset = 0;
+      for (size_t i = 0; i < camera; ++i) {
+        offset += _cameras[i].geometry->minimalDimensionsProjection() +
+          _cameras[i].geometry->minimalDimensionsDistortion();
+        if (_cameras[i].q_r_c->isActive())
+          offset += _cameras[i].q_r_c->minimalDimensions() +
+            _cameras[i].t_r_c->minimalDimensions();
+      }
+      return offset;
+    }
+
+    void RigCalibrator::detect(const std::vector<cv::Mat>& images,
+        sm::timing::NsecTime timestamp,
+        std::vector<ObservationPtr>& observations) {
+      observations.assign(_cameras.size(), ObservationPtr());
+      std::vector<boost::exception_ptr> errors(_cameras.size());
+      auto detectCamera = [&](size_t i) {
+        try {
+          Camera& camera = _cameras[i];
+          if (images[i].empty())
+            return;
+          if (!camera.geometryInitialized) {
+            camera.geometryInitialized =
+              camera.detector->initCameraGeometryFromObservation(images[i]);
+            if (!camera.geometryInitialized)
+              return;
+          }
+          auto observation = boost::make_shared<Observation>();
+          if (camera.detector->findTarget(images[i], aslam::Time(
+              sm::timing::nsecToSec(timestamp)), *observation))
+            observations[i] = observation;
+        }
+        catch (...) {
+          errors[i] = boost::current_exception();
+        }
+      };
+
+      // the cameras only share the read-only landmarks, interactive display
+      // from the detectors must stay on this thread
+      if (_options.camera.showExtractionVideo ||
+          _options.camera.plotCornerReprojection ||
+          _options.camera.imageStepping || _cameras.size() == 1)
+        for (size_t i = 0; i < _cameras.size(); ++i)
+          detectCamera(i);
+      else {
+        boost::thread_group workers;
+        for (size_t i = 0; i < _cameras.size(); ++i)
+          workers.create_thread([&detectCamera, i](){detectCamera(i);});
+        workers.join_all();
+      }
+      for (auto it = errors.cbegin(); it != errors.cend(); ++it)
+        if (*it)
+          boost::rethrow_exception(*it);
+    }
+
+    size_t RigCalibrator::initExtrinsics(const std::vector<ObservationPtr>&
+        observations) {
+      // the rig pose is taken from the reference camera when it sees the
+      // target, from the first initialized camera otherwise
+      size_t anchor = _cameras.size();
+      if (observations[_options.referenceCamera])
+        anchor = _options.referenceCamera;
+      else
+        for (size_t i = 0; i < _cameras.size(); ++i)
+          if (observations[i] && _cameras[i].extrinsicsInitialized) {
+            anchor = i;
+            break;
+          }
+      if (anchor == _cameras.size())
+        return anchor;
+      const sm::kinematics::Transformation T_r_a(_cameras[anchor].q_r_c->
+        getQuaternion(), _cameras[anchor].t_r_c->toEuclidean());
+      const sm::kinematics::Transformation T_t_r =
+        observations[anchor]->T_t_c() * T_r_a.inverse();
+
+      // the design variables are created here, they enter the batches only
+      // once all the cameras are initialized
+      for (size_t i = 0; i < _cameras.size(); ++i) {
+        Camera& camera = _cameras[i];
+        if (!observations[i] || camera.extrinsicsInitialized)
+          continue;
+        const sm::kinematics::Transformation T_r_c = T_t_r.inverse() *
+          observations[i]->T_t_c();
+        camera.q_r_c = boost::make_shared<aslam::backend::RotationQuaternion>(
+          T_r_c.q());
+        camera.q_r_c->setActive(true);
+        camera.t_r_c = boost::make_shared<aslam::backend::EuclideanPoint>(
+          T_r_c.t());
+        camera.t_r_c->setActive(true);
+        camera.extrinsicsInitialized = true;
+        if (_options.camera.verbose)
+          std::cout << __PRETTY_FUNCTION__ << ": camera " << i
+            << " initialized from camera " << anchor << std::endl;
+      }
+      return anchor;
+    }
+
+    void RigCalibrator::addObservations(const std::vector<ObservationPtr>&
+        observations, size_t anchor, sm::timing::NsecTime timestamp) {
+      // if the batch does not exist, create it
+      if (!_batch)
+        initBatch();
+
+      // the transformation that takes points from rig coordinates to target
+      // coordinates is shared by all the cameras of the frame
+      const sm::kinematics::Transformation T_r_a(_cameras[anchor].q_r_c->
+        getQuaternion(), _cameras[anchor].t_r_c->toEuclidean());
+      const sm::kinematics::Transformation T_t_r =
+        observations[anchor]->T_t_c() * T_r_a.inverse();
+      auto q_dv = boost::make_shared<aslam::backend::RotationQuaternion>(
+        T_t_r.q());
+      q_dv->setActive(true);
+      _batch->addDesignVariable(q_dv, _options.camera.transformationsGroupId);
+      auto t_dv = boost::make_shared<aslam::backend::EuclideanPoint>(
+        T_t_r.t());
+      t_dv->setActive(true);
+      _batch->addDesignVariable(t_dv, _options.camera.transformationsGroupId);
+      aslam::backend::RotationExpression q_dv_e(q_dv);
+      aslam::backend::EuclideanExpression t_dv_e(t_dv);
+      aslam::backend::TransformationExpression T_t_r_e(q_dv_e, t_dv_e);
+
+      for (size_t i = 0; i < _cameras.size(); ++i) {
+        if (!observations[i])
+          continue;
+        const Camera& camera = _cameras[i];
+        aslam::backend::RotationExpression q_r_c_e(camera.q_r_c);
+        aslam::backend::EuclideanExpression t_r_c_e(camera.t_r_c);
+        aslam::backend::TransformationExpression T_r_c_e(q_r_c_e, t_r_c_e);
+        auto T_c_t_e = (T_t_r_e * T_r_c_e).inverse();
+
+        // add the reprojection error terms
+        CameraCalibrator::addReprojectionErrors(*_batch, _options.camera,
+          *observations[i], T_c_t_e, _landmarkDesignVariables,
+          camera.geometry, camera.intrinsics.get());
+      }
+
+      _batchTimestamps.push_back(timestamp);
+      _batchNumFrames++;
+    }
+
+    size_t RigCalibrator::addImages(const std::vector<cv::Mat>& images,
+        sm::timing::NsecTime timestamp) {
+      if (images.size() != _cameras.size())
+        throw BadArgumentException<size_t>(images.size(),
+          "the number of images must match the number of cameras",
+          __FILE__, __LINE__, __PRETTY_FUNCTION__);
+
+      // find the target in the images of all the cameras
+      std::vector<ObservationPtr> observations;
+      detect(images, timestamp, observations);
+      size_t numFound = 0;
+      for (auto it = observations.cbegin(); it != observations.cend(); ++it)
+        if (*it)
+          numFound++;
+      if (_options.camera.verbose)
+        std::cout << __PRETTY_FUNCTION__ << ": target found by " << numFound
+          << "/" << _cameras.size() << " cameras at time "
+          << sm::timing::nsecToSec(timestamp) << std::endl;
+
+      addFrame(observations, timestamp);
+      return numFound;
+    }
+
+    void RigCalibrator::addFrame(const std::vector<ObservationPtr>&
+        observations, sm::timing::NsecTime timestamp) {
+      if (observations.size() != _cameras.size())
+        throw BadArgumentException<size_t>(observations.size(),
+          "the number of observations must match the number of cameras",
+          __FILE__, __LINE__, __PRETTY_FUNCTION__);
+
+      // frames only initialize the extrinsics until the rig is complete, the
+      // frame completing it is the first one added
+      const size_t anchor = initExtrinsics(observations);
+      if (!isInitialized() || anchor == _cameras.size())
+        return;
+
+      // add observations to the batch
+      addObservations(observations, anchor, timestamp);
+
+      // add batch if needed
+      if (_batchNumFrames == _options.camera.batchNumImages)
+        processBatch();
+    }
+
+    void RigCalibrator::processBatch() {
+      if (!_batch)
+        return;
+      auto ret = _estimator->addBatch(_batch);
+      if (ret.batchAccepted)
+        _estimatorTimestamps.insert(_estimatorTimestamps.end(),
+          _batchTimestamps.begin(), _batchTimestamps.end());
+      if (_options.camera.verbose) {
+        std::cout << std::endl;
+        ret.batchAccepted ? std::cout << "ACCEPTED" : std::cout << "REJECTED";
+        std::cout << std::endl;
+        std::cout << "information gain: " << ret.informationGain << std::endl;
+        for (size_t i = 0; i < _cameras.size(); ++i) {
+          std::cout << "camera " << i << " projection: "
+            << getProjection(i).transpose() << std::endl;
+          std::cout << "camera " << i << " projection standard deviation: "
+            << getProjectionStandardDeviation(i).transpose() << std::endl;
+          std::cout << "camera " << i << " distortion: "
+            << getDistortion(i).transpose() << std::endl;
+          std::cout << "camera " << i << " distortion standard deviation: "
+            << getDistortionStandardDeviation(i).transpose() << std::endl;
+          std::cout << "camera " << i << " extrinsics: " << std::endl
+            << getExtrinsics(i) << std::endl;
+        }
+        std::cout << "number of frames used: " << _estimatorTimestamps.size()
+          << std::endl;
+        std::cout << std::endl;
+      }
+      initBatch();
+      _batchNumFrames = 0;
+    }
+
+    void RigCalibrator::write(sm::PropertyTree& config) const {
+      config.setInt("numCameras", _cameras.size());
+      config.setInt("referenceCamera", _options.referenceCamera);
+      for (size_t i = 0; i < _cameras.size(); ++i) {
+        std::stringstream cameraKey;
+        cameraKey << "cam" << i;
+        sm::PropertyTree cameraConfig(config, cameraKey.str());
+        CameraCalibrator::writeIntrinsics(cameraConfig, _options.camera,
+          _cameras[i].geometry, getProjectionStandardDeviation(i),
+          getDistortionStandardDeviation(i));
+        const Eigen::Matrix4d T_r_c = getExtrinsics(i);
+        for (std::ptrdiff_t r = 0; r < 3; ++r) {
+          for (std::ptrdiff_t c = 0; c < 4; ++c) {
+            std::stringstream stream;
+            stream << "extrinsics/T_r_c/r" << r << "/c" << c;
+            cameraConfig.setDouble(stream.str(), T_r_c(r, c));
+          }
+        }
+      }
+      const Eigen::VectorXd singularValues = _estimator->getSingularValues();
+      for (std::ptrdiff_t i = 0; i < singularValues.size(); ++i) {
+        std::stringstream stream;
+        stream << "singularValues/x" << i;
+        config.setDouble(stream.str(), singularValues(i));
+      }
+      config.setDouble("epsSVD", _estimator->getLinearSolverOptions().epsSVD);
+      config.setDouble("infoGainDelta", _estimator->getOptions().infoGainDelta);
+    }
+
+  }
+}
@@ -0,0 +1,139 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "aslam/calibration/camera/ViewNoveltyFilter.h"
+
+#include <cmath>
+
+#include <vector>
+#include <algorithm>
+
+#include <sm/kinematics/Transformation.hpp>
+
+#include <aslam/cameras/GridCalibrationTargetObservation.hpp>
+
+namespace aslam {
+  namespace calibration {
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+    ViewNoveltyFilter::ViewNoveltyFilter(size_t width, size_t height, const
+        Options& options) :
+        _options(options),
+        _coverage(CoverageHistogram::Coordinate(0.0, 0.0),
+          CoverageHistogram::Coordinate(width, height),
+          CoverageHistogram::Coordinate(options.imageCellSize,
+          options.imageCellSize)),
+        _poses(PoseHistogram::Coordinate(-M_PI / 2, -M_PI / 2, 0.0),
+          PoseHistogram::Coordinate(M_PI / 2, M_PI / 2, options.maxDistance),
+          PoseHistogram::Coordinate(options.angleResolution,
+          options.angleResolution, options.distanceResolution)),
+        _numAccepted(0),
+        _numSkipped(0) {
+    }
+
+    ViewNoveltyFilter::~ViewNoveltyFilter() {
+    }
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+    const ViewNoveltyFilter::Options& ViewNoveltyFilter::getOptions() const {
+      return _options;
+    }
+
+    size_t ViewNoveltyFilter::getNumAccepted() const {
+      return _numAccepted;
+    }
+
+    size_t ViewNoveltyFilter::getNumSkipped() const {
+      return _numSkipped;
+    }
+
+    const ViewNoveltyFilter::CoverageHistogram&
+        ViewNoveltyFilter::getCoverage() const {
+      return _coverage;
+    }
+
+    const ViewNoveltyFilter::PoseHistogram& ViewNoveltyFilter::getPoses()
+        const {
+      return _poses;
+    }
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    ViewNoveltyFilter::PoseHistogram::Coordinate
+        ViewNoveltyFilter::getPoseCoordinate(const Observation& observation)
+        const {
+      const Eigen::Matrix4d T_c_t =
+        const_cast<Observation&>(observation).T_t_c().inverse().T();
+      const Eigen::Vector3d normal = T_c_t.block<3, 1>(0, 2);
+      const double distance = T_c_t.block<3, 1>(0, 3).norm();
+      return PoseHistogram::Coordinate(
+        std::atan2(normal(0), std::fabs(normal(2))),
+        std::atan2(normal(1), std::fabs(normal(2))),
+        std::min(distance, _options.maxDistance));
+    }
+
+    bool ViewNoveltyFilter::addObservation(const Observation& observation,
+        size_t numCorners) {
+      const PoseHistogram::Coordinate pose = getPoseCoordinate(observation);
+      const bool novelPose = _poses.isInRange(pose) &&
+        !_poses.isOccupied(_poses.getIndex(pose));
+
+      // image cells covered by the view, counted once
+      std::vector<CoverageHistogram::Coordinate> corners;
+      corners.reserve(numCorners);
+      std::vector<size_t> newCells;
+      for (size_t i = 0; i < numCorners; ++i) {
+        Eigen::Vector2d point;
+        if (!observation.imagePoint(i, point) || !_coverage.isInRange(point))
+          continue;
+        corners.push_back(point);
+        const CoverageHistogram::Index idx = _coverage.getIndex(point);
+        if (_coverage[idx] == 0.0)
+          newCells.push_back(_coverage.computeLinearIndex(idx));
+      }
+      std::sort(newCells.begin(), newCells.end());
+      const size_t numNewCells = std::unique(newCells.begin(),
+        newCells.end()) - newCells.begin();
+
+      if (!novelPose && numNewCells < _options.minNewImageCells) {
+        _numSkipped++;
+        return false;
+      }
+      _poses.addSample(pose);
+      _coverage.addSamples(corners);
+      _numAccepted++;
+      return true;
+    }
+
+    void ViewNoveltyFilter::reset() {
+      _coverage.reset();
+      _poses.reset();
+      _numAccepted = 0;
+      _numSkipped = 0;
+    }
+
+  }
+}
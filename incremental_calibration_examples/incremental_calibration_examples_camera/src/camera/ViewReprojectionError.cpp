@@ -0,0 +1,224 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+#include "aslam/calibration/camera/ViewReprojectionError.h"
+
+#include <cmath>
+#include <map>
+
+#include <sm/kinematics/homogeneous_coordinates.hpp>
+
+#include <aslam/cameras/CameraGeometryBase.hpp>
+
+#include <aslam/backend/MEstimatorPolicies.hpp>
+#include <aslam/backend/JacobianContainer.hpp>
+
+#include <aslam/CameraGeometryDesignVariableContainer.hpp>
+
+#include <aslam/calibration/exceptions/BadArgumentException.h>
+#include <aslam/calibration/exceptions/OutOfBoundException.h>
+
+namespace aslam {
+  namespace calibration {
+
+/******************************************************************************/
+/* Constructors and Destructor                                                */
+/******************************************************************************/
+
+    ViewReprojectionError::ViewReprojectionError(const Eigen::Matrix2Xd& y,
+        double invR, const aslam::backend::TransformationExpression& T_c_t,
+        const std::vector<aslam::backend::HomogeneousExpression>& points,
+        const CameraGeometryPtr& geometry,
+        CameraGeometryDesignVariableContainer* camera,
+        const MEstimatorPtr& pointsMEstimator) :
+        ErrorTermDs(2 * y.cols()),
+        _y(y),
+        _invR(invR),
+        _T_c_t(T_c_t),
+        _points(points),
+        _geometry(geometry),
+        _camera(camera),
+        _pointsMEstimator(pointsMEstimator),
+        _errors(Eigen::Matrix2Xd::Zero(2, y.cols())),
+        _weights(Eigen::VectorXd::Ones(y.cols())) {
+      if (static_cast<size_t>(_y.cols()) != _points.size())
+        throw BadArgumentException<size_t>(_points.size(),
+          "number of target points must match the number of image points",
+          __FILE__, __LINE__, __PRETTY_FUNCTION__);
+      aslam::backend::DesignVariable::set_t dv;
+      _T_c_t.getDesignVariables(dv);
+      for (auto it = _points.cbegin(); it != _points.cend(); ++it)
+        it->getDesignVariables(dv);
+      _camera->getDesignVariables(dv);
+      setDesignVariablesIterator(dv.begin(), dv.end());
+    }
+
+    ViewReprojectionError::ViewReprojectionError(const ViewReprojectionError&
+        other) :
+        ErrorTermDs(other),
+        _y(other._y),
+        _invR(other._invR),
+        _T_c_t(other._T_c_t),
+        _points(other._points),
+        _geometry(other._geometry),
+        _camera(other._camera),
+        _pointsMEstimator(other._pointsMEstimator),
+        _errors(other._errors),
+        _weights(other._weights) {
+    }
+
+    ViewReprojectionError& ViewReprojectionError::operator =
+        (const ViewReprojectionError& other) {
+      if (this != &other) {
+        ErrorTermDs::operator=(other);
+        _y = other._y;
+        _invR = other._invR;
+        _T_c_t = other._T_c_t;
+        _points = other._points;
+        _geometry = other._geometry;
+        _camera = other._camera;
+        _pointsMEstimator = other._pointsMEstimator;
+        _errors = other._errors;
+        _weights = other._weights;
+      }
+      return *this;
+    }
+
+    ViewReprojectionError::~ViewReprojectionError() {
+    }
+
+/******************************************************************************/
+/* Accessors                                                                  */
+/******************************************************************************/
+
+    size_t ViewReprojectionError::getNumPoints() const {
+      return _points.size();
+    }
+
+    Eigen::Vector2d ViewReprojectionError::getPointError(size_t i) const {
+      if (i >= _points.size())
+        throw OutOfBoundException<size_t>(i, _points.size(),
+          "index must be stricly smaller than the number of points",
+          __FILE__, __LINE__, __PRETTY_FUNCTION__);
+      return _errors.col(i);
+    }
+
+    double ViewReprojectionError::getPointSquaredError(size_t i) const {
+      if (i >= _points.size())
+        throw OutOfBoundException<size_t>(i, _points.size(),
+          "index must be stricly smaller than the number of points",
+          __FILE__, __LINE__, __PRETTY_FUNCTION__);
+      return _invR * _errors.col(i).squaredNorm();
+    }
+
+/******************************************************************************/
+/* Methods                                                                    */
+/******************************************************************************/
+
+    void ViewReprojectionError::project(const Eigen::Matrix4d& T_c_t,
+        Eigen::Matrix2Xd& y, std::vector<Eigen::MatrixXd>* J) const {
+      y.resize(2, _points.size());
+      if (J)
+        J->resize(_points.size());
+      Eigen::VectorXd keypoint;
+      for (size_t i = 0; i < _points.size(); ++i) {
+        const Eigen::Vector4d p_c = T_c_t * _points[i].toHomogeneous();
+        if (J)
+          _geometry->vsHomogeneousToKeypoint(p_c, keypoint, (*J)[i]);
+        else
+          _geometry->vsHomogeneousToKeypoint(p_c, keypoint);
+        y.col(i) = keypoint;
+      }
+    }
+
+    void ViewReprojectionError::updateWeights() {
+      for (size_t i = 0; i < _points.size(); ++i)
+        _weights(i) = _pointsMEstimator ?
+          _pointsMEstimator->getWeight(getPointSquaredError(i)) : 1.0;
+    }
+
+    double ViewReprojectionError::getPointScale(size_t i) const {
+      return std::sqrt(_invR * _weights(i));
+    }
+
+    double ViewReprojectionError::evaluateErrorImplementation() {
+      Eigen::Matrix2Xd y;
+      project(_T_c_t.toTransformationMatrix(), y);
+      _errors = _y - y;
+      updateWeights();
+
+      // the information and the robust weight of each point scale its error,
+      // the information matrix of the term stays the identity
+      Eigen::VectorXd error(dimension());
+      for (size_t i = 0; i < _points.size(); ++i)
+        error.segment<2>(2 * i) = getPointScale(i) * _errors.col(i);
+      setError(error);
+      return error.squaredNorm();
+    }
+
+    void ViewReprojectionError::evaluateJacobiansImplementation(
+        aslam::backend::JacobianContainer& jacobians) {
+      const Eigen::Matrix4d T_c_t = _T_c_t.toTransformationMatrix();
+      Eigen::Matrix2Xd y;
+      std::vector<Eigen::MatrixXd> J_p;
+      project(T_c_t, y, &J_p);
+
+      // the pose Jacobians of all the points are pushed in a single call
+      Eigen::MatrixXd J_T(dimension(), 6);
+      for (size_t i = 0; i < _points.size(); ++i) {
+        J_p[i] *= -getPointScale(i);
+        J_T.middleRows<2>(2 * i) = J_p[i] *
+          sm::kinematics::boxMinus(T_c_t * _points[i].toHomogeneous());
+      }
+      _T_c_t.evaluateJacobians(jacobians, J_T);
+
+      // target points are only visited when they are estimated
+      for (size_t i = 0; i < _points.size(); ++i) {
+        aslam::backend::DesignVariable::set_t dv;
+        _points[i].getDesignVariables(dv);
+        bool active = false;
+        for (auto it = dv.cbegin(); it != dv.cend(); ++it)
+          active |= (*it)->isActive();
+        if (!active)
+          continue;
+        Eigen::MatrixXd J_l = Eigen::MatrixXd::Zero(dimension(), 4);
+        J_l.middleRows<2>(2 * i) = J_p[i] * T_c_t;
+        _points[i].evaluateJacobians(jacobians, J_l);
+      }
+
+      // the analytic intrinsics Jacobians of the points are stacked and
+      // pushed once per design variable
+      std::map<aslam::backend::DesignVariable*, Eigen::MatrixXd> J_c;
+      aslam::backend::JacobianContainer J_i(2);
+      for (size_t i = 0; i < _points.size(); ++i) {
+        J_i.clear();
+        _camera->evaluateJacobians(J_i, -getPointScale(i) *
+          Eigen::Matrix2d::Identity(), T_c_t * _points[i].toHomogeneous());
+        for (auto it = J_i.begin(); it != J_i.end(); ++it) {
+          Eigen::MatrixXd& J = J_c[it->first];
+          if (!J.size())
+            J = Eigen::MatrixXd::Zero(dimension(), it->second.cols());
+          J.middleRows<2>(2 * i) = it->second;
+        }
+      }
+      for (auto it = J_c.cbegin(); it != J_c.cend(); ++it)
+        jacobians.add(it->first, it->second);
+    }
+
+  }
+}
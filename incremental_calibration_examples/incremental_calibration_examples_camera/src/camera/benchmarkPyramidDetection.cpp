@@ -0,0 +1,200 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file benchmarkPyramidDetection.cpp
+    \brief This file compares the full resolution and the coarse-to-fine
+           target detections on a rendered checkerboard sequence.
+  */
+
+#include <cmath>
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <sstream>
+#include <map>
+#include <limits>
+#include <chrono>
+#include <algorithm>
+
+#include <Eigen/Core>
+
+#include <boost/filesystem.hpp>
+#include <boost/make_shared.hpp>
+
+#include <opencv2/core/core.hpp>
+
+#include <sm/BoostPropertyTree.hpp>
+
+#include <aslam/cameras.hpp>
+#include <aslam/cameras/GridCalibrationTargetCheckerboard.hpp>
+#include <aslam/cameras/GridCalibrationTargetObservation.hpp>
+#include <aslam/cameras/GridDetector.hpp>
+
+#include "aslam/calibration/camera/CameraCalibrator.h"
+#include "aslam/calibration/camera/ImageSequenceReader.h"
+#include "aslam/calibration/camera/PyramidTargetExtractor.h"
+
+using namespace aslam::calibration;
+using namespace sm;
+
+/// Corner accuracy and timing of a detection path
+struct PathStatistics {
+  /// Default constructor
+  PathStatistics() :
+      numDetected(0),
+      numCorners(0),
+      squaredErrorSum(0.0),
+      maxError(0.0),
+      seconds(0.0) {}
+  /// Number of images with a detection
+  size_t numDetected;
+  /// Number of corners compared to the ground truth
+  size_t numCorners;
+  /// Sum of the squared corner errors
+  double squaredErrorSum;
+  /// Maximum corner error
+  double maxError;
+  /// Detection time in seconds
+  double seconds;
+};
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " <rendered_sequence> <conf_file>"
+      << std::endl;
+    return -1;
+  }
+
+  // loading configuration
+  std::cout << "Loading configuration parameters..." << std::endl;
+  BoostPropertyTree config;
+  config.loadXml(argv[2]);
+  const PropertyTree renderer(config, "camera/renderer");
+  const double fu = renderer.getDouble("fu");
+  const double fv = renderer.getDouble("fv");
+  const double u0 = renderer.getDouble("cu");
+  const double v0 = renderer.getDouble("cv");
+  CameraCalibrator calibrator(PropertyTree(config, "camera/calibrator"));
+  const auto& target = calibrator.getCalibrationTarget();
+  PyramidTargetExtractor::Options extractorOptions;
+  extractorOptions.numLevels = calibrator.getOptions().pyramidLevels ?
+    calibrator.getOptions().pyramidLevels : 2;
+  extractorOptions.refinementWindow =
+    calibrator.getOptions().pyramidRefinementWindow;
+  const PyramidTargetExtractor extractor(target, extractorOptions);
+  aslam::cameras::GridDetector detector(
+    boost::make_shared<aslam::cameras::DistortedPinholeCameraGeometry>(),
+    target, aslam::cameras::GridDetector::GridDetectorOptions());
+
+  // ground truth poses written by the renderer
+  const std::string input(argv[1]);
+  const bool raw = boost::filesystem::path(input).extension() == ".raw";
+  std::ifstream posesFile(raw ? input + ".poses" :
+    (boost::filesystem::path(input) / "poses.txt").string());
+  std::map<timing::NsecTime, Eigen::Matrix4d> poses;
+  timing::NsecTime timestamp;
+  while (posesFile >> timestamp) {
+    Eigen::Matrix4d T_t_c = Eigen::Matrix4d::Identity();
+    for (size_t r = 0; r < 3; ++r)
+      for (size_t c = 0; c < 4; ++c)
+        posesFile >> T_t_c(r, c);
+    poses[timestamp] = T_t_c;
+  }
+
+  // the corner ordering of a detection is ambiguous on a symmetric board, a
+  // corner is compared to the closest projected target point
+  auto compare = [&](const aslam::cameras::GridCalibrationTargetObservation&
+      observation, const Eigen::Matrix4d& T_t_c, PathStatistics& statistics) {
+    const Eigen::Matrix4d T_c_t = T_t_c.inverse();
+    Eigen::Matrix2Xd truth(2, target->size());
+    for (size_t i = 0; i < target->size(); ++i) {
+      const Eigen::Vector3d p = T_c_t.topLeftCorner<3, 3>() *
+        target->point(i) + T_c_t.topRightCorner<3, 1>();
+      truth.col(i) << fu * p(0) / p(2) + u0, fv * p(1) / p(2) + v0;
+    }
+    for (size_t i = 0; i < target->size(); ++i) {
+      Eigen::Vector2d point;
+      if (!observation.imagePoint(i, point))
+        continue;
+      const double error = std::sqrt((truth.colwise() - point).colwise().
+        squaredNorm().minCoeff());
+      statistics.numCorners++;
+      statistics.squaredErrorSum += error * error;
+      statistics.maxError = std::max(statistics.maxError, error);
+    }
+  };
+
+  std::cout << "Detecting targets..." << std::endl;
+  ImageSequenceReader reader(input, PropertyTree(config, "camera"));
+  PathStatistics full, pyramid;
+  ImageSequenceReader::Frame frame;
+  while (reader.read(frame)) {
+    std::cout << std::fixed << std::setw(3)
+      << reader.getNumImagesRead() / (double)reader.getNumImages() * 100
+      << " %" << '\r';
+    auto pose = poses.find(frame.timestamp);
+    const aslam::Time stamp(timing::nsecToSec(frame.timestamp));
+
+    aslam::cameras::GridCalibrationTargetObservation fullObservation;
+    auto start = std::chrono::steady_clock::now();
+    const bool fullFound = detector.findTargetNoTransformation(frame.image,
+      stamp, fullObservation);
+    full.seconds += std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+    aslam::cameras::GridCalibrationTargetObservation pyramidObservation;
+    start = std::chrono::steady_clock::now();
+    const bool pyramidFound = extractor.extract(detector, frame.image,
+      frame.timestamp, pyramidObservation);
+    pyramid.seconds += std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+    if (fullFound) {
+      full.numDetected++;
+      if (pose != poses.end())
+        compare(fullObservation, pose->second, full);
+    }
+    if (pyramidFound) {
+      pyramid.numDetected++;
+      if (pose != poses.end())
+        compare(pyramidObservation, pose->second, pyramid);
+    }
+  }
+
+  const size_t numImages = reader.getNumImagesRead();
+  auto print = [&](const std::string& name, const PathStatistics&
+      statistics) {
+    std::cout << name << ": detected " << statistics.numDetected << "/"
+      << numImages << "   corner error rms = " << (statistics.numCorners ?
+      std::sqrt(statistics.squaredErrorSum / statistics.numCorners) :
+      std::numeric_limits<double>::quiet_NaN()) << " px   max = "
+      << statistics.maxError << " px   throughput = " << (statistics.seconds >
+      0.0 ? numImages / statistics.seconds : 0.0) << " images/s"
+      << std::endl;
+  };
+  std::cout << std::endl << std::setprecision(4);
+  print("full resolution", full);
+  std::stringstream name;
+  name << "pyramid (" << extractorOptions.numLevels << " levels, window "
+    << extractor.getRefinementWindow() << ")";
+  print(name.str(), pyramid);
+
+  return 0;
+}
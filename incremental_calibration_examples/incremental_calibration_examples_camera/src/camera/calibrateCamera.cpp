@@ -17,7 +17,7 @@
  ******************************************************************************/
 
 /** \file calibrateCamera.cpp
-    \brief This file calibrates the camera intrinsics from a BAG file.
+    \brief This file calibrates the camera intrinsics from an image sequence.
   */
 
 #include <iostream>
@@ -27,32 +27,33 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <map>
 
 #include <boost/filesystem.hpp>
-
-#include <rosbag/bag.h>
-#include <rosbag/view.h>
-#include <rosbag/message_instance.h>
-
-#include <sensor_msgs/Image.h>
-
-#include <cv_bridge/cv_bridge.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
 
 #include <sm/BoostPropertyTree.hpp>
 
 #include <opencv2/highgui/highgui.hpp>
 
+#include <aslam/cameras/GridCalibrationTargetCheckerboard.hpp>
+#include <aslam/cameras/GridCalibrationTargetObservation.hpp>
+
 #include <aslam/calibration/core/IncrementalEstimator.h>
 #include <aslam/calibration/base/Timestamp.h>
 
 #include "aslam/calibration/camera/CameraCalibrator.h"
+#include "aslam/calibration/camera/ViewNoveltyFilter.h"
+#include "aslam/calibration/camera/ImageSequenceReader.h"
+#include "aslam/calibration/camera/DetectionCache.h"
 
 using namespace aslam::calibration;
 using namespace sm;
 
 int main(int argc, char** argv) {
   if (argc != 3) {
-    std::cerr << "Usage: " << argv[0] << " <ros_bag_file> <conf_file>"
+    std::cerr << "Usage: " << argv[0] <<  " <image_sequence> <conf_file>"
       << std::endl;
     return -1;
   }
@@ -66,51 +67,118 @@ int main(int argc, char** argv) {
   // create the camera calibrator
   CameraCalibrator calibrator(PropertyTree(config, "camera/calibrator"));
 
-  // load ros bag file
-  rosbag::Bag bag(argv[1]);
-  std::vector<std::string> topics;
-  const std::string rosTopic = config.getString("camera/rosTopic");
-  topics.push_back(rosTopic);
-  rosbag::View view(bag, rosbag::TopicQuery(topics));
-
-  // initializing geometry from the dataset
-  std::cout << "Initializing geometry..." << std::endl;
-  for (auto it = view.begin(); it != view.end(); ++it) {
-    if (it->getTopic() == rosTopic) {
-      sensor_msgs::ImagePtr image(it->instantiate<sensor_msgs::Image>());
-      auto cvImage = cv_bridge::toCvCopy(image);
-      if (calibrator.initGeometry(cvImage->image))
-        break;
-    }
+  // open image sequence
+  ImageSequenceReader reader(argv[1], PropertyTree(config, "camera"));
+
+  // open detection cache, cached images are not decoded
+  boost::shared_ptr<DetectionCache> cache;
+  const std::string cacheFilename =
+    config.getString("camera/calibrator/detectionCache", "");
+  if (!cacheFilename.empty()) {
+    cache = boost::make_shared<DetectionCache>(cacheFilename,
+      calibrator.getCalibrationTarget(),
+      CameraCalibrator::hashDetectionOptions(calibrator.getOptions()));
+    reader.setDecodePredicate([&cache](uint64_t hash){
+      return !cache->contains(hash);});
   }
 
-  // processing ros bag file
-  std::cout << "Processing BAG file..." << std::endl;
-  size_t viewCounter = 0;
-  for (auto it = view.begin(); it != view.end(); ++it) {
+  // processing image sequence, the geometry is initialized from the first
+  // image where it succeeds
+  std::cout << "Processing image sequence..." << std::endl;
+  const size_t chunkSize =
+    config.getInt("camera/calibrator/detectionChunkSize", 1);
+  const bool saveEstimatorImages =
+    config.getBool("camera/calibrator/saveEstimatorImages");
+  std::vector<cv::Mat> images;
+  std::vector<timing::NsecTime> timestamps;
+  std::vector<uint64_t> hashes;
+  images.reserve(chunkSize);
+  timestamps.reserve(chunkSize);
+  hashes.reserve(chunkSize);
+  // the calibrator does not keep the images, those of the current batch are
+  // held here until the batch is processed
+  std::map<timing::NsecTime, cv::Mat> batchImages;
+  auto saveImages = [&](size_t numObservations) {
+    const auto& observations = calibrator.getEstimatorObservations();
+    for (size_t i = numObservations; i < observations.size(); ++i) {
+      auto it = batchImages.find(observations[i].timestamp);
+      if (it == batchImages.end())
+        continue;
+      if (!boost::filesystem::exists("images"))
+        boost::filesystem::create_directory("images");
+      std::stringstream stream;
+      stream << "images/" << config.getString("camera/cameraId") << "-"
+        << it->first << ".png";
+      cv::imwrite(stream.str().c_str(), it->second);
+    }
+    std::map<timing::NsecTime, cv::Mat> pendingImages;
+    const auto& batchObservations = calibrator.getBatchObservations();
+    for (auto it = batchObservations.cbegin(); it != batchObservations.cend();
+        ++it)
+      if (batchImages.count(it->timestamp))
+        pendingImages[it->timestamp] = batchImages[it->timestamp];
+    batchImages.swap(pendingImages);
+  };
+  auto addChunk = [&]() {
+    const size_t numObservations =
+      calibrator.getEstimatorObservations().size();
+    if (saveEstimatorImages)
+      for (size_t i = 0; i < images.size(); ++i)
+        batchImages[timestamps[i]] = images[i];
+    // only the extractions are cached, their completion depends on the
+    // current geometry
+    std::vector<CameraCalibrator::ObservationPtr> targets;
+    calibrator.addImages(images, timestamps, NULL, &targets);
+    if (cache)
+      for (size_t i = 0; i < targets.size(); ++i)
+        cache->insert(hashes[i], targets[i]);
+    images.clear();
+    timestamps.clear();
+    hashes.clear();
+    if (saveEstimatorImages)
+      saveImages(numObservations);
+  };
+  bool geometryInitialized = false;
+  timing::NsecTime beginTime = 0;
+  ImageSequenceReader::Frame frame;
+  while (reader.read(frame)) {
     std::cout << std::fixed << std::setw(3)
-      << viewCounter++ / (double)view.size() * 100 << " %" << '\r';
-    if (it->getTopic() == rosTopic) {
-      sensor_msgs::ImagePtr image(it->instantiate<sensor_msgs::Image>());
-      auto cvImage = cv_bridge::toCvCopy(image);
-      const size_t numObservations =
-        calibrator.getEstimatorObservations().size();
-      calibrator.addImage(cvImage->image, image->header.stamp.toNSec());
-      if (config.getBool("camera/calibrator/saveEstimatorImages")) {
-        if (calibrator.getEstimatorObservations().size() != numObservations) {
-          cv::Mat checkerboardImage;
-          calibrator.getLastCheckerboardImage(checkerboardImage);
-          if (!boost::filesystem::exists("images"))
-            boost::filesystem::create_directory("images");
-          std::stringstream stream;
-          stream << "images/" << config.getString("camera/cameraId") << "-"
-            << image->header.stamp.toNSec() << ".png";
-          cv::imwrite(stream.str().c_str(), checkerboardImage);
-        }
+      << reader.getNumImagesRead() / (double)reader.getNumImages() * 100
+      << " %" << '\r';
+    if (reader.getNumImagesRead() == 1)
+      beginTime = frame.timestamp;
+    CameraCalibrator::ObservationPtr observation;
+    if (cache && cache->lookup(frame.hash, frame.timestamp, observation)) {
+      if (!observation)
+        continue;
+      if (!geometryInitialized) {
+        geometryInitialized = calibrator.initGeometry(*observation);
+        if (!geometryInitialized)
+          continue;
       }
+      // keep the timestamp order with the pending images
+      if (!images.empty())
+        addChunk();
+      calibrator.addDetection(observation, frame.timestamp);
+      continue;
     }
+    if (!geometryInitialized) {
+      geometryInitialized = calibrator.initGeometry(frame.image);
+      if (!geometryInitialized)
+        continue;
+    }
+    images.push_back(frame.image);
+    timestamps.push_back(frame.timestamp);
+    hashes.push_back(frame.hash);
+    if (images.size() >= chunkSize)
+      addChunk();
   }
+  if (!images.empty())
+    addChunk();
+  const size_t numObservations = calibrator.getEstimatorObservations().size();
   calibrator.processBatch();
+  if (saveEstimatorImages)
+    saveImages(numObservations);
 
   std::cout << "final parameters: " << std::endl;
   std::cout << "projection: " << calibrator.getProjection().transpose()
@@ -129,7 +197,16 @@ int main(int argc, char** argv) {
   std::cout << "final cost: " << calibrator.getFinalCost() << std::endl;
   std::cout << "number of images for estimation: "
     << calibrator.getEstimatorObservations().size() << std::endl;
-  std::cout << "total number of images: " << view.size() << std::endl;
+  std::cout << "total number of images: " << reader.getNumImagesRead()
+    << std::endl;
+  if (cache)
+    std::cout << "detection cache hits: " << cache->getNumHits() << "/"
+      << reader.getNumImagesRead() << std::endl;
+  if (calibrator.getNoveltyFilter())
+    std::cout << "views skipped by the novelty filter: "
+      << calibrator.getNumSkippedViews() << "/"
+      << calibrator.getNumSkippedViews() +
+      calibrator.getNoveltyFilter()->getNumAccepted() << std::endl;
   Eigen::VectorXd mean, variance, standardDeviation;
   double maxXError, maxYError;
   size_t numOutliers;
@@ -149,7 +226,7 @@ int main(int argc, char** argv) {
   std::stringstream stream;
   stream << config.getString("camera/cameraId") << "-"
     << config.getString("camera/calibrator/cameraProjectionType") << "-"
-    << Timestamp::getDate(view.getBeginTime().toSec()) << "-"
+    << Timestamp::getDate(timing::nsecToSec(beginTime)) << "-"
     << calibrator.getOptions().batchNumImages << "-"
     << calibrator.getEstimator()->getOptions().infoGainDelta<< ".xml";
   calibrationData.saveXml(stream.str());
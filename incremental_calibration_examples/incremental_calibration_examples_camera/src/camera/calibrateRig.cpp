@@ -0,0 +1,152 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file calibrateRig.cpp
+    \brief This file calibrates a rig of cameras from synchronized image
+           sequences.
+  */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include <sm/BoostPropertyTree.hpp>
+
+#include <aslam/calibration/core/IncrementalEstimator.h>
+#include <aslam/calibration/base/Timestamp.h>
+
+#include "aslam/calibration/camera/RigCalibrator.h"
+#include "aslam/calibration/camera/ReprojectionErrorStatistics.h"
+#include "aslam/calibration/camera/ImageSequenceReader.h"
+
+using namespace aslam::calibration;
+using namespace sm;
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+      << " <conf_file> <image_sequence_0> [<image_sequence_1> ...]"
+      << std::endl;
+    return -1;
+  }
+
+  // loading configuration
+  std::cout << "Loading configuration parameters..." << std::endl;
+  BoostPropertyTree config;
+  config.loadXml(argv[1]);
+
+  // create the rig calibrator
+  const size_t numCameras = argc - 2;
+  RigCalibrator calibrator(PropertyTree(config, "camera/calibrator"),
+    numCameras);
+
+  // open one image sequence per camera
+  std::vector<boost::shared_ptr<ImageSequenceReader> > readers;
+  readers.reserve(numCameras);
+  for (size_t i = 0; i < numCameras; ++i)
+    readers.push_back(boost::make_shared<ImageSequenceReader>(argv[i + 2],
+      PropertyTree(config, "camera")));
+
+  // processing image sequences, the images within the synchronization
+  // tolerance of the earliest pending image form a rig frame
+  std::cout << "Processing image sequences..." << std::endl;
+  const timing::NsecTime syncTolerance =
+    config.getInt("camera/calibrator/rig/syncTolerance", 1000000);
+  std::vector<ImageSequenceReader::Frame> frames(numCameras);
+  std::vector<bool> pending(numCameras);
+  for (size_t i = 0; i < numCameras; ++i)
+    pending[i] = readers[i]->read(frames[i]);
+  size_t numFrames = 0;
+  timing::NsecTime beginTime = 0;
+  while (std::find(pending.cbegin(), pending.cend(), true) !=
+      pending.cend()) {
+    timing::NsecTime timestamp = 0;
+    bool first = true;
+    for (size_t i = 0; i < numCameras; ++i)
+      if (pending[i] && (first || frames[i].timestamp < timestamp)) {
+        timestamp = frames[i].timestamp;
+        first = false;
+      }
+    if (!numFrames)
+      beginTime = timestamp;
+    std::vector<cv::Mat> images(numCameras);
+    for (size_t i = 0; i < numCameras; ++i)
+      if (pending[i] && frames[i].timestamp - timestamp <= syncTolerance) {
+        images[i] = frames[i].image;
+        pending[i] = readers[i]->read(frames[i]);
+      }
+    calibrator.addImages(images, timestamp);
+    numFrames++;
+  }
+  calibrator.processBatch();
+
+  std::cout << "final parameters: " << std::endl;
+  for (size_t i = 0; i < numCameras; ++i) {
+    std::cout << "camera " << i << " projection: "
+      << calibrator.getProjection(i).transpose() << std::endl;
+    std::cout << "camera " << i << " projection standard deviation: "
+      << calibrator.getProjectionStandardDeviation(i).transpose()
+      << std::endl;
+    std::cout << "camera " << i << " distortion: "
+      << calibrator.getDistortion(i).transpose() << std::endl;
+    std::cout << "camera " << i << " distortion standard deviation: "
+      << calibrator.getDistortionStandardDeviation(i).transpose()
+      << std::endl;
+    std::cout << "camera " << i << " extrinsics: " << std::endl
+      << calibrator.getExtrinsics(i) << std::endl;
+    std::cout << "camera " << i << " extrinsics standard deviation: "
+      << calibrator.getExtrinsicsStandardDeviation(i).transpose()
+      << std::endl;
+  }
+  std::cout << "rig initialized: " << calibrator.isInitialized() << std::endl;
+  std::cout << "number of frames for estimation: "
+    << calibrator.getEstimatorTimestamps().size() << std::endl;
+  std::cout << "total number of frames: " << numFrames << std::endl;
+  const ReprojectionErrorStatistics statistics = calibrator.getStatistics();
+  if (statistics.getValid()) {
+    std::cout << "reprojection error mean: "
+      << statistics.getMean().transpose() << std::endl;
+    std::cout << "reprojection error standard deviation: "
+      << statistics.getCovariance().diagonal().array().sqrt().transpose()
+      << std::endl;
+    std::cout << "max x reprojection error: " << statistics.getMaxXError()
+      << std::endl;
+    std::cout << "max y reprojection error: " << statistics.getMaxYError()
+      << std::endl;
+    std::cout << "number of outliers: " << statistics.getNumOutliers()
+      << std::endl;
+  }
+
+  // write calibration to xml file
+  BoostPropertyTree calibrationData("rig");
+  calibrator.write(calibrationData);
+  std::stringstream stream;
+  stream << "rig-" << numCameras << "-"
+    << config.getString("camera/calibrator/cameraProjectionType") << "-"
+    << Timestamp::getDate(timing::nsecToSec(beginTime)) << "-"
+    << calibrator.getOptions().camera.batchNumImages << "-"
+    << calibrator.getEstimator()->getOptions().infoGainDelta << ".xml";
+  calibrationData.saveXml(stream.str());
+
+  return 0;
+}
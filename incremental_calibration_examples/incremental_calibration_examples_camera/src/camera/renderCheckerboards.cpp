@@ -0,0 +1,166 @@
+/******************************************************************************
+ * Copyright (C) 2014 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file renderCheckerboards.cpp
+    \brief This file renders a synthetic checkerboard sequence seen by a
+           pinhole camera, for testing the calibration offline.
+  */
+
+#include <cmath>
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <sstream>
+#include <random>
+#include <algorithm>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include <boost/filesystem.hpp>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+#include <sm/BoostPropertyTree.hpp>
+
+#include "aslam/calibration/camera/ImageSequenceReader.h"
+
+using namespace aslam::calibration;
+using namespace sm;
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " <output_sequence> <conf_file>"
+      << std::endl;
+    return -1;
+  }
+
+  // loading configuration
+  std::cout << "Loading configuration parameters..." << std::endl;
+  BoostPropertyTree config;
+  config.loadXml(argv[2]);
+  const PropertyTree renderer(config, "camera/renderer");
+  const size_t width = renderer.getInt("width");
+  const size_t height = renderer.getInt("height");
+  const double fu = renderer.getDouble("fu");
+  const double fv = renderer.getDouble("fv");
+  const double u0 = renderer.getDouble("cu");
+  const double v0 = renderer.getDouble("cv");
+  const size_t numImages = renderer.getInt("numImages");
+  const timing::NsecTime framePeriod = renderer.getInt("framePeriod");
+  const double minDistance = renderer.getDouble("minDistance");
+  const double maxDistance = renderer.getDouble("maxDistance");
+  const double maxTilt = renderer.getDouble("maxTilt");
+  const double imageNoise = renderer.getDouble("imageNoise");
+  const size_t rows = config.getInt("camera/calibrator/rows");
+  const size_t cols = config.getInt("camera/calibrator/cols");
+  const double rowSpacing =
+    config.getDouble("camera/calibrator/rowSpacingMeters");
+  const double colSpacing =
+    config.getDouble("camera/calibrator/colSpacingMeters");
+  std::mt19937 generator(renderer.getInt("seed", 0));
+
+  // output either a raw sequence or a directory of images
+  const std::string output(argv[1]);
+  const bool raw = boost::filesystem::path(output).extension() == ".raw";
+  std::ofstream rawFile;
+  if (raw) {
+    rawFile.open(output, std::ios::binary);
+    ImageSequenceReader::writeRawHeader(rawFile, width, height);
+  }
+  else if (!boost::filesystem::exists(output))
+    boost::filesystem::create_directories(output);
+  std::ofstream posesFile(raw ? output + ".poses" :
+    (boost::filesystem::path(output) / "poses.txt").string());
+  posesFile << std::fixed << std::setprecision(18);
+
+  // the board has one square more than inner corners, and a white margin
+  const Eigen::Vector3d center(0.5 * (cols - 1) * colSpacing,
+    0.5 * (rows - 1) * rowSpacing, 0.0);
+  auto shade = [&](const Eigen::Vector3d& p) -> double {
+    const double x = p(0) / colSpacing + 1.0;
+    const double y = p(1) / rowSpacing + 1.0;
+    if (x < -1.0 || y < -1.0 || x >= cols + 2.0 || y >= rows + 2.0)
+      return 128.0;
+    if (x < 0.0 || y < 0.0 || x >= cols + 1.0 || y >= rows + 1.0)
+      return 255.0;
+    return ((static_cast<int>(x) + static_cast<int>(y)) % 2) ? 255.0 : 0.0;
+  };
+
+  std::cout << "Rendering images..." << std::endl;
+  std::uniform_real_distribution<double> tiltDist(-maxTilt, maxTilt);
+  std::uniform_real_distribution<double> distanceDist(minDistance,
+    maxDistance);
+  std::uniform_real_distribution<double> rollDist(-M_PI, M_PI);
+  std::normal_distribution<double> noiseDist(0.0,
+    std::max(imageNoise, 1e-12));
+  for (size_t i = 0; i < numImages; ++i) {
+    std::cout << std::fixed << std::setw(3)
+      << i / (double)numImages * 100 << " %" << '\r';
+
+    // camera looking at the board center from a random viewpoint
+    const Eigen::Matrix3d C_t_c = (Eigen::AngleAxisd(rollDist(generator),
+      Eigen::Vector3d::UnitZ()) * Eigen::AngleAxisd(tiltDist(generator),
+      Eigen::Vector3d::UnitY()) * Eigen::AngleAxisd(tiltDist(generator),
+      Eigen::Vector3d::UnitX())).toRotationMatrix();
+    const Eigen::Vector3d t_t_c = center - C_t_c *
+      Eigen::Vector3d(0.0, 0.0, distanceDist(generator));
+
+    // intersect the rays with the board plane, 2x2 supersampling
+    cv::Mat image(height, width, CV_8UC1);
+    for (size_t v = 0; v < height; ++v)
+      for (size_t u = 0; u < width; ++u) {
+        double intensity = 0.0;
+        for (size_t s = 0; s < 4; ++s) {
+          const Eigen::Vector3d ray = C_t_c * Eigen::Vector3d(
+            (u + 0.25 + 0.5 * (s % 2) - 0.5 - u0) / fu,
+            (v + 0.25 + 0.5 * (s / 2) - 0.5 - v0) / fv, 1.0);
+          const double scale = -t_t_c(2) / ray(2);
+          intensity += (scale > 0.0) ? shade(t_t_c + scale * ray) : 128.0;
+        }
+        intensity *= 0.25;
+        if (imageNoise > 0.0)
+          intensity += noiseDist(generator);
+        image.at<unsigned char>(v, u) = static_cast<unsigned char>(
+          std::min(std::max(std::round(intensity), 0.0), 255.0));
+      }
+
+    // write image and ground truth pose
+    const timing::NsecTime timestamp = (i + 1) * framePeriod;
+    if (raw)
+      ImageSequenceReader::writeRawFrame(rawFile, image, timestamp);
+    else {
+      std::stringstream stream;
+      stream << timestamp << ".png";
+      cv::imwrite((boost::filesystem::path(output) / stream.str()).string(),
+        image);
+    }
+    posesFile << timestamp;
+    for (size_t r = 0; r < 3; ++r)
+      posesFile << " " << C_t_c.row(r) << " " << t_t_c(r);
+    posesFile << std::endl;
+  }
+
+  std::cout << "ground truth projection: " << fu << " " << fv << " " << u0
+    << " " << v0 << std::endl;
+
+  return 0;
+}
@@ -17,7 +17,7 @@
  ******************************************************************************/
 
 /** \file validateCamera.cpp
-    \brief This file validates the camera intrinsics from a BAG file.
+    \brief This file validates the camera intrinsics from an image sequence.
   */
 
 #include <iostream>
@@ -27,27 +27,26 @@
 #include <sstream>
 
 #include <boost/filesystem.hpp>
-
-#include <rosbag/bag.h>
-#include <rosbag/view.h>
-#include <rosbag/message_instance.h>
-
-#include <sensor_msgs/Image.h>
-
-#include <cv_bridge/cv_bridge.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
 
 #include <opencv2/highgui/highgui.hpp>
 
+#include <aslam/cameras/GridCalibrationTargetCheckerboard.hpp>
+#include <aslam/cameras/GridCalibrationTargetObservation.hpp>
+
 #include <sm/BoostPropertyTree.hpp>
 
 #include "aslam/calibration/camera/CameraValidator.h"
+#include "aslam/calibration/camera/ImageSequenceReader.h"
+#include "aslam/calibration/camera/DetectionCache.h"
 
 using namespace aslam::calibration;
 using namespace sm;
 
 int main(int argc, char** argv) {
   if (argc != 4) {
-    std::cerr << "Usage: " << argv[0] << " <ros_bag_file> <conf_file> "
+    std::cerr << "Usage: " << argv[0] << " <image_sequence> <conf_file> "
       "<intrinsics_file>" << std::endl;
     return -1;
   }
@@ -69,38 +68,55 @@ int main(int argc, char** argv) {
   CameraValidator validator(PropertyTree(intrinsics, "intrinsics"),
     PropertyTree(config, "camera/calibrator"));
 
-  // load ros bag file
-  rosbag::Bag bag(argv[1]);
-  std::vector<std::string> topics;
-  const std::string rosTopic = config.getString("camera/rosTopic");
-  topics.push_back(rosTopic);
-  rosbag::View view(bag, rosbag::TopicQuery(topics));
-
-  // processing ros bag file
-  std::cout << "Processing BAG file..." << std::endl;
-  size_t viewCounter = 0;
-  for (auto it = view.begin(); it != view.end(); ++it) {
+  // open image sequence
+  ImageSequenceReader reader(argv[1], PropertyTree(config, "camera"));
+
+  // open detection cache, cached images are not decoded
+  boost::shared_ptr<DetectionCache> cache;
+  const std::string cacheFilename =
+    config.getString("camera/validator/detectionCache", "");
+  if (!cacheFilename.empty()) {
+    cache = boost::make_shared<DetectionCache>(cacheFilename,
+      validator.getCalibrationTarget(),
+      DetectionCache::hashOptions(validator.getOptions()));
+    reader.setDecodePredicate([&cache](uint64_t hash){
+      return !cache->contains(hash);});
+  }
+
+  // processing image sequence
+  std::cout << "Processing image sequence..." << std::endl;
+  ImageSequenceReader::Frame frame;
+  while (reader.read(frame)) {
     std::cout << std::fixed << std::setw(3)
-      << viewCounter++ / (double)view.size() * 100 << " %" << '\r';
-    if (it->getTopic() == rosTopic) {
-      sensor_msgs::ImagePtr image(it->instantiate<sensor_msgs::Image>());
-      auto cvImage = cv_bridge::toCvCopy(image);
-      validator.addImage(cvImage->image, image->header.stamp.toNSec());
-      if (config.getBool("camera/validator/visualization")) {
-        cv::Mat resultImage;
-        validator.getLastImage(resultImage);
-        if (resultImage.data != NULL) {
-          cv::imshow("Image Results", resultImage);
-          cv::waitKey(config.getInt("camera/imageTime"));
-        }
-        if (config.getBool("camera/validator/saveImages")) {
-          if (!boost::filesystem::exists("images"))
-            boost::filesystem::create_directory("images");
-          std::stringstream stream;
-          stream << "images/" << config.getString("camera/cameraId") << "-"
-            << image->header.stamp.toNSec() << ".png";
-          cv::imwrite(stream.str().c_str(), resultImage);
-        }
+      << reader.getNumImagesRead() / (double)reader.getNumImages() * 100
+      << " %" << '\r';
+    CameraValidator::ObservationPtr observation;
+    if (cache && cache->lookup(frame.hash, frame.timestamp, observation)) {
+      if (observation)
+        validator.addDetection(observation, frame.timestamp);
+      continue;
+    }
+    const size_t numObservations = validator.getObservations().size();
+    validator.addImage(frame.image, frame.timestamp);
+    if (cache)
+      cache->insert(frame.hash, validator.getObservations().size() !=
+        numObservations ? validator.getLastObservation() :
+        CameraValidator::ObservationPtr());
+    if (config.getBool("camera/validator/visualization")) {
+      cv::Mat resultImage;
+      validator.getLastImage(resultImage);
+      if (resultImage.data != NULL) {
+        cv::imshow("Image Results", resultImage);
+        cv::waitKey(config.getInt("camera/imageTime"));
+      }
+      if (config.getBool("camera/validator/saveImages") &&
+          resultImage.data != NULL) {
+        if (!boost::filesystem::exists("images"))
+          boost::filesystem::create_directory("images");
+        std::stringstream stream;
+        stream << "images/" << config.getString("camera/cameraId") << "-"
+          << frame.timestamp << ".png";
+        cv::imwrite(stream.str().c_str(), resultImage);
       }
     }
   }
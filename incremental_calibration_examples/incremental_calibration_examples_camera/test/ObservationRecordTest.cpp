@@ -0,0 +1,65 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file ObservationRecordTest.cpp
+    \brief This file tests the ObservationRecord structure.
+  */
+
+#include <gtest/gtest.h>
+
+#include <boost/make_shared.hpp>
+
+#include <sm/timing/NsecTimeUtilities.hpp>
+
+#include <aslam/Time.hpp>
+
+#include <aslam/cameras/GridCalibrationTargetCheckerboard.hpp>
+#include <aslam/cameras/GridCalibrationTargetObservation.hpp>
+
+#include "aslam/calibration/camera/ObservationRecord.h"
+
+using namespace aslam::calibration;
+
+TEST(AslamCalibrationTestSuite, testObservationRecord) {
+  auto target = boost::make_shared<
+    aslam::cameras::GridCalibrationTargetCheckerboard>(6, 7, 0.03, 0.03);
+  ObservationRecord::Observation observation(target);
+  for (size_t i = 0; i < target->size(); i += 2)
+    observation.updateImagePoint(i, Eigen::Vector2d(10.0 * i, 5.0 * i + 1));
+
+  // an epoch timestamp does not survive the conversion to seconds
+  const sm::timing::NsecTime timestamp = 1400000000123456789LL;
+  observation.setTime(aslam::Time(sm::timing::nsecToSec(timestamp)));
+  const ObservationRecord record(observation, target->size(), timestamp);
+  ASSERT_EQ(timestamp, record.timestamp);
+  ASSERT_EQ(target->size(), record.getNumCorners());
+  for (size_t i = 0; i < target->size(); ++i) {
+    Eigen::Vector2d point;
+    ASSERT_EQ(i % 2 == 0, record.imagePoint(i, point));
+    if (i % 2 == 0)
+      ASSERT_EQ(Eigen::Vector2d(10.0 * i, 5.0 * i + 1), point);
+  }
+
+  // the timestamp is carried along a rebuilt observation
+  const ObservationRecord::ObservationPtr rebuilt =
+    record.toObservation(target);
+  const ObservationRecord copy(*rebuilt, target->size(), record.timestamp);
+  ASSERT_EQ(timestamp, copy.timestamp);
+  ASSERT_EQ(record.valid, copy.valid);
+  ASSERT_EQ(record.points, copy.points);
+}
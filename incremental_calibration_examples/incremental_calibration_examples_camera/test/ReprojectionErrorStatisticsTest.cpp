@@ -0,0 +1,65 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file ReprojectionErrorStatisticsTest.cpp
+    \brief This file tests the ReprojectionErrorStatistics class.
+  */
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Core>
+
+#include "aslam/calibration/camera/ReprojectionErrorStatistics.h"
+
+using namespace aslam::calibration;
+
+namespace {
+
+  /// Adds a deterministic pseudo-random error for an item
+  void addItemError(size_t i, ReprojectionErrorStatistics& statistics) {
+    const Eigen::Vector2d error(std::sin(0.37 * i) * 1e3 + 1e-3 * i,
+      std::cos(1.91 * i) * 0.1 + 1e5);
+    statistics.addError(error, error.squaredNorm());
+  }
+
+}
+
+TEST(AslamCalibrationTestSuite, testReprojectionErrorStatistics) {
+  // the reduction is bitwise reproducible whatever the number of threads
+  const size_t numItems = 10007;
+  const ReprojectionErrorStatistics serial =
+    ReprojectionErrorStatistics::reduce(numItems, addItemError, 0.0, true, 1,
+    64);
+  ASSERT_EQ(numItems, serial.getNumErrors());
+  for (size_t numThreads = 2; numThreads <= 7; ++numThreads) {
+    const ReprojectionErrorStatistics parallel =
+      ReprojectionErrorStatistics::reduce(numItems, addItemError, 0.0, true,
+      numThreads, 64);
+    ASSERT_EQ(serial.getNumErrors(), parallel.getNumErrors());
+    ASSERT_EQ(serial.getMean(), parallel.getMean());
+    ASSERT_EQ(serial.getCovariance(), parallel.getCovariance());
+    ASSERT_EQ(serial.getMahalanobisDistances(),
+      parallel.getMahalanobisDistances());
+  }
+
+  // an empty reduction is valid
+  ASSERT_EQ(0u, ReprojectionErrorStatistics::reduce(0, addItemError)
+    .getNumErrors());
+}
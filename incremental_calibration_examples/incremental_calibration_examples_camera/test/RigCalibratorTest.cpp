@@ -0,0 +1,135 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file RigCalibratorTest.cpp
+    \brief This file tests the RigCalibrator class.
+  */
+
+#include <cmath>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <boost/make_shared.hpp>
+#include <boost/pointer_cast.hpp>
+
+#include <Eigen/Core>
+
+#include <sm/kinematics/Transformation.hpp>
+#include <sm/kinematics/rotations.hpp>
+#include <sm/kinematics/homogeneous_coordinates.hpp>
+
+#include <aslam/cameras.hpp>
+#include <aslam/cameras/GridCalibrationTargetObservation.hpp>
+
+#include <aslam/calibration/core/IncrementalEstimator.h>
+
+#include "aslam/calibration/camera/RigCalibrator.h"
+
+using namespace aslam::calibration;
+
+namespace {
+
+  /// Rig calibrator fed with simulated detections
+  class SimulatedRigCalibrator :
+    public RigCalibrator {
+  public:
+    /// Constructs the rig with known intrinsics for all the cameras
+    SimulatedRigCalibrator(const IncrementalEstimatorPtr& estimator,
+        const Options& options) :
+        RigCalibrator(estimator, options) {
+      for (auto it = _cameras.begin(); it != _cameras.end(); ++it) {
+        *boost::dynamic_pointer_cast<
+          aslam::cameras::DistortedPinholeCameraGeometry>(it->geometry) =
+          aslam::cameras::DistortedPinholeCameraGeometry(
+          aslam::cameras::PinholeProjection<
+          aslam::cameras::RadialTangentialDistortion>(400.0, 400.0, 320.0,
+          240.0, 640, 480, aslam::cameras::RadialTangentialDistortion(-0.2,
+          0.05, 1e-3, -1e-3)));
+        it->geometryInitialized = true;
+      }
+    }
+    /// Simulates the detection of the target by a camera
+    ObservationPtr observe(size_t camera, const sm::kinematics::Transformation&
+        T_t_c, const sm::kinematics::Transformation& T_t_c_guess) const {
+      auto observation = boost::make_shared<Observation>(_calibrationTarget);
+      const Eigen::Matrix4d T_c_t = T_t_c.inverse().T();
+      for (size_t i = 0; i < _calibrationTarget->size(); ++i) {
+        Eigen::VectorXd keypoint;
+        if (_cameras[camera].geometry->vsHomogeneousToKeypoint(T_c_t *
+            sm::kinematics::toHomogeneous(_calibrationTarget->point(i)),
+            keypoint))
+          observation->updateImagePoint(i, Eigen::Vector2d(keypoint));
+      }
+      observation->set_T_t_c(T_t_c_guess);
+      return observation;
+    }
+    using RigCalibrator::addFrame;
+    using RigCalibrator::getCalibrationOffset;
+  };
+
+}
+
+TEST(AslamCalibrationTestSuite, testRigCalibrator) {
+  RigCalibrator::Options options;
+  options.numCameras = 2;
+  SimulatedRigCalibrator calibrator(boost::make_shared<IncrementalEstimator>(
+    options.camera.calibrationGroupId), options);
+
+  // the second camera is shifted along x and slightly rotated
+  const sm::kinematics::Transformation T_r_c1(
+    sm::kinematics::axisAngle2quat(Eigen::Vector3d(0.01, 0.05, -0.02)),
+    Eigen::Vector3d(0.08, 0.005, -0.01));
+  const sm::kinematics::Transformation T_c1_guess(
+    sm::kinematics::axisAngle2quat(Eigen::Vector3d(0.01, -0.005, 0.008)),
+    Eigen::Vector3d(0.01, -0.005, 0.008));
+
+  // the rig moves in front of the target, both cameras see it in every frame
+  for (size_t k = 0; k < 10; ++k) {
+    const sm::kinematics::Transformation T_t_r(
+      sm::kinematics::axisAngle2quat(Eigen::Vector3d(0.15 * std::sin(k),
+      0.15 * std::cos(k), 0.05 * k)), Eigen::Vector3d(0.15 + 0.03 *
+      std::sin(2.0 * k), 0.15 + 0.03 * std::cos(3.0 * k), -0.6 + 0.02 * k));
+    std::vector<RigCalibrator::ObservationPtr> observations(2);
+    observations[0] = calibrator.observe(0, T_t_r, T_t_r);
+    observations[1] = calibrator.observe(1, T_t_r * T_r_c1,
+      T_t_r * T_r_c1 * T_c1_guess);
+    calibrator.addFrame(observations, k);
+
+    // the frame completing the initialization is the first batch
+    if (!k) {
+      ASSERT_TRUE(calibrator.isInitialized());
+      ASSERT_EQ(1u, calibrator.getEstimatorTimestamps().size());
+    }
+  }
+
+  // the reference camera extrinsics are not estimated
+  const auto& geometry = calibrator.getCamera(0).geometry;
+  ASSERT_EQ(0u, calibrator.getCalibrationOffset(0));
+  ASSERT_EQ(static_cast<size_t>(geometry->minimalDimensionsProjection() +
+    geometry->minimalDimensionsDistortion()),
+    calibrator.getCalibrationOffset(1));
+  ASSERT_EQ(0, calibrator.getExtrinsicsStandardDeviation(0).size());
+  ASSERT_EQ(6, calibrator.getExtrinsicsStandardDeviation(1).size());
+
+  // the known extrinsics are recovered from the perturbed initialization
+  ASSERT_TRUE(calibrator.getExtrinsics(0).isApprox(Eigen::Matrix4d::Identity(),
+    1e-12));
+  ASSERT_LT((calibrator.getExtrinsics(1) - T_r_c1.T()).norm(), 1e-4);
+}
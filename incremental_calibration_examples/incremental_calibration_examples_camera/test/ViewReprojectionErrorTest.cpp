@@ -0,0 +1,193 @@
+/******************************************************************************
+ * Copyright (C) 2013 by Jerome Maye                                          *
+ * jerome.maye@gmail.com                                                      *
+ *                                                                            *
+ * This program is free software; you can redistribute it and/or modify       *
+ * it under the terms of the Lesser GNU General Public License as published by*
+ * the Free Software Foundation; either version 3 of the License, or          *
+ * (at your option) any later version.                                        *
+ *                                                                            *
+ * This program is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ * Lesser GNU General Public License for more details.                        *
+ *                                                                            *
+ * You should have received a copy of the Lesser GNU General Public License   *
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.       *
+ ******************************************************************************/
+
+/** \file ViewReprojectionErrorTest.cpp
+    \brief This file tests the ViewReprojectionError class.
+  */
+
+#include <cmath>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <boost/make_shared.hpp>
+
+#include <Eigen/Core>
+
+#include <sm/kinematics/rotations.hpp>
+#include <sm/kinematics/homogeneous_coordinates.hpp>
+
+#include <aslam/cameras.hpp>
+
+#include <aslam/backend/RotationQuaternion.hpp>
+#include <aslam/backend/EuclideanPoint.hpp>
+#include <aslam/backend/HomogeneousPoint.hpp>
+#include <aslam/backend/RotationExpression.hpp>
+#include <aslam/backend/EuclideanExpression.hpp>
+#include <aslam/backend/TransformationExpression.hpp>
+#include <aslam/backend/JacobianContainer.hpp>
+#include <aslam/backend/MEstimatorPolicies.hpp>
+
+#include <aslam/ReprojectionError.hpp>
+#include <aslam/CameraGeometryDesignVariableContainer.hpp>
+
+#include "aslam/calibration/camera/ViewReprojectionError.h"
+
+using namespace aslam::calibration;
+
+namespace {
+
+  /// Gradient blocks per design variable
+  typedef std::map<aslam::backend::DesignVariable*, Eigen::VectorXd> Gradient;
+  /// Hessian blocks per pair of design variables
+  typedef std::map<std::pair<aslam::backend::DesignVariable*,
+    aslam::backend::DesignVariable*>, Eigen::MatrixXd> Hessian;
+
+  /// Adds the normal equations of an error term, returns its cost
+  double accumulate(aslam::backend::ErrorTerm& errorTerm, Hessian& H,
+      Gradient& b) {
+    errorTerm.evaluateError();
+    aslam::backend::JacobianContainer J(errorTerm.dimension());
+    errorTerm.getWeightedJacobians(J, true);
+    Eigen::VectorXd e;
+    errorTerm.getWeightedError(e, true);
+    for (auto it = J.begin(); it != J.end(); ++it) {
+      const Eigen::VectorXd b_i = it->second.transpose() * e;
+      if (b.count(it->first))
+        b[it->first] += b_i;
+      else
+        b[it->first] = b_i;
+      for (auto jt = J.begin(); jt != J.end(); ++jt) {
+        const auto key = std::make_pair(it->first, jt->first);
+        const Eigen::MatrixXd H_ij = it->second.transpose() * jt->second;
+        if (H.count(key))
+          H[key] += H_ij;
+        else
+          H[key] = H_ij;
+      }
+    }
+    return errorTerm.getWeightedSquaredError();
+  }
+
+  /// Checks that the blocks of first are in second, missing blocks are zero
+  template <typename M>
+  void checkBlocks(const M& first, const M& second) {
+    for (auto it = first.cbegin(); it != first.cend(); ++it) {
+      const auto jt = second.find(it->first);
+      const double difference = jt == second.cend() ? it->second.norm() :
+        (it->second - jt->second).norm();
+      ASSERT_LE(difference, 1e-9 * (1.0 + it->second.norm()));
+    }
+  }
+
+  /// Checks a view error term against per-point reprojection errors
+  void checkEquivalence(bool useMEstimator) {
+    // camera and target
+    auto geometry =
+      boost::make_shared<aslam::cameras::DistortedPinholeCameraGeometry>(
+      aslam::cameras::PinholeProjection<
+      aslam::cameras::RadialTangentialDistortion>(400.0, 410.0, 320.0, 240.0,
+      640, 480, aslam::cameras::RadialTangentialDistortion(-0.2, 0.05, 1e-3,
+      -1e-3)));
+    aslam::CameraGeometryDesignVariableContainer camera(geometry, true, true,
+      false);
+    std::vector<boost::shared_ptr<aslam::backend::HomogeneousPoint> >
+      landmarks;
+    for (size_t r = 0; r < 6; ++r)
+      for (size_t c = 0; c < 7; ++c) {
+        landmarks.push_back(
+          boost::make_shared<aslam::backend::HomogeneousPoint>(
+          sm::kinematics::toHomogeneous(Eigen::Vector3d(0.05 * c, 0.05 * r,
+          0.0))));
+        landmarks.back()->setActive(true);
+      }
+
+    // target to camera transformation
+    auto q_dv = boost::make_shared<aslam::backend::RotationQuaternion>(
+      sm::kinematics::axisAngle2quat(Eigen::Vector3d(0.1, -0.05, 0.02)));
+    q_dv->setActive(true);
+    auto t_dv = boost::make_shared<aslam::backend::EuclideanPoint>(
+      Eigen::Vector3d(-0.15, -0.12, 0.6));
+    t_dv->setActive(true);
+    const aslam::backend::TransformationExpression T_c_t_e(
+      aslam::backend::RotationExpression(q_dv),
+      aslam::backend::EuclideanExpression(t_dv));
+
+    // the Jacobian containers order the design variables by block index
+    aslam::backend::DesignVariable::set_t dvs;
+    camera.getDesignVariables(dvs);
+    int blockIndex = 0;
+    for (auto it = dvs.begin(); it != dvs.end(); ++it)
+      (*it)->setBlockIndex(blockIndex++);
+    q_dv->setBlockIndex(blockIndex++);
+    t_dv->setBlockIndex(blockIndex++);
+    for (auto it = landmarks.begin(); it != landmarks.end(); ++it)
+      (*it)->setBlockIndex(blockIndex++);
+
+    // noisy observations with a few outliers
+    const Eigen::Matrix4d T_c_t = T_c_t_e.toTransformationMatrix();
+    Eigen::Matrix2Xd y(2, landmarks.size());
+    std::vector<aslam::backend::HomogeneousExpression> points;
+    for (size_t i = 0; i < landmarks.size(); ++i) {
+      Eigen::VectorXd keypoint;
+      geometry->vsHomogeneousToKeypoint(T_c_t *
+        landmarks[i]->toHomogeneous(), keypoint);
+      y.col(i) = keypoint + Eigen::Vector2d(std::sin(1.3 * i),
+        std::cos(0.7 * i)) * (i % 11 ? 0.5 : 20.0);
+      points.push_back(landmarks[i]->toExpression());
+    }
+    const double invR = 4.0;
+
+    // per-point reprojection errors
+    Hessian H_p;
+    Gradient b_p;
+    double cost_p = 0.0;
+    for (size_t i = 0; i < landmarks.size(); ++i) {
+      aslam::ReprojectionError errorTerm(Eigen::Vector2d(y.col(i)),
+        invR * Eigen::Matrix2d::Identity(), T_c_t_e * points[i], &camera);
+      if (useMEstimator)
+        errorTerm.setMEstimatorPolicy(
+          boost::make_shared<aslam::backend::BlakeZissermanMEstimator>(2));
+      cost_p += accumulate(errorTerm, H_p, b_p);
+    }
+
+    // view reprojection error
+    Hessian H_v;
+    Gradient b_v;
+    ViewReprojectionError errorTerm(y, invR, T_c_t_e, points, geometry,
+      &camera, useMEstimator ?
+      boost::make_shared<aslam::backend::BlakeZissermanMEstimator>(2) :
+      ViewReprojectionError::MEstimatorPtr());
+    const double cost_v = accumulate(errorTerm, H_v, b_v);
+
+    ASSERT_NEAR(cost_p, cost_v, 1e-9 * cost_p);
+    checkBlocks(b_p, b_v);
+    checkBlocks(b_v, b_p);
+    checkBlocks(H_p, H_v);
+    checkBlocks(H_v, H_p);
+  }
+
+}
+
+TEST(AslamCalibrationTestSuite, testViewReprojectionError) {
+  checkEquivalence(false);
+  checkEquivalence(true);
+}
@@ -116,17 +116,22 @@ namespace aslam {
         auto trajDist = NormalDistribution<3>(
           Eigen::Matrix<double, 3, 1>::Zero(),
           Eigen::Matrix<double, 3, 3>::Identity() * 2);
-        for (double t = lastTimestamp + dt; t < T; t += dt) {
+        size_t numSteps = 0;
+        for (double t = lastTimestamp + dt; t < T; t += dt)
+          numSteps++;
+        Eigen::Matrix<double, Eigen::Dynamic, 3> v_v_wvNoise, v_om_wvNoise;
+        trajDist.getSamples(v_v_wvNoise, numSteps);
+        trajDist.getSamples(v_om_wvNoise, numSteps);
+        size_t k = 0;
+        for (double t = lastTimestamp + dt; t < T; t += dt, ++k) {
           Eigen::Vector2d v_v_om_wv_k = genSineBodyVel2d(w_phi_v_km1,
             w_r_wv_km1, t, dt, A, f);
-          auto sample = trajDist.getSample();
           Eigen::Vector3d v_v_wv_k(v_v_om_wv_k(0), v_v_om_wv_k(0),
             v_v_om_wv_k(0));
-          v_v_wv_k = v_v_wv_k + sample;
-          sample = trajDist.getSample();
+          v_v_wv_k = v_v_wv_k + v_v_wvNoise.row(k).transpose();
           Eigen::Vector3d v_om_wv_k(v_v_om_wv_k(1), v_v_om_wv_k(1),
             v_v_om_wv_k(1));
-          v_om_wv_k = v_om_wv_k + sample;
+          v_om_wv_k = v_om_wv_k + v_om_wvNoise.row(k).transpose();
           const auto w_T_v_t = integrateMotionModel(
             Transformation(rotPoses.back(), transPoses.back()), v_v_wv_k,
             v_om_wv_k, dt);
@@ -147,12 +152,21 @@ namespace aslam {
           w_phi_v_km1 = std::atan(2 * M_PI * f * A * cos(2 * M_PI * f * dt));
         Eigen::Vector2d w_r_wv_km1 = Eigen::Vector2d::Zero();
 
-        auto trajDist = NormalDistribution<3>(
-          Eigen::Matrix<double, 3, 1>::Zero(),
-          Eigen::Matrix<double, 3, 3>::Identity() * 2);
+        Eigen::Matrix<double, Eigen::Dynamic, 3> v_v_wvNoise, v_om_wvNoise;
+        if (type == "random") {
+          auto trajDist = NormalDistribution<3>(
+            Eigen::Matrix<double, 3, 1>::Zero(),
+            Eigen::Matrix<double, 3, 3>::Identity() * 2);
+          size_t numSteps = 0;
+          for (double t = dt; t < T; t += dt)
+            numSteps++;
+          trajDist.getSamples(v_v_wvNoise, numSteps);
+          trajDist.getSamples(v_om_wvNoise, numSteps);
+        }
 
         // generate trajectory
-        for (double t = dt; t < T; t += dt) {
+        size_t k = 0;
+        for (double t = dt; t < T; t += dt, ++k) {
           Eigen::Vector2d v_v_om_wv_k;
           if (type == "straight")
             v_v_om_wv_k =
@@ -163,14 +177,12 @@ namespace aslam {
           Eigen::Vector3d v_v_wv_k;
           Eigen::Vector3d v_om_wv_k;
           if (type == "random") {
-            auto sample = trajDist.getSample();
             v_v_wv_k = Eigen::Vector3d(v_v_om_wv_k(0), v_v_om_wv_k(0),
               v_v_om_wv_k(0));
-            v_v_wv_k = v_v_wv_k + sample;
-            sample = trajDist.getSample();
+            v_v_wv_k = v_v_wv_k + v_v_wvNoise.row(k).transpose();
             v_om_wv_k = Eigen::Vector3d(v_v_om_wv_k(1), v_v_om_wv_k(1),
               v_v_om_wv_k(1));
-            v_om_wv_k = v_om_wv_k + sample;
+            v_om_wv_k = v_om_wv_k + v_om_wvNoise.row(k).transpose();
           }
           else {
             v_v_wv_k = Eigen::Vector3d(v_v_om_wv_k(0), 0.0, 0.0);
@@ -225,13 +237,17 @@ namespace aslam {
       auto prevTransformation = Transformation();
       const auto referenceSensor = params.referenceSensor;
       bool firstTime = true;
-      std::unordered_map<size_t, NormalDistribution<6> > normDists;
+      const auto minTime = data.trajectory.translationSpline->getMinTime();
+      const auto maxTime = data.trajectory.translationSpline->getMaxTime();
+      const size_t numSteps = maxTime >= minTime ?
+        (maxTime - minTime) / secToNsec(dt) + 1 : 0;
+      std::unordered_map<size_t, Eigen::Matrix<double, Eigen::Dynamic, 6> >
+        noise;
       for (const auto& cov : params.sigma2)
-        normDists[cov.first] = NormalDistribution<6>(
-          Eigen::Matrix<double, 6, 1>::Zero(), cov.second);
-      for (auto t = data.trajectory.translationSpline->getMinTime();
-          t <= data.trajectory.translationSpline->getMaxTime();
-          t += secToNsec(dt)) {
+        NormalDistribution<6>(Eigen::Matrix<double, 6, 1>::Zero(),
+          cov.second).getSamples(noise[cov.first], numSteps);
+      size_t k = 0;
+      for (auto t = minTime; t <= maxTime; t += secToNsec(dt), ++k) {
         auto translationEvaluator =
           data.trajectory.translationSpline->getEvaluatorAt<0>(t);
         auto rotationEvaluator =
@@ -247,7 +263,8 @@ namespace aslam {
               motion.duration = secToNsec(dt);
               motion.sigma2 = cov.second;
               data.motionData[cov.first].push_back(std::make_pair(t, motion));
-              auto normSample = normDists[cov.first].getSample();
+              const Eigen::Matrix<double, 6, 1> normSample =
+                noise[cov.first].row(k).transpose();
               motion.motion = w_T_s * Transformation(qexp(normSample.tail<3>()),
                 normSample.head<3>());
               data.motionDataNoisy[cov.first].push_back(std::make_pair(t,
@@ -264,7 +281,8 @@ namespace aslam {
               motion.sigma2 = cov.second;
               data.motionData[cov.first].push_back(std::make_pair(t + timeDelay,
                 motion));
-              auto normSample = normDists[cov.first].getSample();
+              const Eigen::Matrix<double, 6, 1> normSample =
+                noise[cov.first].row(k).transpose();
               motion.motion = w_T_s * Transformation(qexp(normSample.tail<3>()),
                 normSample.head<3>());
               data.motionDataNoisy[cov.first].push_back(std::make_pair(t +
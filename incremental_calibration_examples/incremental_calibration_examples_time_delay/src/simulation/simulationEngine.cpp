@@ -56,7 +56,22 @@ namespace aslam {
       double w_phi_v_km1 = std::atan(2 * M_PI * f * A * cos(2 * M_PI * f * dt));
       Eigen::Vector2d w_r_wv_km1 = Eigen::Vector2d::Zero();
       NsecTime timestamp = 0;
-      for (double t = dt; t < T; t += dt) {
+
+      // sensor noise, the covariances are factorized only once
+      size_t numSteps = 0;
+      for (double t = dt; t < T; t += dt)
+        numSteps++;
+      Eigen::VectorXd lwNoise, rwNoise;
+      NormalDistribution<1>(0, params.sigma2_l).getSamples(lwNoise, numSteps);
+      NormalDistribution<1>(0, params.sigma2_r).getSamples(rwNoise, numSteps);
+      Eigen::Matrix<double, Eigen::Dynamic, 3> w_r_wpNoise, w_R_pNoise;
+      NormalDistribution<3>(Eigen::Vector3d::Zero(),
+        params.sigma2_w_r_wp).getSamples(w_r_wpNoise, numSteps);
+      NormalDistribution<3>(Eigen::Vector3d::Zero(),
+        params.sigma2_w_R_p).getSamples(w_R_pNoise, numSteps);
+
+      size_t k = 0;
+      for (double t = dt; t < T; t += dt, ++k) {
         // trajectory
         const Eigen::Vector2d v_v_om_wv_k = genSineBodyVel2d(w_phi_v_km1,
           w_r_wv_km1, t, dt, A, f);
@@ -78,8 +93,7 @@ namespace aslam {
         data.lwData.push_back(std::make_pair(timestamp + secToNsec(params.t_l),
           lw));
 
-        const NormalDistribution<1> lwDist(0, params.sigma2_l);
-        lw.value = params.k_l * (data.w_v_wwl.back()(0) + lwDist.getSample());
+        lw.value = params.k_l * (data.w_v_wwl.back()(0) + lwNoise(k));
         data.lwData_n.push_back(std::make_pair(timestamp +
           secToNsec(params.t_l), lw));
 
@@ -88,8 +102,7 @@ namespace aslam {
         data.rwData.push_back(std::make_pair(timestamp + secToNsec(params.t_r),
           rw));
 
-        const NormalDistribution<1> rwDist(0, params.sigma2_r);
-        rw.value = params.k_r * (data.w_v_wwr.back()(0) + rwDist.getSample());
+        rw.value = params.k_r * (data.w_v_wwr.back()(0) + rwNoise(k));
         data.rwData_n.push_back(std::make_pair(timestamp +
           secToNsec(params.t_r), rw));
 
@@ -105,12 +118,8 @@ namespace aslam {
         data.poseData.push_back(std::make_pair(timestamp + secToNsec(dt * 0.5),
           pose));
 
-        const NormalDistribution<3> w_r_wpDist(Eigen::Vector3d::Zero(),
-          pose.sigma2_w_r_wp);
-        pose.w_r_wp = pose.w_r_wp + w_r_wpDist.getSample();
-        const NormalDistribution<3>
-          w_R_pDist(Eigen::Vector3d::Zero(), pose.sigma2_w_R_p);
-        pose.w_R_p = pose.w_R_p + w_R_pDist.getSample();
+        pose.w_r_wp = pose.w_r_wp + w_r_wpNoise.row(k).transpose();
+        pose.w_R_p = pose.w_R_p + w_R_pNoise.row(k).transpose();
         data.poseData_n.push_back(std::make_pair(timestamp +
           secToNsec(dt * 0.5), pose));
 
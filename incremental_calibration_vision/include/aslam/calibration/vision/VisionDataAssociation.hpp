@@ -12,6 +12,12 @@
 #include <sm/PropertyTree.hpp>
 #include <aslam/calibration/core/OptimizationProblem.h>
 #include <aslam/splines/BSplinePoseDesignVariable.hpp>
+#include <aslam/CameraGeometryDesignVariableContainer.hpp>
+#include <aslam/backend/RotationQuaternion.hpp>
+#include <aslam/backend/EuclideanPoint.hpp>
+#include <aslam/backend/HomogeneousPoint.hpp>
+#include <boost/function.hpp>
+#include <set>
 
 
 namespace aslam {
@@ -34,25 +40,99 @@ namespace aslam {
                           const cv::Mat & image);
                         
             /// \brief Add the contents of the internal state to the optimization problem
-            ///        using the bspline pose representation passed in.
+            ///        using the bspline pose representation passed in. Tracks already
+            ///        added since the last reset() keep their landmark, only their new
+            ///        keypoints are added. Nothing is added if the batch is rejected.
             void addToProblem( aslam::splines::BSplinePoseDesignVariable & T_w_vk, OptimizationProblemSP problem );
 
             /// \brief reset the internal state (do this in between batches)
             void reset();
 
             /// \brief how many calibration design variables does this class have?
+            ///        They are created with the first multiframe.
             size_t numCalibrationDesignVariables();
             
             /// \brief get calibration design variable i
             boost::shared_ptr< DesignVariable > getCalibrationDesignVariable( size_t i );
+
+            /// \brief how many keyframes are stored?
+            size_t numKeyframes() const;
+
+            /// \brief how many matches are stored?
+            size_t numMatches() const;
+
+            /// \brief estimated memory used by the keyframes and matches [byte]
+            size_t getMemoryUsage() const;
+
+            /// \brief peak estimated memory used by the keyframes and matches [byte]
+            size_t getPeakMemoryUsage() const;
             
             
         private:
+            /// \brief keyframe eviction policy when the store is full
+            enum EvictionPolicy {
+                /// \brief evict the oldest keyframe
+                EVICT_OLDEST,
+                /// \brief evict the keyframe referenced by the fewest matches
+                EVICT_LEAST_REFERENCED
+            };
+
+            /// \brief store a keyframe and evict keyframes above capacity
+            void storeKeyframe( const boost::shared_ptr<MultiFrame> & mf );
+
+            /// \brief remove the matches referencing evicted keyframes
+            void compactMatches( const std::set<MultiFrameId> & evicted );
+
+            /// \brief estimated memory used by a multiframe [byte]
+            size_t computeMemoryUsage( const MultiFrame & mf ) const;
+
+            /// \brief update the peak memory usage
+            void updateMemoryUsage();
+
+            /// \brief create the calibration design variables of the camera system
+            void createDesignVariables( NCameraSystem & system, bool doIntrinsics, bool doExtrinsics );
+
+            /// \brief transformation from camera i to the vehicle at the current estimate
+            sm::kinematics::Transformation T_v_c( size_t i ) const;
+
+            /// \brief link the pairwise matches into multi-view tracks
+            void buildTracks( std::vector< std::vector< KeypointIdentifier > > & tracks ) const;
+
+            /// \brief triangulate all the tracks in the world frame in one pass
+            void triangulateTracks( aslam::splines::BSplinePoseDesignVariable & T_w_vk,
+                                    const std::vector< std::vector< KeypointIdentifier > > & tracks,
+                                    Eigen::Matrix4Xd & points,
+                                    std::vector<bool> & valid );
+
+            /// \brief keep a downsampled copy of the last image of a camera
+            void updateThumbnail( int cameraIndex, const cv::Mat & image );
+
+            /// \brief cheap check of the motion since the previous keyframe
+            ///        before running the full tracking
+            bool isKeyframeCandidate() const;
+
             double computeDisparity( const boost::shared_ptr<MultiFrame> & F0,
                                      const boost::shared_ptr<MultiFrame> & F1,
                                      const KeypointIdentifierMatch & match);
 
             void doOfovMatching( boost::shared_ptr<MultiFrame> mf );
+
+            /// \brief create one matching problem per camera and per camera pair
+            void initMatchingProblems( size_t numCameras );
+
+            /// \brief track the keypoints of camera i between two multiframes
+            void trackCamera( size_t i,
+                              const boost::shared_ptr<MultiFrame> & F0,
+                              const boost::shared_ptr<MultiFrame> & F1,
+                              std::vector< std::vector< KeypointIdentifierMatch > > & matches );
+
+            /// \brief match the overlapping fields of view of camera pair k
+            void matchCameraPair( size_t k,
+                                  const boost::shared_ptr<MultiFrame> & mf,
+                                  std::vector< std::vector< KeypointIdentifierMatch > > & matches );
+
+            /// \brief run tasks 0..numTasks-1 on the worker threads
+            void runTasks( size_t numTasks, const boost::function<void (size_t)> & task );
                                    
             
             /// \brief The pipeline for synchronising images and getting features
@@ -64,17 +144,79 @@ namespace aslam {
             /// \brief The next available landmark id
             LandmarkId _nextLandmarkId;
 
+            /// \brief landmarks added to the problem since the last reset
+            std::map< LandmarkId, boost::shared_ptr<aslam::backend::HomogeneousPoint> > _landmarks;
+
             /// \brief the previous frame used.
             boost::shared_ptr<MultiFrame> _previousFrame;
 
             std::map< MultiFrameId, boost::shared_ptr<MultiFrame> > _frames;
             std::vector< KeypointIdentifierMatch > _matches;
-            aslam::DenseMatcher _matcher;
-            aslam::DescriptorTrackingAlgorithm _tracking;
-            aslam::EpipolarMatchingAlgorithm _ofovMatching;
+
+            /// \brief configuration of the frame to frame tracking
+            sm::PropertyTree _trackingConfig;
+            /// \brief configuration of the overlapping field of view matching
+            sm::PropertyTree _ofovMatchingConfig;
+            /// \brief number of worker threads (0: hardware concurrency)
+            size_t _numThreads;
+
+            /// \brief frame to frame tracking, one per camera
+            std::vector< boost::shared_ptr<aslam::DescriptorTrackingAlgorithm> > _tracking;
+            std::vector< boost::shared_ptr<aslam::DenseMatcher> > _trackingMatchers;
+            /// \brief overlapping field of view matching, one per camera pair
+            std::vector< boost::shared_ptr<aslam::EpipolarMatchingAlgorithm> > _ofovMatching;
+            std::vector< boost::shared_ptr<aslam::DenseMatcher> > _ofovMatchers;
+            std::vector< std::pair<size_t, size_t> > _cameraPairs;
+
             double _disparityKeyframeThreshold;
             int _numTracksThreshold;
 
+            /// \brief number of pyramid levels of the keyframe pre-check images
+            int _preCheckLevels;
+            /// \brief fraction of the disparity threshold the pre-check shift
+            ///        must reach to run the tracking (0: no pre-check, the default)
+            double _preCheckRatio;
+            /// \brief downsampled last image of each camera
+            std::vector< cv::Mat > _thumbnails;
+            /// \brief downsampled images of each camera at the previous frame
+            std::vector< cv::Mat > _keyframeThumbnails;
+
+            /// \brief maximum number of keyframes (0: unbounded)
+            size_t _maxKeyframes;
+            /// \brief keyframe eviction policy
+            EvictionPolicy _evictionPolicy;
+            /// \brief estimated memory used by each keyframe [byte]
+            std::map< MultiFrameId, size_t > _frameMemoryUsage;
+            /// \brief estimated memory used by the keyframes [byte]
+            size_t _framesMemoryUsage;
+            /// \brief peak estimated memory used by the keyframes and matches [byte]
+            size_t _peakMemoryUsage;
+
+            /// \brief intrinsics of each camera
+            std::vector< boost::shared_ptr<aslam::CameraGeometryDesignVariableContainer> > _intrinsics;
+            /// \brief rotation from each camera to the vehicle
+            std::vector< boost::shared_ptr<aslam::backend::RotationQuaternion> > _q_v_c;
+            /// \brief translation from each camera to the vehicle
+            std::vector< boost::shared_ptr<aslam::backend::EuclideanPoint> > _t_v_c;
+            /// \brief camera geometries, used for triangulation
+            std::vector< boost::shared_ptr<aslam::cameras::CameraGeometryBase> > _geometries;
+            /// \brief estimate the intrinsics
+            bool _estimateIntrinsics;
+            /// \brief estimate the extrinsics
+            bool _estimateExtrinsics;
+            /// \brief variance of the keypoint measurements [pixel^2]
+            double _keypointSigma2;
+            /// \brief maximum reprojection error of a triangulated track [pixel]
+            double _maxTriangulationReprojectionError;
+            /// \brief minimum angle between the rays of a triangulated track [rad]
+            double _minTriangulationAngle;
+            /// \brief design variable group of the calibration parameters
+            size_t _calibrationGroupId;
+            /// \brief design variable group of the pose spline
+            size_t _posesGroupId;
+            /// \brief design variable group of the landmarks
+            size_t _landmarksGroupId;
+
             std::vector< boost::shared_ptr<DesignVariable> > _designVariables;
         };
 
@@ -1,15 +1,110 @@
 #include <aslam/calibration/vision/VisionDataAssociation.hpp>
 #include <sm/logging.hpp>
+#include <sm/assert_macros.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/exception_ptr.hpp>
+#include <sm/boost/null_deleter.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <sm/kinematics/Transformation.hpp>
+#include <aslam/backend/HomogeneousPoint.hpp>
+#include <aslam/backend/RotationExpression.hpp>
+#include <aslam/backend/EuclideanExpression.hpp>
+#include <aslam/backend/TransformationExpression.hpp>
+#include <aslam/ReprojectionError.hpp>
+#include <Eigen/Cholesky>
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <cmath>
 
 
 namespace aslam {
     namespace calibration {
+
+        namespace {
+
+            /// \brief strict ordering of keypoint identifiers
+            struct KeypointIdentifierLess {
+                bool operator()( const KeypointIdentifier & a, const KeypointIdentifier & b ) const {
+                    if(a.frameId < b.frameId) return true;
+                    if(b.frameId < a.frameId) return false;
+                    if(a.cameraIndex != b.cameraIndex) return a.cameraIndex < b.cameraIndex;
+                    return a.keypointIndex < b.keypointIndex;
+                }
+            };
+
+            /// \brief design variables waiting to enter a problem, with their group
+            struct NewDesignVariables {
+                typedef boost::shared_ptr<aslam::backend::DesignVariable> DesignVariableSP;
+
+                /// \brief queue a design variable unless the problem already has it
+                void add( const OptimizationProblem & problem, const DesignVariableSP & dv, size_t groupId ) {
+                    if(!problem.isDesignVariableInProblem(dv.get()) && lookup.insert(dv.get()).second) {
+                        designVariables.push_back( std::make_pair(dv, groupId) );
+                    }
+                }
+
+                std::vector< std::pair<DesignVariableSP, size_t> > designVariables;
+                std::set<const aslam::backend::DesignVariable*> lookup;
+            };
+
+            /// \brief root of a union-find node with path halving
+            size_t findRoot( std::vector<size_t> & parents, size_t i ) {
+                while(parents[i] != i) {
+                    parents[i] = parents[parents[i]];
+                    i = parents[i];
+                }
+                return i;
+            }
+
+            /// \brief estimated memory of a keypoint with its measurement,
+            ///        uncertainty, back projection and binary descriptor [byte]
+            const size_t keypointMemoryUsage = 256;
+
+            /// \brief run the tasks of one worker, tasks are strided over the workers
+            void runWorker( size_t worker,
+                            size_t numWorkers,
+                            size_t numTasks,
+                            const boost::function<void (size_t)> & task,
+                            boost::exception_ptr & error )
+            {
+                try {
+                    for(size_t i = worker; i < numTasks; i += numWorkers)
+                    {
+                        task(i);
+                    }
+                }
+                catch(...) {
+                    error = boost::current_exception();
+                }
+            }
+
+        }
         
 
         VisionDataAssociation::VisionDataAssociation(const sm::PropertyTree & config) :
-            _tracking( sm::PropertyTree( config, "descriptorTracking" ) ),
-            _ofovMatching( sm::PropertyTree( config, "ofovMatching" ) )
+            _trackingConfig( config, "descriptorTracking" ),
+            _ofovMatchingConfig( config, "ofovMatching" ),
+            _numThreads( config.getInt("numThreads", 0) ),
+            _disparityKeyframeThreshold( config.getDouble("disparityKeyframeThreshold", 10.0) ),
+            _numTracksThreshold( config.getInt("numTracksThreshold", 20) ),
+            _preCheckLevels( config.getInt("keyframePreCheckLevels", 3) ),
+            _preCheckRatio( config.getDouble("keyframePreCheckRatio", 0.0) ),
+            _maxKeyframes( config.getInt("maxKeyframes", 0) ),
+            _framesMemoryUsage( 0 ),
+            _peakMemoryUsage( 0 )
         {
+            std::string policy = config.getString("keyframeEvictionPolicy", "oldest");
+            if(policy == "oldest") {
+                _evictionPolicy = EVICT_OLDEST;
+            }
+            else if(policy == "leastReferenced") {
+                _evictionPolicy = EVICT_LEAST_REFERENCED;
+            }
+            else {
+                SM_THROW(std::runtime_error, "Unknown keyframe eviction policy " << policy);
+            }
+
             std::string pname = config.getString("pipelineName");
             SM_INFO_STREAM("Using the pipeline named " << pname);
             _pipeline.reset( new NCameraPipeline( sm::PropertyTree( config, pname) ) );
@@ -17,8 +112,16 @@ namespace aslam {
             _nextFrameId = MultiFrameId(0);
             _nextLandmarkId = LandmarkId(0);
 
-            // \todo create the calibration design variables.
-            
+            // The calibration design variables are created from the camera
+            // system of the first multiframe.
+            _estimateIntrinsics = config.getBool("estimateIntrinsics", true);
+            _estimateExtrinsics = config.getBool("estimateExtrinsics", true);
+            _keypointSigma2 = config.getDouble("keypointSigma2", 1.0);
+            _maxTriangulationReprojectionError = config.getDouble("maxTriangulationReprojectionError", 3.0);
+            _minTriangulationAngle = config.getDouble("minTriangulationAngle", 0.02);
+            _calibrationGroupId = config.getInt("calibrationGroupId", 0);
+            _posesGroupId = config.getInt("posesGroupId", 1);
+            _landmarksGroupId = config.getInt("landmarksGroupId", 2);
             
         }
 
@@ -34,27 +137,32 @@ namespace aslam {
                                              int cameraIndex,
                                              const cv::Mat & image)
         {
+            if(_preCheckRatio > 0.0) {
+                updateThumbnail(cameraIndex, image);
+            }
             boost::shared_ptr<MultiFrame> frame = _pipeline->addImage(stamp,cameraIndex,image);
 
+            if(frame && _geometries.empty()) {
+                createDesignVariables(*frame->getCameraSystem(), _estimateIntrinsics, _estimateExtrinsics);
+            }
+
             std::vector< KeypointIdentifierMatch > f2fMatches;
-            if(frame && _previousFrame)
+            // Frames that clearly moved too little are dropped before the tracking.
+            if(frame && _previousFrame && isKeyframeCandidate())
             {
                                 
                 // For each camera, run a disparity-based tracking with the last camera.
-                for(size_t i = 0; i < frame->numCameras(); ++i)
+                // The cameras are tracked in parallel and merged in camera order.
+                initMatchingProblems(frame->numCameras());
+                std::vector< std::vector< KeypointIdentifierMatch > > cameraMatches(frame->numCameras());
+                runTasks(frame->numCameras(),
+                         boost::bind(&VisionDataAssociation::trackCamera, this, _1,
+                                     boost::cref(_previousFrame), boost::cref(frame),
+                                     boost::ref(cameraMatches)));
+                for(size_t i = 0; i < cameraMatches.size(); ++i)
                 {
-                    _tracking.setFrames(_previousFrame->id(),
-                                        i,
-                                        _previousFrame->getFrame(i).get(), 
-                                        _nextFrameId,
-                                        i,
-                                        frame->getFrame(i).get());
-
-                    _matcher.match(_tracking);
-                    
-                    // Retrieve the matches
-                    _tracking.insertMatches(f2fMatches);
-                    SM_INFO_STREAM("Camera " << i << " had " << _tracking.getMatches().size() << " matches");
+                    SM_INFO_STREAM("Camera " << i << " had " << cameraMatches[i].size() << " matches");
+                    f2fMatches.insert(f2fMatches.end(), cameraMatches[i].begin(), cameraMatches[i].end());
                 }
                 SM_INFO_STREAM("Total matches: " << f2fMatches.size());
                 if((int)f2fMatches.size() > _numTracksThreshold)
@@ -81,11 +189,13 @@ namespace aslam {
                         SM_INFO_STREAM("Meadian disparity threshold passed! Saving the frame");
                         frame->setId(_nextFrameId);
                         _nextFrameId++;
-                        _frames[frame->id()] = frame;
                         _previousFrame = frame;
+                        _keyframeThumbnails = _thumbnails;
                         _matches.insert(_matches.end(), f2fMatches.begin(), f2fMatches.end());
                         
                         doOfovMatching( frame );
+
+                        storeKeyframe( frame );
                         
                     }
                     
@@ -94,16 +204,82 @@ namespace aslam {
                 {
                     // This is a failure recovery. We weren't able to track
                     // enough features so throw out the previous frame
-                    // and start again.
+                    // and start again. The next matches refer to this frame
+                    // so it is kept.
+                    frame->setId(_nextFrameId);
+                    _nextFrameId++;
                     _previousFrame = frame;
+                    _keyframeThumbnails = _thumbnails;
+                    storeKeyframe( frame );
                 }
             }
             
             // This happens only once after a reset...
             if( frame && !_previousFrame ) {
+                frame->setId(_nextFrameId);
+                _nextFrameId++;
                 _previousFrame = frame;
+                _keyframeThumbnails = _thumbnails;
+                storeKeyframe( frame );
+            }
+
+        }
+            
+        void VisionDataAssociation::updateThumbnail( int cameraIndex, const cv::Mat & image )
+        {
+            SM_ASSERT_GE( std::runtime_error, cameraIndex, 0, "Negative camera index");
+            if((size_t)cameraIndex >= _thumbnails.size()) {
+                _thumbnails.resize(cameraIndex + 1);
             }
 
+            // A new matrix is allocated each time, the keyframe thumbnails share
+            // the previous ones.
+            cv::Mat thumbnail;
+            if(image.channels() > 1) {
+                cv::cvtColor(image, thumbnail, CV_BGR2GRAY);
+            }
+            else {
+                thumbnail = image;
+            }
+            for(int l = 0; l < _preCheckLevels; ++l) {
+                cv::Mat level;
+                cv::pyrDown(thumbnail, level);
+                thumbnail = level;
+            }
+            cv::Mat floatThumbnail;
+            thumbnail.convertTo(floatThumbnail, CV_64F);
+            _thumbnails[cameraIndex] = floatThumbnail;
+        }
+
+        bool VisionDataAssociation::isKeyframeCandidate() const
+        {
+            if(_preCheckRatio <= 0.0) {
+                return true;
+            }
+
+            // Phase correlation of the downsampled images gives the dominant
+            // image shift of each camera. It underestimates the median disparity
+            // of rotations about the optical axis and of forward motions, hence
+            // the ratio on the threshold.
+            double maxShift = 0.0;
+            for(size_t i = 0; i < _thumbnails.size(); ++i) {
+                if(i >= _keyframeThumbnails.size() ||
+                   _thumbnails[i].empty() ||
+                   _keyframeThumbnails[i].empty() ||
+                   _thumbnails[i].size() != _keyframeThumbnails[i].size()) {
+                    return true;
+                }
+                cv::Mat window;
+                cv::createHanningWindow(window, _thumbnails[i].size(), CV_64F);
+                cv::Point2d shift = cv::phaseCorrelate(_keyframeThumbnails[i], _thumbnails[i], window);
+                maxShift = std::max(maxShift, std::sqrt(shift.x * shift.x + shift.y * shift.y) * (1 << _preCheckLevels));
+            }
+
+            if(maxShift < _preCheckRatio * _disparityKeyframeThreshold) {
+                SM_INFO_STREAM("Pre-check shift " << maxShift << " below threshold. Skipping the tracking");
+                return false;
+            }
+            return true;
         }
             
         double VisionDataAssociation::computeDisparity( const boost::shared_ptr<MultiFrame> & F0,
@@ -123,8 +299,12 @@ namespace aslam {
             _frames.clear();
             // std::vector< KeypointIdentifierMatch > _matches;
             _matches.clear();
+            _frameMemoryUsage.clear();
+            _framesMemoryUsage = 0;
             
             _previousFrame.reset();
+            _keyframeThumbnails.clear();
+            _landmarks.clear();
 
         }
 
@@ -133,35 +313,314 @@ namespace aslam {
         ///        using the bspline pose representation passed in.
         void VisionDataAssociation::addToProblem( aslam::splines::BSplinePoseDesignVariable & T_w_vk, OptimizationProblemSP problem ) {
 
-            // This is where the magic happens.
-            
-            // \todo: initialize a list of landmark design variables.
-            
+            // Link the pairwise matches into tracks and triangulate them all at once.
+            std::vector< std::vector< KeypointIdentifier > > tracks;
+            buildTracks(tracks);
+            Eigen::Matrix4Xd points;
+            std::vector<bool> valid;
+            triangulateTracks(T_w_vk, tracks, points, valid);
+
+            // Nothing enters the problem before the whole batch is validated,
+            // the new design variables are collected with their group.
+            NewDesignVariables newDesignVariables;
+
+            // The calibration design variables go in the calibration group.
+            for(size_t i = 0; i < _designVariables.size(); ++i) {
+                newDesignVariables.add(*problem, _designVariables[i], _calibrationGroupId);
+            }
+
+            // Expressions of the camera to vehicle transformations.
+            std::vector< aslam::backend::TransformationExpression > T_v_c_e;
+            T_v_c_e.reserve(_q_v_c.size());
+            for(size_t i = 0; i < _q_v_c.size(); ++i) {
+                T_v_c_e.push_back( aslam::backend::TransformationExpression(
+                                       aslam::backend::RotationExpression(_q_v_c[i]),
+                                       aslam::backend::EuclideanExpression(_t_v_c[i]) ) );
+            }
+
+            // One pose expression per keyframe, shared by its cameras.
+            std::map< MultiFrameId, aslam::backend::TransformationExpression > T_w_v_e;
+
+            const Eigen::Matrix2d invR = Eigen::Matrix2d::Identity() / _keypointSigma2;
+            aslam::calibration::OptimizationProblem::ErrorTermsSP errorTerms;
+            std::vector< std::pair<KeypointBase*, LandmarkId> > newKeypoints;
+            std::map< LandmarkId, boost::shared_ptr<aslam::backend::HomogeneousPoint> > newLandmarks;
+            LandmarkId nextLandmarkId = _nextLandmarkId;
+            for(size_t k = 0; k < tracks.size(); ++k) {
+
+                // A track keeps the landmark it got in a previous call since the
+                // last reset(), only its new keypoints are added.
+                LandmarkId landmarkId;
+                for(size_t o = 0; o < tracks[k].size() && !landmarkId.isSet(); ++o) {
+                    const KeypointIdentifier & kid = tracks[k][o];
+                    const LandmarkId & id = _frames[kid.frameId]->keypoint(kid).landmarkId();
+                    if(id.isSet() && _landmarks.count(id)) {
+                        landmarkId = id;
+                    }
+                }
 
-            // For each match..
+                boost::shared_ptr<aslam::backend::HomogeneousPoint> landmark;
+                if(landmarkId.isSet()) {
+                    landmark = _landmarks[landmarkId];
+                }
+                else if(valid[k]) {
+                    landmarkId = nextLandmarkId++;
+                    landmark.reset( new aslam::backend::HomogeneousPoint( points.col(k) ) );
+                    landmark->setActive(true);
+                    newLandmarks[landmarkId] = landmark;
+                }
+                else {
+                    continue;
+                }
+                newDesignVariables.add(*problem, landmark, _landmarksGroupId);
+                aslam::backend::HomogeneousExpression p_w = landmark->toExpression();
+
+                for(size_t o = 0; o < tracks[k].size(); ++o) {
+                    const KeypointIdentifier & kid = tracks[k][o];
+                    boost::shared_ptr<MultiFrame> & mf = _frames[kid.frameId];
+                    KeypointBase & keypoint = mf->keypoint(kid);
+                    if(keypoint.landmarkId().isSet() && _landmarks.count(keypoint.landmarkId())) {
+                        continue;
+                    }
+                    newKeypoints.push_back( std::make_pair(&keypoint, landmarkId) );
+
+                    if(T_w_v_e.find(kid.frameId) == T_w_v_e.end()) {
+                        aslam::backend::TransformationExpression T = T_w_vk.transformation(mf->time().toSec());
+                        DesignVariable::set_t poseDesignVariables;
+                        T.getDesignVariables(poseDesignVariables);
+                        for(DesignVariable::set_t::iterator it = poseDesignVariables.begin();
+                            it != poseDesignVariables.end(); ++it) {
+                            newDesignVariables.add( *problem, boost::shared_ptr<DesignVariable>(*it, sm::null_deleter()),
+                                                    _posesGroupId );
+                        }
+                        T_w_v_e.insert( std::make_pair(kid.frameId, T) );
+                    }
+
+                    aslam::backend::TransformationExpression T_c_w =
+                        (T_w_v_e.find(kid.frameId)->second * T_v_c_e[kid.cameraIndex]).inverse();
+                    errorTerms.push_back( boost::shared_ptr<aslam::ReprojectionError>(
+                                              new aslam::ReprojectionError( keypoint.vsMeasurement(),
+                                                                            invR,
+                                                                            T_c_w * p_w,
+                                                                            _intrinsics[kid.cameraIndex].get() ) ) );
+                }
+            }
+
+            // Every error term must only refer to design variables of the problem
+            // or of this batch.
+            for(size_t i = 0; i < errorTerms.size(); ++i) {
+                for(size_t j = 0; j < errorTerms[i]->numDesignVariables(); ++j) {
+                    const DesignVariable * dv = errorTerms[i]->designVariable(j);
+                    SM_ASSERT_TRUE( std::runtime_error,
+                                    problem->isDesignVariableInProblem(dv) || newDesignVariables.lookup.count(dv),
+                                    "Reprojection error with a design variable outside the problem" );
+                }
+            }
+
+            // The design variables and then the reprojection errors enter the problem.
+            for(size_t i = 0; i < newDesignVariables.designVariables.size(); ++i) {
+                problem->addDesignVariable(newDesignVariables.designVariables[i].first,
+                                           newDesignVariables.designVariables[i].second);
+            }
+            problem->addErrorTerms(errorTerms);
+            for(size_t i = 0; i < newKeypoints.size(); ++i) {
+                newKeypoints[i].first->setLandmarkId(newKeypoints[i].second);
+            }
+            _landmarks.insert(newLandmarks.begin(), newLandmarks.end());
+            _nextLandmarkId = nextLandmarkId;
+            SM_INFO_STREAM("Added " << newLandmarks.size() << " landmarks out of " << tracks.size()
+                           << " tracks and " << errorTerms.size() << " reprojection errors");
+
+        }
+
+        void VisionDataAssociation::createDesignVariables( NCameraSystem & system, bool doIntrinsics, bool doExtrinsics ) {
+
+            _designVariables.clear();
+            _intrinsics.clear();
+            _q_v_c.clear();
+            _t_v_c.clear();
+            _geometries.clear();
+            for(size_t i = 0; i < system.numCameras(); ++i) {
+                boost::shared_ptr<aslam::cameras::CameraGeometryBase> geometry = system.cameraGeometryBase(i);
+                _geometries.push_back(geometry);
+
+                // Intrinsics: projection and distortion.
+                _intrinsics.push_back( boost::shared_ptr<aslam::CameraGeometryDesignVariableContainer>(
+                                           new aslam::CameraGeometryDesignVariableContainer( geometry, doIntrinsics, doIntrinsics, false ) ) );
+                DesignVariable::set_t intrinsics;
+                _intrinsics.back()->getDesignVariables(intrinsics);
+                for(DesignVariable::set_t::iterator it = intrinsics.begin(); it != intrinsics.end(); ++it) {
+                    _designVariables.push_back( boost::shared_ptr<DesignVariable>(*it, sm::null_deleter()) );
+                }
+
+                // Extrinsics: transformation from the camera to the vehicle.
+                const sm::kinematics::Transformation T_v_c = system.T_v_c(i);
+                _q_v_c.push_back( boost::shared_ptr<aslam::backend::RotationQuaternion>(
+                                      new aslam::backend::RotationQuaternion( T_v_c.q() ) ) );
+                _q_v_c.back()->setActive(doExtrinsics);
+                _t_v_c.push_back( boost::shared_ptr<aslam::backend::EuclideanPoint>(
+                                      new aslam::backend::EuclideanPoint( T_v_c.t() ) ) );
+                _t_v_c.back()->setActive(doExtrinsics);
+                _designVariables.push_back(_q_v_c.back());
+                _designVariables.push_back(_t_v_c.back());
+            }
+            SM_INFO_STREAM("Created " << _designVariables.size() << " calibration design variables for "
+                           << system.numCameras() << " cameras");
+
+        }
+
+        sm::kinematics::Transformation VisionDataAssociation::T_v_c( size_t i ) const {
+            return sm::kinematics::Transformation( _q_v_c[i]->getQuaternion(), _t_v_c[i]->toEuclidean() );
+        }
+
+        void VisionDataAssociation::buildTracks( std::vector< std::vector< KeypointIdentifier > > & tracks ) const {
+
+            // Number the keypoints of the stored keyframes in order of appearance.
+            typedef std::map< KeypointIdentifier, size_t, KeypointIdentifierLess > KeypointIndex;
+            KeypointIndex keypointIndex;
+            std::vector< KeypointIdentifier > keypoints;
+            std::vector< std::pair<size_t, size_t> > edges;
+            edges.reserve(_matches.size());
             for(size_t i = 0; i < _matches.size(); ++i) {
-                //KeypointIdentifierMatch & match = _matches[i];
-                
-                // Check the MF0 keypoint for a landmark id
-                // if it does not have one
-                //    triangulate the point
-                //    Check the reprojection error for bad triangulation
-                //    if the triangulation was good
-                //       Create a new landmark
-                //       Add the new landmark to the problem
-                //       Set the landmark id in MF 0
-                //       Create a reprojection error for MF0
-                //       Add the new RE it to the problem
-                // endif
-                
-                // if the last step was successful
-                //    Set the landmark id in MF 1
-                //    Create a reprojection error for MF1
-                //    Add it to the problem
-                // endif
-                
-                
+                const KeypointIdentifierMatch & match = _matches[i];
+                if(!_frames.count(match.index[0].frameId) || !_frames.count(match.index[1].frameId)) {
+                    continue;
+                }
+                size_t nodes[2];
+                for(int j = 0; j < 2; ++j) {
+                    std::pair<KeypointIndex::iterator, bool> inserted =
+                        keypointIndex.insert( std::make_pair(match.index[j], keypoints.size()) );
+                    if(inserted.second) {
+                        keypoints.push_back(match.index[j]);
+                    }
+                    nodes[j] = inserted.first->second;
+                }
+                edges.push_back( std::make_pair(nodes[0], nodes[1]) );
+            }
+
+            // Union-find by size over the matches.
+            std::vector<size_t> parents(keypoints.size());
+            std::vector<size_t> sizes(keypoints.size(), 1);
+            for(size_t i = 0; i < parents.size(); ++i) {
+                parents[i] = i;
+            }
+            for(size_t i = 0; i < edges.size(); ++i) {
+                size_t a = findRoot(parents, edges[i].first);
+                size_t b = findRoot(parents, edges[i].second);
+                if(a == b) {
+                    continue;
+                }
+                if(sizes[a] < sizes[b]) {
+                    std::swap(a, b);
+                }
+                parents[b] = a;
+                sizes[a] += sizes[b];
+            }
+
+            // Tracks are numbered by their first keypoint. A track seeing two
+            // keypoints in the same image is inconsistent and dropped.
+            std::vector<size_t> trackIndex(keypoints.size(), keypoints.size());
+            tracks.clear();
+            for(size_t i = 0; i < keypoints.size(); ++i) {
+                const size_t root = findRoot(parents, i);
+                if(trackIndex[root] == keypoints.size()) {
+                    trackIndex[root] = tracks.size();
+                    tracks.push_back( std::vector< KeypointIdentifier >() );
+                }
+                tracks[trackIndex[root]].push_back(keypoints[i]);
+            }
+            size_t numKept = 0;
+            for(size_t k = 0; k < tracks.size(); ++k) {
+                bool consistent = true;
+                for(size_t i = 0; i < tracks[k].size() && consistent; ++i) {
+                    for(size_t j = i + 1; j < tracks[k].size() && consistent; ++j) {
+                        consistent = !(tracks[k][i].frameId == tracks[k][j].frameId &&
+                                       tracks[k][i].cameraIndex == tracks[k][j].cameraIndex);
+                    }
+                }
+                if(consistent) {
+                    tracks[numKept].swap(tracks[k]);
+                    ++numKept;
+                }
             }
+            SM_INFO_STREAM("Linked " << _matches.size() << " matches into " << numKept << " tracks ("
+                           << tracks.size() - numKept << " inconsistent)");
+            tracks.resize(numKept);
+
+        }
+
+        void VisionDataAssociation::triangulateTracks( aslam::splines::BSplinePoseDesignVariable & T_w_vk,
+                                                       const std::vector< std::vector< KeypointIdentifier > > & tracks,
+                                                       Eigen::Matrix4Xd & points,
+                                                       std::vector<bool> & valid ) {
+
+            // Camera poses in the world frame, evaluated once per image.
+            typedef std::map< std::pair<MultiFrameId, size_t>, Eigen::Matrix4d > CameraPoses;
+            CameraPoses T_w_c;
+            std::vector<Eigen::Matrix4d> T_v_cs(_q_v_c.size());
+            for(size_t i = 0; i < _q_v_c.size(); ++i) {
+                T_v_cs[i] = T_v_c(i).T();
+            }
+
+            // Stack the normal equations of the midpoint method, sum_i (I - d_i d_i^T) (p - c_i) = 0,
+            // of all the tracks side by side.
+            Eigen::Matrix3Xd A = Eigen::Matrix3Xd::Zero(3, 3 * tracks.size());
+            Eigen::Matrix3Xd b = Eigen::Matrix3Xd::Zero(3, tracks.size());
+            valid.assign(tracks.size(), true);
+            Eigen::VectorXd bearing;
+            for(size_t k = 0; k < tracks.size(); ++k) {
+                for(size_t o = 0; o < tracks[k].size(); ++o) {
+                    const KeypointIdentifier & kid = tracks[k][o];
+                    const boost::shared_ptr<MultiFrame> & mf = _frames.find(kid.frameId)->second;
+                    const std::pair<MultiFrameId, size_t> image(kid.frameId, kid.cameraIndex);
+                    CameraPoses::iterator pose = T_w_c.find(image);
+                    if(pose == T_w_c.end()) {
+                        pose = T_w_c.insert( std::make_pair(image,
+                                                            Eigen::Matrix4d( T_w_vk.spline().transformation(mf->time().toSec()) *
+                                                                             T_v_cs[kid.cameraIndex] ) ) ).first;
+                    }
+                    if(!_geometries[kid.cameraIndex]->vsKeypointToEuclidean(mf->keypoint(kid).vsMeasurement(), bearing)) {
+                        valid[k] = false;
+                        break;
+                    }
+                    const Eigen::Vector3d d = (pose->second.topLeftCorner<3,3>() * bearing.head<3>()).normalized();
+                    const Eigen::Matrix3d P = Eigen::Matrix3d::Identity() - d * d.transpose();
+                    A.block<3,3>(0, 3 * k) += P;
+                    b.col(k) += P * pose->second.topRightCorner<3,1>();
+                }
+            }
+
+            // Solve all the 3x3 systems in one pass, then check parallax, depth and reprojection.
+            const double minEigenvalue = 1.0 - std::cos(_minTriangulationAngle);
+            points.resize(4, tracks.size());
+            Eigen::VectorXd keypoint;
+            size_t numValid = 0;
+            for(size_t k = 0; k < tracks.size(); ++k) {
+                if(!valid[k]) {
+                    continue;
+                }
+                const Eigen::Matrix3d Ak = A.block<3,3>(0, 3 * k);
+                Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigenSolver(Ak, Eigen::EigenvaluesOnly);
+                if(eigenSolver.eigenvalues()(0) < minEigenvalue) {
+                    valid[k] = false;
+                    continue;
+                }
+                points.col(k).head<3>() = Ak.ldlt().solve(b.col(k));
+                points(3, k) = 1.0;
+                for(size_t o = 0; o < tracks[k].size() && valid[k]; ++o) {
+                    const KeypointIdentifier & kid = tracks[k][o];
+                    const Eigen::Matrix4d & T = T_w_c.find( std::make_pair(kid.frameId, kid.cameraIndex) )->second;
+                    const Eigen::Vector4d p_c = T.inverse() * points.col(k);
+                    valid[k] = p_c(2) > 0.0 &&
+                        _geometries[kid.cameraIndex]->vsHomogeneousToKeypoint(p_c, keypoint) &&
+                        (keypoint - _frames.find(kid.frameId)->second->keypoint(kid).vsMeasurement()).norm()
+                        <= _maxTriangulationReprojectionError;
+                }
+                if(valid[k]) {
+                    ++numValid;
+                }
+            }
+            SM_INFO_STREAM("Triangulated " << numValid << " out of " << tracks.size() << " tracks");
 
         }
         
@@ -177,22 +636,178 @@ namespace aslam {
         }
         
 
+        size_t VisionDataAssociation::numKeyframes() const {
+            return _frames.size();
+        }
+
+        size_t VisionDataAssociation::numMatches() const {
+            return _matches.size();
+        }
+
+        size_t VisionDataAssociation::getMemoryUsage() const {
+            return _framesMemoryUsage + _matches.size() * sizeof(KeypointIdentifierMatch);
+        }
+
+        size_t VisionDataAssociation::getPeakMemoryUsage() const {
+            return _peakMemoryUsage;
+        }
+
+        size_t VisionDataAssociation::computeMemoryUsage( const MultiFrame & mf ) const {
+            size_t memoryUsage = 0;
+            for(size_t i = 0; i < mf.numFrames(); ++i) {
+                const FrameBase * frame = mf.getFrame(i).get();
+                const cv::Mat & image = frame->image();
+                memoryUsage += image.total() * image.elemSize();
+                memoryUsage += frame->numKeypoints() * keypointMemoryUsage;
+            }
+            return memoryUsage;
+        }
+
+        void VisionDataAssociation::updateMemoryUsage() {
+            _peakMemoryUsage = std::max(_peakMemoryUsage, getMemoryUsage());
+        }
+
+        void VisionDataAssociation::storeKeyframe( const boost::shared_ptr<MultiFrame> & mf ) {
+
+            _frames[mf->id()] = mf;
+            const size_t memoryUsage = computeMemoryUsage(*mf);
+            _frameMemoryUsage[mf->id()] = memoryUsage;
+            _framesMemoryUsage += memoryUsage;
+            updateMemoryUsage();
+
+            if(_maxKeyframes == 0 || _frames.size() <= _maxKeyframes) {
+                return;
+            }
+
+            // Count the matches referencing each keyframe.
+            std::map< MultiFrameId, size_t > references;
+            if(_evictionPolicy == EVICT_LEAST_REFERENCED) {
+                for(size_t i = 0; i < _matches.size(); ++i) {
+                    references[_matches[i].index[0].frameId]++;
+                    if(_matches[i].index[1].frameId != _matches[i].index[0].frameId) {
+                        references[_matches[i].index[1].frameId]++;
+                    }
+                }
+            }
+
+            // The newest keyframe is tracked against the next frame, it is
+            // never evicted. Ties go to the oldest keyframe.
+            std::set<MultiFrameId> evicted;
+            while(_frames.size() > _maxKeyframes) {
+                std::map< MultiFrameId, boost::shared_ptr<MultiFrame> >::iterator victim = _frames.begin();
+                if(_evictionPolicy == EVICT_LEAST_REFERENCED) {
+                    for(std::map< MultiFrameId, boost::shared_ptr<MultiFrame> >::iterator it = _frames.begin();
+                        it != _frames.end(); ++it) {
+                        if(it->first != mf->id() && references[it->first] < references[victim->first]) {
+                            victim = it;
+                        }
+                    }
+                }
+                SM_INFO_STREAM("Evicting keyframe " << victim->first << " referenced by "
+                               << references[victim->first] << " matches");
+                _framesMemoryUsage -= _frameMemoryUsage[victim->first];
+                _frameMemoryUsage.erase(victim->first);
+                evicted.insert(victim->first);
+                _frames.erase(victim);
+            }
+            compactMatches(evicted);
+
+        }
+
+        void VisionDataAssociation::compactMatches( const std::set<MultiFrameId> & evicted ) {
+
+            // Stable in-place compaction, the surviving matches keep their order.
+            size_t numKept = 0;
+            for(size_t i = 0; i < _matches.size(); ++i) {
+                if(evicted.count(_matches[i].index[0].frameId) ||
+                   evicted.count(_matches[i].index[1].frameId)) {
+                    continue;
+                }
+                if(numKept != i) {
+                    _matches[numKept] = _matches[i];
+                }
+                ++numKept;
+            }
+            _matches.resize(numKept);
+
+        }
+
         void VisionDataAssociation::doOfovMatching( boost::shared_ptr<MultiFrame> mf ) {
 
-            for(size_t i = 0; i < mf->numFrames(); ++i) {
-                for( size_t j = i + 1; j < mf->numFrames(); ++j ) {
+            // The camera pairs are matched in parallel and merged in pair order.
+            initMatchingProblems(mf->numFrames());
+            std::vector< std::vector< KeypointIdentifierMatch > > pairMatches(_cameraPairs.size());
+            runTasks(_cameraPairs.size(),
+                     boost::bind(&VisionDataAssociation::matchCameraPair, this, _1,
+                                 boost::cref(mf), boost::ref(pairMatches)));
+            for(size_t k = 0; k < pairMatches.size(); ++k) {
+                _matches.insert(_matches.end(), pairMatches[k].begin(), pairMatches[k].end());
+            }
+
+        }
+
+        void VisionDataAssociation::initMatchingProblems( size_t numCameras ) {
+
+            // Each task owns its matching problem and matcher, the frames are only read.
+            while(_tracking.size() < numCameras) {
+                _tracking.push_back( boost::shared_ptr<aslam::DescriptorTrackingAlgorithm>(
+                                         new aslam::DescriptorTrackingAlgorithm( _trackingConfig ) ) );
+                _trackingMatchers.push_back( boost::shared_ptr<aslam::DenseMatcher>( new aslam::DenseMatcher() ) );
+            }
+
+            if(_cameraPairs.size() != numCameras * (numCameras - 1) / 2) {
+                _cameraPairs.clear();
+                for(size_t i = 0; i < numCameras; ++i) {
+                    for( size_t j = i + 1; j < numCameras; ++j ) {
+                        _cameraPairs.push_back( std::make_pair(i, j) );
+                    }
+                }
+            }
+            while(_ofovMatching.size() < _cameraPairs.size()) {
+                _ofovMatching.push_back( boost::shared_ptr<aslam::EpipolarMatchingAlgorithm>(
+                                             new aslam::EpipolarMatchingAlgorithm( _ofovMatchingConfig ) ) );
+                _ofovMatchers.push_back( boost::shared_ptr<aslam::DenseMatcher>( new aslam::DenseMatcher() ) );
+            }
+
+        }
+
+        void VisionDataAssociation::trackCamera( size_t i,
+                                                 const boost::shared_ptr<MultiFrame> & F0,
+                                                 const boost::shared_ptr<MultiFrame> & F1,
+                                                 std::vector< std::vector< KeypointIdentifierMatch > > & matches ) {
+
+            _tracking[i]->setFrames(F0->id(),
+                                    i,
+                                    F0->getFrame(i).get(), 
+                                    _nextFrameId,
+                                    i,
+                                    F1->getFrame(i).get());
+
+            _trackingMatchers[i]->match(*_tracking[i]);
                     
-                    // void setMatchData(MultiFrameId fidA,
-                    //                   int cameraIndexA,
-                    //                   FrameBase * cameraA,
-                    //                   MultiFrameId fidB,
-                    //                   int cameraIndexB,
-                    //                   FrameBase * cameraB,
-                    //                   const cameras::ImageMask * overlapAB,
-                    //                   const cameras::ImageMask * overlapBA,
-                    //                   const sm::kinematics::Transformation & T_A_B);
-
-                    _ofovMatching.setMatchData(mf->id(),
+            // Retrieve the matches
+            _tracking[i]->insertMatches(matches[i]);
+
+        }
+
+        void VisionDataAssociation::matchCameraPair( size_t k,
+                                                     const boost::shared_ptr<MultiFrame> & mf,
+                                                     std::vector< std::vector< KeypointIdentifierMatch > > & matches ) {
+
+            const size_t i = _cameraPairs[k].first;
+            const size_t j = _cameraPairs[k].second;
+
+            // void setMatchData(MultiFrameId fidA,
+            //                   int cameraIndexA,
+            //                   FrameBase * cameraA,
+            //                   MultiFrameId fidB,
+            //                   int cameraIndexB,
+            //                   FrameBase * cameraB,
+            //                   const cameras::ImageMask * overlapAB,
+            //                   const cameras::ImageMask * overlapBA,
+            //                   const sm::kinematics::Transformation & T_A_B);
+
+            _ofovMatching[k]->setMatchData(mf->id(),
                                            i,
                                            mf->getFrame(i).get(), 
                                            mf->id(),
@@ -201,13 +816,34 @@ namespace aslam {
                                            NULL,
                                            NULL,
                                            mf->T_ci_cj(i,j)
-                        );
+                );
                     
-                    _matcher.match(_ofovMatching);
-                    std::vector< KeypointIdentifierMatch > ofovMatches;
-                    _ofovMatching.swapMatches(ofovMatches);
-                    _matches.insert(_matches.end(), ofovMatches.begin(), ofovMatches.end());                    
+            _ofovMatchers[k]->match(*_ofovMatching[k]);
+            _ofovMatching[k]->swapMatches(matches[k]);
+
+        }
 
+        void VisionDataAssociation::runTasks( size_t numTasks, const boost::function<void (size_t)> & task ) {
+
+            size_t numThreads = _numThreads ? _numThreads : std::max(boost::thread::hardware_concurrency(), 1u);
+            numThreads = std::min(numThreads, numTasks);
+            if(numThreads <= 1) {
+                for(size_t i = 0; i < numTasks; ++i) {
+                    task(i);
+                }
+                return;
+            }
+
+            std::vector< boost::exception_ptr > errors(numThreads);
+            boost::thread_group workers;
+            for(size_t t = 0; t < numThreads; ++t) {
+                workers.create_thread( boost::bind(&runWorker, t, numThreads, numTasks,
+                                                   boost::cref(task), boost::ref(errors[t])) );
+            }
+            workers.join_all();
+            for(size_t t = 0; t < errors.size(); ++t) {
+                if(errors[t]) {
+                    boost::rethrow_exception(errors[t]);
                 }
             }
 